@@ -0,0 +1,445 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "cell.h"
+#include "analyzer.h"
+#include "csr.h"
+#include "bsr.h"
+#include "dia.h"
+
+typedef struct Sparse_Matrix_Plan{
+    Sparse_Matrix *matrix;
+    unsigned long version;
+    int analyzed;
+    Sparse_Matrix_Stats stats;
+    Csr_Matrix *csr;
+    Csr_Matrix *symmetric;
+    Bsr_Matrix *bsr;
+    Dia_Matrix *dia;
+} Sparse_Matrix_Plan;
+
+/**
+ * @brief This function computes the structure statistics of a matrix: the number of non-null values, their distribution per row, the bandwidth, the symmetry, the occupancy of the diagonals and the fill of the BSR_BLOCK_SIZE blocks. Everything is computed in a unique pass over the row lists; the column list of row i is checked against row i to find the symmetry.
+ *
+ * @brief Time Complexity: O(n + r + c), because each non-null value is visited at most twice and the workspaces have the size of the rows and columns
+ *
+ * @param matrix
+ * The matrix that will be analyzed
+ * @return Sparse_Matrix_Stats
+ * The statistics of the matrix
+ */
+Sparse_Matrix_Stats sparse_matrix_analyze(Sparse_Matrix *matrix){
+    Sparse_Matrix_Stats stats = {0};
+    Cell *current;
+
+    stats.numberRows = sparse_matrix_number_rows(matrix);
+    stats.numberColumns = sparse_matrix_number_columns(matrix);
+    stats.minRowNonNull = -1;
+
+    int square = stats.numberRows == stats.numberColumns;
+    int numberBlockColumns = (stats.numberColumns + BSR_BLOCK_SIZE - 1) / BSR_BLOCK_SIZE;
+
+    char *occupied = (char *)calloc(stats.numberRows + stats.numberColumns - 1, sizeof(char));
+    int *stamp = (int *)malloc(stats.numberColumns * sizeof(int));
+    matrix_value_type *scattered = (matrix_value_type *)malloc(stats.numberColumns * sizeof(matrix_value_type));
+    int *blockStamp = (int *)malloc(numberBlockColumns * sizeof(int));
+    double squares = 0;
+
+    for(int j = 0; j < stats.numberColumns; j++){
+        stamp[j] = -1;
+    }
+
+    for(int j = 0; j < numberBlockColumns; j++){
+        blockStamp[j] = -1;
+    }
+
+    stats.symmetric = square;
+    stats.structurallySymmetric = square;
+
+    for(int i = 0; i < stats.numberRows; i++){
+        int count = 0;
+        int blockRow = i / BSR_BLOCK_SIZE;
+        current = _sparse_matrix_row_head(matrix, i);
+
+        while(current){
+            int column = current->positionColumn;
+            int position = column - i + stats.numberRows - 1;
+
+            if(!occupied[position]){
+                occupied[position] = 1;
+                stats.numberDiagonals++;
+            }
+
+            if(column == i){
+                stats.diagonalNonNull++;
+            }
+
+            if(i - column > stats.lowerBandwidth){
+                stats.lowerBandwidth = i - column;
+            }
+
+            if(column - i > stats.upperBandwidth){
+                stats.upperBandwidth = column - i;
+            }
+
+            if(blockStamp[column / BSR_BLOCK_SIZE] != blockRow){
+                blockStamp[column / BSR_BLOCK_SIZE] = blockRow;
+                stats.numberBlocks++;
+            }
+
+            stamp[column] = i;
+            scattered[column] = current->value;
+            count++;
+            current = current->nextRow;
+        }
+
+        //Row i must be the mirror of column i: same positions (structure) and same values
+        if(stats.structurallySymmetric){
+            int mirrored = 0;
+            Sparse_Matrix_Cursor cursor = sparse_matrix_column_cursor(matrix, i);
+
+            while(sparse_matrix_cursor_next(&cursor)){
+                if(stamp[cursor.row] != i){
+                    stats.structurallySymmetric = 0;
+                    stats.symmetric = 0;
+                    break;
+                }
+
+                if(scattered[cursor.row] != cursor.value){
+                    stats.symmetric = 0;
+                }
+
+                mirrored++;
+            }
+
+            if(mirrored != count){
+                stats.structurallySymmetric = 0;
+                stats.symmetric = 0;
+            }
+        }
+
+        if(count == 0){
+            stats.emptyRows++;
+        }
+
+        if(stats.minRowNonNull == -1 || count < stats.minRowNonNull){
+            stats.minRowNonNull = count;
+        }
+
+        if(count > stats.maxRowNonNull){
+            stats.maxRowNonNull = count;
+        }
+
+        stats.numberNonNull += count;
+        squares += (double)count * count;
+    }
+
+    stats.meanRowNonNull = (double)stats.numberNonNull / stats.numberRows;
+    stats.deviationRowNonNull = sqrt(fabs(squares / stats.numberRows - stats.meanRowNonNull * stats.meanRowNonNull));
+
+    if(stats.numberDiagonals > 0){
+        stats.diagonalFill = (double)stats.numberNonNull / ((double)stats.numberDiagonals * stats.numberRows);
+    }
+
+    if(stats.numberBlocks > 0){
+        stats.blockFill = (double)stats.numberNonNull / ((double)stats.numberBlocks * BSR_BLOCK_SIZE * BSR_BLOCK_SIZE);
+    }
+
+    free(occupied);
+    free(stamp);
+    free(scattered);
+    free(blockStamp);
+
+    return stats;
+}
+
+/**
+ * @brief This function chooses the storage format that computes an operation faster for a matrix with the statistics given. The linked format is the only one that accepts updates; the diagonal format is chosen when the band is dense enough, then the symmetric format, then the block format when the blocks are well filled, and the compressed row format otherwise.
+ *
+ * @brief Time Complexity: O(1), because only the statistics are evaluated
+ *
+ * @param stats
+ * The statistics of the matrix
+ * @param operation
+ * The operation that will be computed
+ * @return Sparse_Matrix_Format
+ * The format chosen
+ */
+Sparse_Matrix_Format sparse_matrix_select_format(Sparse_Matrix_Stats *stats, Sparse_Matrix_Operation operation){
+    int diaAccepted = stats->numberNonNull > 0 && stats->diagonalFill * DIA_MAX_FILL_RATIO >= 1.0;
+
+    switch(operation){
+        case SPARSE_OPERATION_MULTIPLY_VECTOR:
+            if(stats->numberNonNull == 0){
+                return SPARSE_FORMAT_LINKED;
+            }
+
+            if(diaAccepted){
+                return SPARSE_FORMAT_DIA;
+            }
+
+            if(stats->symmetric){
+                return SPARSE_FORMAT_SYMMETRIC;
+            }
+
+            if(stats->blockFill >= ANALYZER_MIN_BLOCK_FILL){
+                return SPARSE_FORMAT_BSR;
+            }
+
+            return SPARSE_FORMAT_CSR;
+
+        case SPARSE_OPERATION_MULTIPLY_SCALAR:
+        case SPARSE_OPERATION_SUM:
+            return diaAccepted ? SPARSE_FORMAT_DIA : SPARSE_FORMAT_LINKED;
+
+        default:
+            return SPARSE_FORMAT_LINKED;
+    }
+}
+
+/**
+ * @brief This function returns the name of a storage format.
+ *
+ * @brief Time Complexity: O(1), because the names are constant
+ *
+ * @param format
+ * The format wanted
+ * @return const char*
+ * The name of the format
+ */
+const char *sparse_matrix_format_name(Sparse_Matrix_Format format){
+    switch(format){
+        case SPARSE_FORMAT_CSR:
+            return "CSR";
+        case SPARSE_FORMAT_BSR:
+            return "BSR";
+        case SPARSE_FORMAT_DIA:
+            return "DIA";
+        case SPARSE_FORMAT_SYMMETRIC:
+            return "SYMMETRIC";
+        default:
+            return "LINKED";
+    }
+}
+
+/**
+ * @brief This function shows on the screen the statistics of a matrix.
+ *
+ * @brief Time Complexity: O(1), because only the statistics are printed
+ *
+ * @param stats
+ * The statistics that will be displayed
+ */
+void sparse_matrix_stats_show(Sparse_Matrix_Stats *stats){
+    printf("\033[92mSHOW MATRIX STATISTICS:\nROWS: %d COLUMNS: %d NON-NULL: %d\n\n\033[0m", stats->numberRows, stats->numberColumns, stats->numberNonNull);
+    printf("\033[95mNON-NULL PER ROW\033[0m \033[97m--> \033[0mmin %d, max %d, mean %.2f, deviation %.2f, empty rows %d\n", stats->minRowNonNull, stats->maxRowNonNull, stats->meanRowNonNull, stats->deviationRowNonNull, stats->emptyRows);
+    printf("\033[95mBANDWIDTH\033[0m \033[97m--> \033[0mlower %d, upper %d\n", stats->lowerBandwidth, stats->upperBandwidth);
+    printf("\033[95mSYMMETRY\033[0m \033[97m--> \033[0mvalues %s, structure %s\n", stats->symmetric ? "yes" : "no", stats->structurallySymmetric ? "yes" : "no");
+    printf("\033[95mDIAGONALS\033[0m \033[97m--> \033[0mmain %d, occupied %d, fill %.2f\n", stats->diagonalNonNull, stats->numberDiagonals, stats->diagonalFill);
+    printf("\033[95mBLOCKS %dx%d\033[0m \033[97m--> \033[0mnumber %d, fill %.2f\n", BSR_BLOCK_SIZE, BSR_BLOCK_SIZE, stats->numberBlocks, stats->blockFill);
+}
+
+/**
+ * @brief This function frees the converted forms cached by a plan.
+ *
+ * @brief Time Complexity: O(1), because each form is freed in a unique way
+ *
+ * @param plan
+ * The plan that will be cleared
+ */
+static void _sparse_matrix_plan_clear(Sparse_Matrix_Plan *plan){
+    if(plan->csr){
+        csr_matrix_destroy(plan->csr);
+    }
+
+    if(plan->symmetric){
+        csr_matrix_destroy(plan->symmetric);
+    }
+
+    if(plan->bsr){
+        bsr_matrix_destroy(plan->bsr);
+    }
+
+    if(plan->dia){
+        dia_matrix_destroy(plan->dia);
+    }
+
+    plan->csr = NULL;
+    plan->symmetric = NULL;
+    plan->bsr = NULL;
+    plan->dia = NULL;
+    plan->analyzed = 0;
+}
+
+/**
+ * @brief This function throws away the cached statistics and forms if the matrix was changed since they were computed.
+ *
+ * @brief Time Complexity: O(1), because only the version of the matrix is compared
+ *
+ * @param plan
+ * The plan that will be checked
+ */
+static void _sparse_matrix_plan_refresh(Sparse_Matrix_Plan *plan){
+    if(plan->version != sparse_matrix_version(plan->matrix)){
+        _sparse_matrix_plan_clear(plan);
+        plan->version = sparse_matrix_version(plan->matrix);
+    }
+}
+
+/**
+ * @brief This function creates a plan for a matrix. The plan analyzes the matrix and converts it to other formats only when an operation asks for them, keeping the results until the matrix changes.
+ *
+ * @brief Time Complexity: O(1), because nothing is computed until an operation is prepared
+ *
+ * @param matrix
+ * The matrix that will be planned (it isn't copied, so it must live longer than the plan)
+ * @return Sparse_Matrix_Plan*
+ * The new plan
+ */
+Sparse_Matrix_Plan *sparse_matrix_plan_create(Sparse_Matrix *matrix){
+    Sparse_Matrix_Plan *plan = (Sparse_Matrix_Plan *)calloc(1, sizeof(Sparse_Matrix_Plan));
+
+    plan->matrix = matrix;
+    plan->version = sparse_matrix_version(matrix);
+
+    return plan;
+}
+
+/**
+ * @brief This function frees the memory allocated for a plan and the forms it cached. The matrix isn't destroyed.
+ *
+ * @brief Time Complexity: O(1), because each form is freed in a unique way
+ *
+ * @param plan
+ * The plan that will be deallocated
+ */
+void sparse_matrix_plan_destroy(Sparse_Matrix_Plan *plan){
+    _sparse_matrix_plan_clear(plan);
+    free(plan);
+}
+
+/**
+ * @brief This function returns the statistics of the planned matrix, analyzing it only if it changed since the last analysis.
+ *
+ * @brief Time Complexity: O(1) if the statistics are cached and O(n + r + c) if not
+ *
+ * @param plan
+ * The plan of the matrix
+ * @return Sparse_Matrix_Stats*
+ * The statistics of the matrix (owned by the plan)
+ */
+Sparse_Matrix_Stats *sparse_matrix_plan_stats(Sparse_Matrix_Plan *plan){
+    _sparse_matrix_plan_refresh(plan);
+
+    if(!plan->analyzed){
+        plan->stats = sparse_matrix_analyze(plan->matrix);
+        plan->analyzed = 1;
+    }
+
+    return &plan->stats;
+}
+
+/**
+ * @brief This function returns the planned matrix in the format wanted, converting it only if the format isn't cached yet.
+ *
+ * @brief Time Complexity: O(1) if the format is cached and O(n) (plus the size of the new format) if not
+ *
+ * @param plan
+ * The plan of the matrix
+ * @param format
+ * The format wanted
+ * @return void*
+ * The Sparse_Matrix*, Csr_Matrix*, Bsr_Matrix* or Dia_Matrix* of the format (owned by the plan), or NULL if the diagonal format is rejected
+ */
+void *sparse_matrix_plan_convert(Sparse_Matrix_Plan *plan, Sparse_Matrix_Format format){
+    _sparse_matrix_plan_refresh(plan);
+
+    switch(format){
+        case SPARSE_FORMAT_CSR:
+            if(!plan->csr){
+                plan->csr = csr_matrix_from_sparse(plan->matrix);
+            }
+
+            return plan->csr;
+
+        case SPARSE_FORMAT_SYMMETRIC:
+            if(!plan->symmetric){
+                plan->symmetric = csr_matrix_from_sparse_symmetric(plan->matrix);
+            }
+
+            return plan->symmetric;
+
+        case SPARSE_FORMAT_BSR:
+            if(!plan->bsr){
+                plan->bsr = bsr_matrix_from_sparse(plan->matrix);
+            }
+
+            return plan->bsr;
+
+        case SPARSE_FORMAT_DIA:
+            if(!plan->dia){
+                plan->dia = dia_matrix_from_sparse(plan->matrix, DIA_MAX_FILL_RATIO);
+            }
+
+            return plan->dia;
+
+        default:
+            return plan->matrix;
+    }
+}
+
+/**
+ * @brief This function chooses the best format for an operation and makes sure the matrix is available in it.
+ *
+ * @brief Time Complexity: O(1) if the statistics and the format are cached and O(n + r + c) if not
+ *
+ * @param plan
+ * The plan of the matrix
+ * @param operation
+ * The operation that will be computed
+ * @return Sparse_Matrix_Format
+ * The format chosen
+ */
+Sparse_Matrix_Format sparse_matrix_plan_prepare(Sparse_Matrix_Plan *plan, Sparse_Matrix_Operation operation){
+    Sparse_Matrix_Format format = sparse_matrix_select_format(sparse_matrix_plan_stats(plan), operation);
+
+    sparse_matrix_plan_convert(plan, format);
+
+    return format;
+}
+
+/**
+ * @brief This function multiplies the planned matrix by a dense vector (result = matrix * vector) using the best format for it.
+ *
+ * @brief Time Complexity: O(n) for the product, plus the analysis and conversion the first time after a change
+ *
+ * @param plan
+ * The plan of the matrix
+ * @param vector
+ * The vector of size numberColumns
+ * @param result
+ * The vector of size numberRows that will receive the product
+ */
+void sparse_matrix_plan_multiply_vector(Sparse_Matrix_Plan *plan, const matrix_value_type *vector, matrix_value_type *result){
+    switch(sparse_matrix_plan_prepare(plan, SPARSE_OPERATION_MULTIPLY_VECTOR)){
+        case SPARSE_FORMAT_CSR:
+            csr_matrix_multiply_vector(plan->csr, vector, result);
+            break;
+
+        case SPARSE_FORMAT_SYMMETRIC:
+            csr_matrix_multiply_vector(plan->symmetric, vector, result);
+            break;
+
+        case SPARSE_FORMAT_BSR:
+            bsr_matrix_multiply_vector(plan->bsr, vector, result);
+            break;
+
+        case SPARSE_FORMAT_DIA:
+            dia_matrix_multiply_vector(plan->dia, vector, result);
+            break;
+
+        default:
+            sparse_matrix_multiply_vector(plan->matrix, vector, result);
+            break;
+    }
+}
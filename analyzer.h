@@ -0,0 +1,54 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include "matrix.h"
+
+typedef struct Sparse_Matrix_Plan Sparse_Matrix_Plan;
+
+typedef struct Sparse_Matrix_Stats{
+    int numberRows, numberColumns, numberNonNull;
+    int emptyRows, minRowNonNull, maxRowNonNull;
+    double meanRowNonNull, deviationRowNonNull;
+    int lowerBandwidth, upperBandwidth;
+    int symmetric, structurallySymmetric;
+    int diagonalNonNull, numberDiagonals;
+    double diagonalFill;
+    int numberBlocks;
+    double blockFill;
+} Sparse_Matrix_Stats;
+
+typedef enum{
+    SPARSE_FORMAT_LINKED,
+    SPARSE_FORMAT_CSR,
+    SPARSE_FORMAT_BSR,
+    SPARSE_FORMAT_DIA,
+    SPARSE_FORMAT_SYMMETRIC
+} Sparse_Matrix_Format;
+
+typedef enum{
+    SPARSE_OPERATION_UPDATE,
+    SPARSE_OPERATION_MULTIPLY_VECTOR,
+    SPARSE_OPERATION_MULTIPLY_SCALAR,
+    SPARSE_OPERATION_SUM
+} Sparse_Matrix_Operation;
+
+//Minimum fraction of the stored block slots that must be non-null to choose the block format
+#define ANALYZER_MIN_BLOCK_FILL 0.5
+
+//Analysis functions
+
+Sparse_Matrix_Stats sparse_matrix_analyze(Sparse_Matrix *matrix);
+Sparse_Matrix_Format sparse_matrix_select_format(Sparse_Matrix_Stats *stats, Sparse_Matrix_Operation operation);
+const char *sparse_matrix_format_name(Sparse_Matrix_Format format);
+void sparse_matrix_stats_show(Sparse_Matrix_Stats *stats);
+
+//Plan functions
+
+Sparse_Matrix_Plan *sparse_matrix_plan_create(Sparse_Matrix *matrix);
+void sparse_matrix_plan_destroy(Sparse_Matrix_Plan *plan);
+Sparse_Matrix_Stats *sparse_matrix_plan_stats(Sparse_Matrix_Plan *plan);
+Sparse_Matrix_Format sparse_matrix_plan_prepare(Sparse_Matrix_Plan *plan, Sparse_Matrix_Operation operation);
+void *sparse_matrix_plan_convert(Sparse_Matrix_Plan *plan, Sparse_Matrix_Format format);
+void sparse_matrix_plan_multiply_vector(Sparse_Matrix_Plan *plan, const matrix_value_type *vector, matrix_value_type *result);
+
+#endif
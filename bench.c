@@ -0,0 +1,472 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "matrix.h"
+
+#define BENCH_MAX_REPETITIONS 1000
+
+typedef struct Triplet{
+    int row, column;
+    matrix_value_type value;
+} Triplet;
+
+typedef struct Bench_Config{
+    int rows, columns, repetitions, kernelSize;
+    double density;
+    unsigned long long seed;
+    const char *pattern;
+} Bench_Config;
+
+static unsigned long long rng_state;
+
+/**
+ * @brief This function returns the next pseudo-random number (xorshift64*), so the generated matrices are the same in every run with the same seed.
+ *
+ * @brief Time Complexity: O(1), because only a few bit operations are done
+ *
+ * @return unsigned long long
+ * The random number
+ */
+static unsigned long long bench_random(){
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+
+    return rng_state * 2685821657736338717ULL;
+}
+
+/**
+ * @brief This function returns a pseudo-random number uniformly distributed in [0, 1).
+ *
+ * @brief Time Complexity: O(1), because only a few bit operations are done
+ *
+ * @return double
+ * The random number
+ */
+static double bench_uniform(){
+    return (bench_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief This function returns a non-null random value for the entries of the generated matrices.
+ *
+ * @brief Time Complexity: O(1), because only a random number is drawn
+ *
+ * @return matrix_value_type
+ * The random value in [1, 10)
+ */
+static matrix_value_type bench_value(){
+    return (matrix_value_type)(1.0 + 9.0 * bench_uniform());
+}
+
+/**
+ * @brief This function generates entries in uniformly random positions. Repeated positions are allowed, they are overwritten when the matrix is built.
+ *
+ * @brief Time Complexity: O(n), because each of the n entries is drawn once
+ *
+ * @param config
+ * The size and density of the matrix
+ * @param count
+ * The pointer that will receive the number of entries
+ * @return Triplet*
+ * The array of entries
+ */
+static Triplet *bench_generate_uniform(Bench_Config *config, int *count){
+    *count = (int)(config->density * config->rows * config->columns) + 1;
+    Triplet *triplets = (Triplet *)malloc(*count * sizeof(Triplet));
+
+    for(int k = 0; k < *count; k++){
+        triplets[k].row = bench_random() % config->rows;
+        triplets[k].column = bench_random() % config->columns;
+        triplets[k].value = bench_value();
+    }
+
+    return triplets;
+}
+
+/**
+ * @brief This function generates entries whose rows and columns follow a power law (a few rows and columns hold most of the values), like the adjacency matrices of real graphs.
+ *
+ * @brief Time Complexity: O(n), because each of the n entries is drawn once
+ *
+ * @param config
+ * The size and density of the matrix
+ * @param count
+ * The pointer that will receive the number of entries
+ * @return Triplet*
+ * The array of entries
+ */
+static Triplet *bench_generate_power_law(Bench_Config *config, int *count){
+    *count = (int)(config->density * config->rows * config->columns) + 1;
+    Triplet *triplets = (Triplet *)malloc(*count * sizeof(Triplet));
+
+    //Index = size^u - 1 gives P(index) ~ 1/(index + 1), a Zipf-like distribution
+    for(int k = 0; k < *count; k++){
+        triplets[k].row = (int)(pow(config->rows + 1, bench_uniform()) - 1) % config->rows;
+        triplets[k].column = (int)(pow(config->columns + 1, bench_uniform()) - 1) % config->columns;
+        triplets[k].value = bench_value();
+    }
+
+    return triplets;
+}
+
+/**
+ * @brief This function generates a banded matrix: every row holds its values around the main diagonal, with the half bandwidth chosen to match the density.
+ *
+ * @brief Time Complexity: O(n), because each of the n entries is generated once
+ *
+ * @param config
+ * The size and density of the matrix
+ * @param count
+ * The pointer that will receive the number of entries
+ * @return Triplet*
+ * The array of entries
+ */
+static Triplet *bench_generate_banded(Bench_Config *config, int *count){
+    int half = (int)(config->density * config->columns / 2);
+    Triplet *triplets = (Triplet *)malloc((size_t)config->rows * (2 * half + 1) * sizeof(Triplet));
+
+    *count = 0;
+
+    for(int i = 0; i < config->rows; i++){
+        for(int j = i - half; j <= i + half; j++){
+            if(j >= 0 && j < config->columns){
+                triplets[*count].row = i;
+                triplets[*count].column = j;
+                triplets[*count].value = bench_value();
+                (*count)++;
+            }
+        }
+    }
+
+    return triplets;
+}
+
+/**
+ * @brief This function generates a block-structured matrix: dense 8x8 blocks placed in random positions of an 8x8 grid until the density is reached.
+ *
+ * @brief Time Complexity: O(n), because each of the n entries is generated once
+ *
+ * @param config
+ * The size and density of the matrix
+ * @param count
+ * The pointer that will receive the number of entries
+ * @return Triplet*
+ * The array of entries
+ */
+static Triplet *bench_generate_block(Bench_Config *config, int *count){
+    int side = 8;
+    int numberBlocks = (int)(config->density * config->rows * config->columns / (side * side)) + 1;
+    Triplet *triplets = (Triplet *)malloc((size_t)numberBlocks * side * side * sizeof(Triplet));
+
+    *count = 0;
+
+    for(int b = 0; b < numberBlocks; b++){
+        int firstRow = (int)(bench_random() % ((config->rows + side - 1) / side)) * side;
+        int firstColumn = (int)(bench_random() % ((config->columns + side - 1) / side)) * side;
+
+        for(int i = firstRow; i < firstRow + side && i < config->rows; i++){
+            for(int j = firstColumn; j < firstColumn + side && j < config->columns; j++){
+                triplets[*count].row = i;
+                triplets[*count].column = j;
+                triplets[*count].value = bench_value();
+                (*count)++;
+            }
+        }
+    }
+
+    return triplets;
+}
+
+/**
+ * @brief This function generates the entries of the pattern asked in the configuration.
+ *
+ * @brief Time Complexity: O(n), because each of the n entries is generated once
+ *
+ * @param config
+ * The configuration of the benchmark
+ * @param pattern
+ * The name of the pattern: uniform, powerlaw, banded or block
+ * @param count
+ * The pointer that will receive the number of entries
+ * @return Triplet*
+ * The array of entries
+ */
+static Triplet *bench_generate(Bench_Config *config, const char *pattern, int *count){
+    if(strcmp(pattern, "powerlaw") == 0){
+        return bench_generate_power_law(config, count);
+    }
+
+    if(strcmp(pattern, "banded") == 0){
+        return bench_generate_banded(config, count);
+    }
+
+    if(strcmp(pattern, "block") == 0){
+        return bench_generate_block(config, count);
+    }
+
+    return bench_generate_uniform(config, count);
+}
+
+/**
+ * @brief This function builds a sparse matrix from entries, making sure the last row and column exist even if they are empty.
+ *
+ * @brief Time Complexity: O(n*m), because each of the n entries is placed with a O(m) insertion
+ *
+ * @param config
+ * The size of the matrix
+ * @param triplets
+ * The entries of the matrix
+ * @param count
+ * The number of entries
+ * @return Sparse_Matrix*
+ * The new matrix
+ */
+static Sparse_Matrix *bench_build(Bench_Config *config, Triplet *triplets, int count){
+    Sparse_Matrix *matrix = sparse_matrix_create();
+
+    _sparse_matrix_realloc(matrix, config->rows - 1, config->columns - 1);
+
+    for(int k = 0; k < count; k++){
+        sparse_matrix_set_by_index(matrix, triplets[k].value, triplets[k].row, triplets[k].column);
+    }
+
+    return matrix;
+}
+
+/**
+ * @brief This function returns the current time of a monotonic clock.
+ *
+ * @brief Time Complexity: O(1), because only the clock is read
+ *
+ * @return double
+ * The time in nanoseconds
+ */
+static double bench_now(){
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/**
+ * @brief This function returns the peak resident memory of the process.
+ *
+ * @brief Time Complexity: O(1), because only the kernel is asked
+ *
+ * @return long
+ * The peak resident memory in kilobytes
+ */
+static long bench_peak_rss(){
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief This function compares two times, to sort them.
+ *
+ * @brief Time Complexity: O(1), because only two values are compared
+ */
+static int bench_compare_times(const void *a, const void *b){
+    double first = *(const double *)a;
+    double second = *(const double *)b;
+
+    return (first > second) - (first < second);
+}
+
+static int first_result = 1;
+
+/**
+ * @brief This function prints the statistics of the repetitions of an operation as a JSON object: median, 99th percentile (nearest rank), throughput in items per second and peak resident memory.
+ *
+ * @brief Time Complexity: O(k*log(k)), because the k times are sorted
+ *
+ * @param pattern
+ * The pattern of the matrix
+ * @param operation
+ * The name of the operation
+ * @param times
+ * The time of each repetition, in nanoseconds
+ * @param repetitions
+ * The number of repetitions
+ * @param items
+ * The number of items (entries, lookups or output values) processed by each repetition
+ */
+static void bench_report(const char *pattern, const char *operation, double *times, int repetitions, long items){
+    qsort(times, repetitions, sizeof(double), bench_compare_times);
+
+    double median = repetitions % 2 ? times[repetitions / 2] : (times[repetitions / 2 - 1] + times[repetitions / 2]) / 2;
+    int rank = (int)ceil(0.99 * repetitions) - 1;
+    double p99 = times[rank < 0 ? 0 : rank];
+    double throughput = median > 0 ? items / (median / 1e9) : 0;
+
+    printf("%s\n    {\"pattern\": \"%s\", \"operation\": \"%s\", \"repetitions\": %d, \"items\": %ld, \"median_ns\": %.0f, \"p99_ns\": %.0f, \"throughput_items_per_s\": %.1f, \"peak_rss_kb\": %ld}",
+        first_result ? "" : ",", pattern, operation, repetitions, items, median, p99, throughput, bench_peak_rss());
+
+    first_result = 0;
+}
+
+//Times BODY over the repetitions; SETUP and TEARDOWN run around each repetition but aren't timed
+#define BENCH_OPERATION(PATTERN, NAME, ITEMS, SETUP, BODY, TEARDOWN) \
+    do{ \
+        double times[BENCH_MAX_REPETITIONS]; \
+        for(int r = 0; r < config->repetitions; r++){ \
+            SETUP; \
+            double begin = bench_now(); \
+            BODY; \
+            times[r] = bench_now() - begin; \
+            TEARDOWN; \
+        } \
+        bench_report(PATTERN, NAME, times, config->repetitions, ITEMS); \
+    } while(0)
+
+/**
+ * @brief This function runs every operation of the library over a matrix of one pattern and prints the results.
+ *
+ * @brief Time Complexity: the sum of the complexities of the operations, times the number of repetitions
+ *
+ * @param config
+ * The configuration of the benchmark
+ * @param pattern
+ * The name of the pattern
+ */
+static void bench_pattern(Bench_Config *config, const char *pattern){
+    int count;
+    Triplet *triplets = bench_generate(config, pattern, &count);
+    Sparse_Matrix *matrix = bench_build(config, triplets, count);
+    Sparse_Matrix *other = bench_build(config, triplets, count);
+    Sparse_Matrix *transposed = sparse_matrix_create();
+    Sparse_Matrix *result = NULL;
+    Sparse_Matrix *built = NULL;
+    long area = (long)config->rows * config->columns;
+    int lookups = count;
+    volatile matrix_value_type sink = 0;
+
+    //The multiplication needs a right operand with as many rows as the matrix has columns
+    _sparse_matrix_realloc(transposed, config->columns - 1, config->rows - 1);
+
+    for(int k = 0; k < count; k++){
+        sparse_matrix_set_by_index(transposed, triplets[k].value, triplets[k].column, triplets[k].row);
+    }
+
+    Sparse_Matrix *kernel = sparse_matrix_create();
+
+    for(int i = 0; i < config->kernelSize; i++){
+        for(int j = 0; j < config->kernelSize; j++){
+            sparse_matrix_set_by_index(kernel, bench_value(), i, j);
+        }
+    }
+
+    BENCH_OPERATION(pattern, "build", count, , built = bench_build(config, triplets, count), sparse_matrix_destroy(built));
+
+    BENCH_OPERATION(pattern, "get_by_index", lookups, ,
+        for(int k = 0; k < lookups; k++){
+            sink += sparse_matrix_get_by_index(matrix, triplets[k].row, (triplets[k].column + k) % config->columns);
+        }, );
+
+    BENCH_OPERATION(pattern, "set_by_index", lookups, built = bench_build(config, triplets, count),
+        for(int k = 0; k < lookups; k++){
+            sparse_matrix_set_by_index(built, k % 3 ? triplets[k].value * 2 : 0, triplets[k].row, triplets[k].column);
+        }, sparse_matrix_destroy(built));
+
+    BENCH_OPERATION(pattern, "sum_cells", sparse_matrix_number_non_null(matrix), , sink += _sparse_matrix_sum_cells(matrix), );
+    BENCH_OPERATION(pattern, "multiply_scalar", count, , result = sparse_matrix_multiply_scalar(matrix, 2), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "sum", count, , result = sparse_matrix_sum(matrix, other), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "multiplication", (long)config->rows * config->rows, , result = sparse_matrix_multiplication(matrix, transposed), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "multiply_point", count, , result = sparse_matrix_multiply_point(matrix, other), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "transpose", count, , result = sparse_matrix_transpose(matrix), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "swap_columns", count, , result = sparse_matrix_swap_columns(matrix, 0, config->columns - 1), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "swap_rows", count, , result = sparse_matrix_swap_rows(matrix, 0, config->rows - 1), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "slice", area / 4, , result = sparse_matrix_slice(matrix, config->rows / 4, config->columns / 4, 3 * config->rows / 4 - 1, 3 * config->columns / 4 - 1), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "convolution", area, , result = sparse_matrix_convolution(matrix, kernel), sparse_matrix_destroy(result));
+    BENCH_OPERATION(pattern, "binary_save", count, , sparse_matrix_binary_save(matrix), );
+    BENCH_OPERATION(pattern, "binary_read", count, , result = sparse_matrix_binary_read("./matrix.bin"), sparse_matrix_destroy(result));
+
+    remove("./matrix.bin");
+    sparse_matrix_destroy(kernel);
+    sparse_matrix_destroy(transposed);
+    sparse_matrix_destroy(other);
+    sparse_matrix_destroy(matrix);
+    free(triplets);
+}
+
+/**
+ * @brief This function shows how to call the benchmark and exits.
+ *
+ * @brief Time Complexity: O(1), because only the usage is printed
+ */
+static void bench_usage(){
+    printf("Usage: ./bench [--rows N] [--columns N] [--density D] [--repetitions K] [--kernel N] [--seed S] [--pattern uniform|powerlaw|banded|block|all]\n");
+    exit(1);
+}
+
+int main(int argc, char **argv){
+    Bench_Config config = {200, 200, 5, 3, 0.05, 42, "all"};
+    const char *patterns[] = {"uniform", "powerlaw", "banded", "block"};
+
+    for(int i = 1; i < argc; i++){
+        if(i + 1 >= argc){
+            bench_usage();
+        }
+
+        if(strcmp(argv[i], "--rows") == 0){
+            config.rows = atoi(argv[++i]);
+        }
+
+        else if(strcmp(argv[i], "--columns") == 0){
+            config.columns = atoi(argv[++i]);
+        }
+
+        else if(strcmp(argv[i], "--density") == 0){
+            config.density = atof(argv[++i]);
+        }
+
+        else if(strcmp(argv[i], "--repetitions") == 0){
+            config.repetitions = atoi(argv[++i]);
+        }
+
+        else if(strcmp(argv[i], "--kernel") == 0){
+            config.kernelSize = atoi(argv[++i]);
+        }
+
+        else if(strcmp(argv[i], "--seed") == 0){
+            config.seed = strtoull(argv[++i], NULL, 10);
+        }
+
+        else if(strcmp(argv[i], "--pattern") == 0){
+            config.pattern = argv[++i];
+        }
+
+        else{
+            bench_usage();
+        }
+    }
+
+    if(config.rows < 4 || config.columns < 4 || config.repetitions < 1 || config.repetitions > BENCH_MAX_REPETITIONS || config.kernelSize % 2 == 0 || config.density <= 0){
+        printf("\033[91mError: invalid benchmark configuration!\n\033[0m");
+        exit(1);
+    }
+
+    sparse_matrix_set_verbose(0);
+    rng_state = config.seed ? config.seed : 1;
+
+    printf("{\n  \"config\": {\"rows\": %d, \"columns\": %d, \"density\": %g, \"repetitions\": %d, \"kernel\": %d, \"seed\": %llu},\n  \"results\": [",
+        config.rows, config.columns, config.density, config.repetitions, config.kernelSize, config.seed);
+
+    for(int p = 0; p < 4; p++){
+        if(strcmp(config.pattern, "all") == 0 || strcmp(config.pattern, patterns[p]) == 0){
+            bench_pattern(&config, patterns[p]);
+        }
+    }
+
+    printf("\n  ],\n  \"peak_rss_kb\": %ld\n}\n", bench_peak_rss());
+
+    return 0;
+}
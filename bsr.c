@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "cell.h"
+#include "bsr.h"
+
+typedef struct Bsr_Matrix{
+    int numberRows, numberColumns;
+    int numberBlockRows, numberBlockColumns, numberBlocks;
+    int *blockRowPointers;
+    int *blockColumnIndexes;
+    matrix_value_type *values;
+} Bsr_Matrix;
+
+/**
+ * @brief This function converts a sparse matrix to the block compressed row (BSR) format, where the non-null values are grouped in dense blocks of BSR_BLOCK_SIZE x BSR_BLOCK_SIZE and the blocks are stored like a compressed row matrix.
+ *
+ * @brief Time Complexity: O(n + b*s^2), because the row lists are walked twice and each of the b blocks of side s is zeroed
+ *
+ * @param matrix
+ * The matrix that will be converted
+ * @return Bsr_Matrix*
+ * The new block matrix
+ */
+Bsr_Matrix *bsr_matrix_from_sparse(Sparse_Matrix *matrix){
+    Bsr_Matrix *bsr = (Bsr_Matrix *)malloc(sizeof(Bsr_Matrix));
+    Cell *current;
+
+    bsr->numberRows = sparse_matrix_number_rows(matrix);
+    bsr->numberColumns = sparse_matrix_number_columns(matrix);
+    bsr->numberBlockRows = (bsr->numberRows + BSR_BLOCK_SIZE - 1) / BSR_BLOCK_SIZE;
+    bsr->numberBlockColumns = (bsr->numberColumns + BSR_BLOCK_SIZE - 1) / BSR_BLOCK_SIZE;
+    bsr->blockRowPointers = (int *)malloc((bsr->numberBlockRows + 1) * sizeof(int));
+    bsr->blockRowPointers[0] = 0;
+
+    //slot[blockColumn] holds the position of the block in the current block row, valid while stamp[blockColumn] matches it
+    int *slot = (int *)malloc(bsr->numberBlockColumns * sizeof(int));
+    int *stamp = (int *)malloc(bsr->numberBlockColumns * sizeof(int));
+
+    for(int j = 0; j < bsr->numberBlockColumns; j++){
+        stamp[j] = -1;
+    }
+
+    for(int b = 0; b < bsr->numberBlockRows; b++){
+        int count = 0;
+
+        for(int i = b * BSR_BLOCK_SIZE; i < (b + 1) * BSR_BLOCK_SIZE && i < bsr->numberRows; i++){
+            current = _sparse_matrix_row_head(matrix, i);
+
+            while(current){
+                int blockColumn = current->positionColumn / BSR_BLOCK_SIZE;
+
+                if(stamp[blockColumn] != b){
+                    stamp[blockColumn] = b;
+                    count++;
+                }
+
+                current = current->nextRow;
+            }
+        }
+
+        bsr->blockRowPointers[b + 1] = bsr->blockRowPointers[b] + count;
+    }
+
+    bsr->numberBlocks = bsr->blockRowPointers[bsr->numberBlockRows];
+    bsr->blockColumnIndexes = (int *)malloc((bsr->numberBlocks + 1) * sizeof(int));
+    bsr->values = (matrix_value_type *)calloc((size_t)bsr->numberBlocks * BSR_BLOCK_SIZE * BSR_BLOCK_SIZE + 1, sizeof(matrix_value_type));
+
+    for(int j = 0; j < bsr->numberBlockColumns; j++){
+        stamp[j] = -1;
+    }
+
+    for(int b = 0; b < bsr->numberBlockRows; b++){
+        int position = bsr->blockRowPointers[b];
+
+        for(int i = b * BSR_BLOCK_SIZE; i < (b + 1) * BSR_BLOCK_SIZE && i < bsr->numberRows; i++){
+            current = _sparse_matrix_row_head(matrix, i);
+
+            while(current){
+                int blockColumn = current->positionColumn / BSR_BLOCK_SIZE;
+
+                if(stamp[blockColumn] != b){
+                    stamp[blockColumn] = b;
+                    slot[blockColumn] = position;
+                    bsr->blockColumnIndexes[position] = blockColumn;
+                    position++;
+                }
+
+                matrix_value_type *block = bsr->values + (size_t)slot[blockColumn] * BSR_BLOCK_SIZE * BSR_BLOCK_SIZE;
+                block[(i % BSR_BLOCK_SIZE) * BSR_BLOCK_SIZE + current->positionColumn % BSR_BLOCK_SIZE] = current->value;
+
+                current = current->nextRow;
+            }
+        }
+    }
+
+    free(slot);
+    free(stamp);
+
+    return bsr;
+}
+
+/**
+ * @brief This function frees the memory allocated for a block matrix.
+ *
+ * @brief Time Complexity: O(1), because the arrays are freed in a unique way
+ *
+ * @param matrix
+ * The block matrix that will be deallocated
+ */
+void bsr_matrix_destroy(Bsr_Matrix *matrix){
+    free(matrix->blockRowPointers);
+    free(matrix->blockColumnIndexes);
+    free(matrix->values);
+    free(matrix);
+}
+
+/**
+ * @brief This function returns the number of dense blocks stored in a block matrix.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param matrix
+ * The block matrix that will be evaluated
+ * @return int
+ * The number of blocks
+ */
+int bsr_matrix_number_blocks(Bsr_Matrix *matrix){
+    return matrix->numberBlocks;
+}
+
+/**
+ * @brief This function multiplies a block matrix by a dense vector (result = matrix * vector). Each block is a small dense product with fixed size, so one column index is read for BSR_BLOCK_SIZE^2 values.
+ *
+ * @brief Time Complexity: O(b*s^2), because each of the b blocks of side s is read once
+ *
+ * @param matrix
+ * The block matrix
+ * @param vector
+ * The vector of size numberColumns
+ * @param result
+ * The vector of size numberRows that will receive the product
+ */
+void bsr_matrix_multiply_vector(Bsr_Matrix *matrix, const matrix_value_type *vector, matrix_value_type *result){
+    for(int b = 0; b < matrix->numberBlockRows; b++){
+        matrix_value_type sum[BSR_BLOCK_SIZE] = {0};
+
+        for(int k = matrix->blockRowPointers[b]; k < matrix->blockRowPointers[b + 1]; k++){
+            const matrix_value_type *block = matrix->values + (size_t)k * BSR_BLOCK_SIZE * BSR_BLOCK_SIZE;
+            int firstColumn = matrix->blockColumnIndexes[k] * BSR_BLOCK_SIZE;
+            matrix_value_type x[BSR_BLOCK_SIZE];
+
+            //The last block column may go past the end of the vector
+            for(int c = 0; c < BSR_BLOCK_SIZE; c++){
+                x[c] = firstColumn + c < matrix->numberColumns ? vector[firstColumn + c] : 0;
+            }
+
+            for(int r = 0; r < BSR_BLOCK_SIZE; r++){
+                for(int c = 0; c < BSR_BLOCK_SIZE; c++){
+                    sum[r] += block[r * BSR_BLOCK_SIZE + c] * x[c];
+                }
+            }
+        }
+
+        for(int r = 0; r < BSR_BLOCK_SIZE && b * BSR_BLOCK_SIZE + r < matrix->numberRows; r++){
+            result[b * BSR_BLOCK_SIZE + r] = sum[r];
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef BSR_H
+#define BSR_H
+
+#include "matrix.h"
+
+typedef struct Bsr_Matrix Bsr_Matrix;
+
+//Side of the dense blocks stored by the block format
+#define BSR_BLOCK_SIZE 4
+
+//Allocation functions
+
+Bsr_Matrix *bsr_matrix_from_sparse(Sparse_Matrix *matrix);
+void bsr_matrix_destroy(Bsr_Matrix *matrix);
+
+//Getters functions
+
+int bsr_matrix_number_blocks(Bsr_Matrix *matrix);
+
+//Operation functions with matrices
+
+void bsr_matrix_multiply_vector(Bsr_Matrix *matrix, const matrix_value_type *vector, matrix_value_type *result);
+
+#endif
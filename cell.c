@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "cell.h"
+#include "instrument.h"
 
 /**
  * @brief This function creates a new pointer to a cell.
@@ -23,6 +24,8 @@
 Cell *cell_creating(int column, int row, matrix_value_type value, Cell *nextRow, Cell *nextColumn){
     Cell *cell = (Cell *)malloc(sizeof(Cell));
 
+    INSTRUMENT_COUNT(INSTRUMENT_CELLS_ALLOCATED, 1);
+
     cell->positionColumn = column;
     cell->positionRow = row;
     cell->value = value;
@@ -46,4 +49,6 @@ void cell_destroy(Cell *cell){
     cell->nextRow = NULL;
 
     free(cell);
+
+    INSTRUMENT_COUNT(INSTRUMENT_CELLS_FREED, 1);
 }
\ No newline at end of file
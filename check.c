@@ -0,0 +1,741 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "matrix.h"
+#include "loader.h"
+#include "hypersparse.h"
+#include "analyzer.h"
+#include "dense.h"
+#include "tiled.h"
+#include "dia.h"
+#include "convolution.h"
+#include "snapshot.h"
+
+#define CHECK_ROWS 300
+#define CHECK_COLUMNS 200
+#define CHECK_WRITERS 4
+#define CHECK_WRITES_PER_WRITER 20000
+#define CHECK_SNAPSHOT_ROWS 40
+#define CHECK_SNAPSHOT_COLUMNS 32
+#define CHECK_SNAPSHOT_VALUES 4
+#define CHECK_SNAPSHOT_READERS 4
+#define CHECK_PUBLICATIONS 2000
+
+typedef struct Check_Writer{
+    Sparse_Matrix *matrix;
+    int id;
+} Check_Writer;
+
+typedef struct Check_Reader{
+    Sparse_Matrix_Publisher *publisher;
+    int *stop;
+    int consistent;
+} Check_Reader;
+
+static unsigned long long rng_state = 88172645463325252ULL;
+static int failures;
+
+/**
+ * @brief This function returns the next pseudo-random number (xorshift64*), so every run checks the same matrices.
+ *
+ * @brief Time Complexity: O(1), because only a few bit operations are done
+ *
+ * @return unsigned long long
+ * The random number
+ */
+static unsigned long long check_random(){
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+
+    return rng_state * 2685821657736338717ULL;
+}
+
+/**
+ * @brief This function shows the result of a check and counts it if it failed.
+ *
+ * @brief Time Complexity: O(1), because only one line is printed
+ *
+ * @param name
+ * The name of the check
+ * @param passed
+ * 1 if the check passed or 0 if not
+ */
+static void check_report(const char *name, int passed){
+    if(passed){
+        printf("\033[92mPASS\033[0m %s\n", name);
+    }
+
+    else{
+        printf("\033[91mFAIL\033[0m %s\n", name);
+        failures++;
+    }
+}
+
+/**
+ * @brief This function builds a matrix with random values in random positions.
+ *
+ * @brief Time Complexity: O(k*(a + b)), where k is the number of values put and a and b are the lengths of their rows and columns
+ *
+ * @param rows
+ * The number of rows
+ * @param columns
+ * The number of columns
+ * @param count
+ * The number of values put (repeated positions are overwritten)
+ * @return Sparse_Matrix*
+ * The new matrix
+ */
+static Sparse_Matrix *check_random_matrix(int rows, int columns, int count){
+    Sparse_Matrix *matrix = sparse_matrix_create();
+
+    //The corner fixes the dimensions
+    sparse_matrix_set_by_index(matrix, 1, rows - 1, columns - 1);
+
+    for(int k = 0; k < count; k++){
+        sparse_matrix_set_by_index(matrix, (matrix_value_type)(check_random() % 19) - 9, check_random() % rows, check_random() % columns);
+    }
+
+    return matrix;
+}
+
+/**
+ * @brief This function tells if two matrices have the same dimensions and values, walking the rows and the columns of both.
+ *
+ * @brief Time Complexity: O(n1 + n2 + r + c)
+ *
+ * @return int
+ * 1 if they are equal or 0 if not
+ */
+static int check_equal(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2){
+    if(sparse_matrix_number_rows(matrix1) != sparse_matrix_number_rows(matrix2) || sparse_matrix_number_columns(matrix1) != sparse_matrix_number_columns(matrix2) || sparse_matrix_number_non_null(matrix1) != sparse_matrix_number_non_null(matrix2)){
+        return 0;
+    }
+
+    for(int i = 0; i < sparse_matrix_number_rows(matrix1); i++){
+        Sparse_Matrix_Cursor first = sparse_matrix_row_cursor(matrix1, i);
+        Sparse_Matrix_Cursor second = sparse_matrix_row_cursor(matrix2, i);
+
+        while(sparse_matrix_cursor_next(&first)){
+            if(!sparse_matrix_cursor_next(&second) || first.column != second.column || first.value != second.value){
+                return 0;
+            }
+        }
+
+        if(sparse_matrix_cursor_next(&second)){
+            return 0;
+        }
+    }
+
+    for(int j = 0; j < sparse_matrix_number_columns(matrix1); j++){
+        Sparse_Matrix_Cursor first = sparse_matrix_column_cursor(matrix1, j);
+        Sparse_Matrix_Cursor second = sparse_matrix_column_cursor(matrix2, j);
+
+        while(sparse_matrix_cursor_next(&first)){
+            if(!sparse_matrix_cursor_next(&second) || first.row != second.row || first.value != second.value){
+                return 0;
+            }
+        }
+
+        if(sparse_matrix_cursor_next(&second)){
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief This function checks that the parallel loader reads the same matrix as sparse_matrix_binary_read, with one thread and with several (the file is large enough to be split).
+ *
+ * @brief Time Complexity: O(n*t), where t is the number of thread counts tried
+ */
+static void check_loader(){
+    Sparse_Matrix *matrix = check_random_matrix(1000, 800, 120000);
+    int threads[] = {1, 2, 3, 8};
+
+    sparse_matrix_binary_save(matrix);
+
+    Sparse_Matrix *serial = sparse_matrix_binary_read("matrix.bin");
+
+    check_report("binary read matches the saved matrix", check_equal(matrix, serial));
+
+    for(int t = 0; t < (int)(sizeof(threads) / sizeof(threads[0])); t++){
+        char name[64];
+        Sparse_Matrix *parallel = sparse_matrix_binary_read_parallel("matrix.bin", threads[t]);
+
+        snprintf(name, sizeof(name), "parallel binary read with %d threads", threads[t]);
+        check_report(name, check_equal(serial, parallel));
+        sparse_matrix_destroy(parallel);
+    }
+
+    sparse_matrix_destroy(matrix);
+    sparse_matrix_destroy(serial);
+    remove("matrix.bin");
+}
+
+/**
+ * @brief This function is run by each writer: it puts and reads values on the rows it owns (row % CHECK_WRITERS == id), spread over every column, so the writers always share columns and some writes land past the expected dimensions.
+ *
+ * @brief Time Complexity: O(w*(a + b)), where w is CHECK_WRITES_PER_WRITER
+ */
+static void *check_writer(void *argument){
+    Check_Writer *writer = (Check_Writer *)argument;
+    unsigned long long state = 0x9e3779b97f4a7c15ULL * (writer->id + 1);
+
+    for(int k = 0; k < CHECK_WRITES_PER_WRITER; k++){
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+
+        unsigned long long random = state * 2685821657736338717ULL;
+        int row = (int)((random >> 8) % (CHECK_ROWS / CHECK_WRITERS + 10)) * CHECK_WRITERS + writer->id;
+        int column = (int)((random >> 24) % (CHECK_COLUMNS + 20));
+
+        //The value only depends on the position, so the final matrix doesn't depend on the order of the writes
+        sparse_matrix_set_by_index(writer->matrix, (random >> 40) % 4 ? (matrix_value_type)(row + column + 1) : 0, row, column);
+        sparse_matrix_get_by_index(writer->matrix, (int)((random >> 48) % CHECK_ROWS), column);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief This function checks the concurrent mode: several writers fill a matrix at the same time and the result must be a consistent matrix whose values match their positions. It's meant to also run under make check SANITIZE=thread.
+ *
+ * @brief Time Complexity: O(t*w*(a + b) + n + r + c), where t is CHECK_WRITERS
+ */
+static void check_concurrent(){
+    Sparse_Matrix *matrix = sparse_matrix_create();
+    pthread_t threads[CHECK_WRITERS];
+    Check_Writer writers[CHECK_WRITERS];
+    int consistent = 1;
+    int rowCount = 0, columnCount = 0;
+
+    sparse_matrix_concurrent_begin(matrix, CHECK_ROWS, CHECK_COLUMNS);
+
+    for(int t = 0; t < CHECK_WRITERS; t++){
+        writers[t].matrix = matrix;
+        writers[t].id = t;
+        pthread_create(&threads[t], NULL, check_writer, &writers[t]);
+    }
+
+    for(int t = 0; t < CHECK_WRITERS; t++){
+        pthread_join(threads[t], NULL);
+    }
+
+    sparse_matrix_concurrent_end(matrix);
+
+    for(int i = 0; i < sparse_matrix_number_rows(matrix); i++){
+        Sparse_Matrix_Cursor cursor = sparse_matrix_row_cursor(matrix, i);
+        int last = -1;
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            consistent &= cursor.column > last && cursor.value == (matrix_value_type)(cursor.row + cursor.column + 1);
+            last = cursor.column;
+            rowCount++;
+        }
+    }
+
+    for(int j = 0; j < sparse_matrix_number_columns(matrix); j++){
+        Sparse_Matrix_Cursor cursor = sparse_matrix_column_cursor(matrix, j);
+        int last = -1;
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            consistent &= cursor.row > last && sparse_matrix_get_by_index(matrix, cursor.row, j) == cursor.value;
+            last = cursor.row;
+            columnCount++;
+        }
+    }
+
+    check_report("concurrent writers leave sorted, consistent rows and columns", consistent && rowCount == columnCount);
+    check_report("concurrent writers keep the number of values", sparse_matrix_number_non_null(matrix) == rowCount);
+
+    sparse_matrix_destroy(matrix);
+}
+
+/**
+ * @brief This function is run by each reader of a publisher: it pins the current snapshot, checks that it holds a whole publication (every row has CHECK_SNAPSHOT_VALUES values, sorted by column, whose sum is fixed by the row, and the number of non-null values matches the rows) and unpins it, until the writer is done.
+ *
+ * @brief Time Complexity: O(p*r*v*log(v)), where p is the number of pins and v is CHECK_SNAPSHOT_VALUES
+ */
+static void *check_snapshot_reader(void *argument){
+    Check_Reader *reader = (Check_Reader *)argument;
+    Sparse_Matrix_Reader *handle = sparse_matrix_reader_register(reader->publisher);
+    unsigned long last = 0;
+
+    do{
+        const Sparse_Matrix_Snapshot *snapshot = sparse_matrix_reader_pin(handle);
+        unsigned long version = sparse_matrix_snapshot_version(snapshot);
+        int count = 0;
+
+        reader->consistent &= version >= last && sparse_matrix_snapshot_number_rows(snapshot) == CHECK_SNAPSHOT_ROWS;
+        last = version;
+
+        for(int i = 0; i < CHECK_SNAPSHOT_ROWS; i++){
+            const int *columns;
+            const matrix_value_type *values;
+            int length = sparse_matrix_snapshot_row(snapshot, i, &columns, &values);
+            matrix_value_type sum = 0;
+
+            for(int k = 0; k < length; k++){
+                reader->consistent &= (k == 0 || columns[k] > columns[k - 1]) && sparse_matrix_snapshot_get_by_index(snapshot, i, columns[k]) == values[k];
+                sum += values[k];
+            }
+
+            reader->consistent &= length == CHECK_SNAPSHOT_VALUES && sum == (matrix_value_type)((i + 1) * CHECK_SNAPSHOT_VALUES * (CHECK_SNAPSHOT_VALUES + 1) / 2);
+            count += length;
+        }
+
+        reader->consistent &= count == sparse_matrix_snapshot_number_non_null(snapshot);
+        sparse_matrix_reader_unpin(handle);
+    } while(!__atomic_load_n(reader->stop, __ATOMIC_ACQUIRE));
+
+    sparse_matrix_reader_unregister(handle);
+
+    return NULL;
+}
+
+/**
+ * @brief This function checks the snapshots: while the readers pin, read and unpin in a loop, the writer moves values inside the rows and publishes after each batch of moves, so every snapshot a reader sees must be a whole publication. Once the readers have unpinned, every retired snapshot must be reclaimed. It's meant to also run under make check SANITIZE=thread.
+ *
+ * @brief Time Complexity: O(p*(r + k) + q), where p is CHECK_PUBLICATIONS, k is the number of values copied by a publication and q is the work of the readers
+ */
+static void check_snapshot_readers(){
+    Sparse_Matrix *matrix = sparse_matrix_create();
+    int positions[CHECK_SNAPSHOT_ROWS][CHECK_SNAPSHOT_VALUES];
+    pthread_t threads[CHECK_SNAPSHOT_READERS];
+    Check_Reader readers[CHECK_SNAPSHOT_READERS];
+    int stop = 0;
+    int consistent = 1;
+
+    //The value k of the row i is (i + 1)*(k + 1), so the sum of a row never changes when its values move
+    for(int i = 0; i < CHECK_SNAPSHOT_ROWS; i++){
+        for(int k = 0; k < CHECK_SNAPSHOT_VALUES; k++){
+            positions[i][k] = k;
+            sparse_matrix_set_by_index(matrix, (matrix_value_type)((i + 1) * (k + 1)), i, k);
+        }
+    }
+
+    Sparse_Matrix_Publisher *publisher = sparse_matrix_publisher_create(matrix);
+
+    for(int t = 0; t < CHECK_SNAPSHOT_READERS; t++){
+        readers[t].publisher = publisher;
+        readers[t].stop = &stop;
+        readers[t].consistent = 1;
+        pthread_create(&threads[t], NULL, check_snapshot_reader, &readers[t]);
+    }
+
+    for(int p = 0; p < CHECK_PUBLICATIONS; p++){
+        //A batch moves a few values to free columns; a reader that saw a batch halfway would count a value twice or miss it
+        for(int m = 0; m < 3; m++){
+            int row = (int)(check_random() % CHECK_SNAPSHOT_ROWS);
+            int k = (int)(check_random() % CHECK_SNAPSHOT_VALUES);
+            int column = (int)(check_random() % CHECK_SNAPSHOT_COLUMNS);
+            int taken = 0;
+
+            for(int other = 0; other < CHECK_SNAPSHOT_VALUES; other++){
+                taken |= positions[row][other] == column;
+            }
+
+            if(!taken){
+                sparse_matrix_publisher_set(publisher, (matrix_value_type)((row + 1) * (k + 1)), row, column);
+                sparse_matrix_publisher_set(publisher, 0, row, positions[row][k]);
+                positions[row][k] = column;
+            }
+        }
+
+        sparse_matrix_publisher_publish(publisher);
+    }
+
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+
+    for(int t = 0; t < CHECK_SNAPSHOT_READERS; t++){
+        pthread_join(threads[t], NULL);
+        consistent &= readers[t].consistent;
+    }
+
+    check_report("pinned snapshots are whole publications", consistent);
+
+    sparse_matrix_publisher_reclaim(publisher);
+    check_report("retired snapshots are reclaimed once the readers unpin", sparse_matrix_publisher_retired(publisher) == 0);
+
+    sparse_matrix_publisher_destroy(publisher);
+    sparse_matrix_destroy(matrix);
+}
+
+/**
+ * @brief This function checks sparse_matrix_axpy with the same matrix on both sides, on a plain matrix, a compacted one and a clone: with alpha = -1 every value cancels, and with alpha = 1 the values double.
+ *
+ * @brief Time Complexity: O(n + r + c)
+ */
+static void check_axpy_aliased(){
+    for(int variant = 0; variant < 3; variant++){
+        const char *names[] = {"plain", "compacted", "cloned"};
+        char name[96];
+        Sparse_Matrix *original = check_random_matrix(60, 40, 600);
+        Sparse_Matrix *matrix = variant == 2 ? sparse_matrix_clone(original) : original;
+
+        if(variant == 1){
+            sparse_matrix_compact(matrix);
+        }
+
+        Sparse_Matrix *doubled = sparse_matrix_multiply_scalar(matrix, 2);
+        Sparse_Matrix *copy = sparse_matrix_multiply_scalar(original, 1);
+
+        sparse_matrix_axpy(matrix, 1, matrix);
+        snprintf(name, sizeof(name), "axpy of a %s matrix with itself doubles it", names[variant]);
+        check_report(name, check_equal(matrix, doubled));
+
+        sparse_matrix_axpy(matrix, -1, matrix);
+
+        int empty = sparse_matrix_number_non_null(matrix) == 0;
+
+        for(int i = 0; i < sparse_matrix_number_rows(matrix); i++){
+            empty &= _sparse_matrix_row_head(matrix, i) == NULL;
+        }
+
+        for(int j = 0; j < sparse_matrix_number_columns(matrix); j++){
+            empty &= _sparse_matrix_column_head(matrix, j) == NULL;
+        }
+
+        snprintf(name, sizeof(name), "axpy of a %s matrix with itself and alpha = -1 empties it", names[variant]);
+        check_report(name, empty && (variant != 2 || check_equal(original, copy)));
+
+        if(variant == 2){
+            sparse_matrix_destroy(matrix);
+        }
+
+        sparse_matrix_destroy(original);
+        sparse_matrix_destroy(doubled);
+        sparse_matrix_destroy(copy);
+    }
+}
+
+/**
+ * @brief This function checks that a hypersparse product has the rows of the first matrix and the columns of the second, even when the trailing ones are empty, and the same values as the sparse product.
+ *
+ * @brief Time Complexity: O(f + n + r + c), where f is the number of multiplications of non-null values
+ */
+static void check_hypersparse_multiplication(){
+    Sparse_Matrix *matrix1 = check_random_matrix(10, 6, 20);
+    Sparse_Matrix *matrix2 = check_random_matrix(6, 21, 20);
+
+    //The last columns of matrix2 are left empty
+    for(int i = 0; i < 6; i++){
+        for(int j = 8; j < 21; j++){
+            sparse_matrix_set_by_index(matrix2, 0, i, j);
+        }
+    }
+
+    Hypersparse_Matrix *hypersparse1 = hypersparse_matrix_from_sparse(matrix1);
+    Hypersparse_Matrix *hypersparse2 = hypersparse_matrix_from_sparse(matrix2);
+    Hypersparse_Matrix *product = hypersparse_matrix_multiplication(hypersparse1, hypersparse2);
+    Sparse_Matrix *expected = sparse_matrix_multiplication_pruned(matrix1, matrix2, 0);
+    Sparse_Matrix *converted = hypersparse_matrix_to_sparse(product);
+
+    check_report("hypersparse product has the rows of the first matrix and the columns of the second", hypersparse_matrix_number_rows(product) == 10 && hypersparse_matrix_number_columns(product) == 21);
+    check_report("hypersparse product matches the sparse product", check_equal(expected, converted));
+
+    hypersparse_matrix_destroy(hypersparse1);
+    hypersparse_matrix_destroy(hypersparse2);
+    hypersparse_matrix_destroy(product);
+    sparse_matrix_destroy(matrix1);
+    sparse_matrix_destroy(matrix2);
+    sparse_matrix_destroy(expected);
+    sparse_matrix_destroy(converted);
+}
+
+/**
+ * @brief This function is run by each reader of a shared clone: it walks every column, so the readers race to build the column index.
+ *
+ * @brief Time Complexity: O(n + c)
+ */
+static void *check_column_reader(void *argument){
+    Sparse_Matrix *matrix = (Sparse_Matrix *)argument;
+    matrix_value_type *sum = (matrix_value_type *)malloc(sizeof(matrix_value_type));
+
+    *sum = 0;
+
+    for(int j = 0; j < sparse_matrix_number_columns(matrix); j++){
+        Sparse_Matrix_Cursor cursor = sparse_matrix_column_cursor(matrix, j);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            *sum += cursor.value;
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * @brief This function checks that reading the columns of a clone doesn't copy its shared rows: the column reductions, the column cursors, the analyzer, the masked product and the transposed dense product must give the same results as on the original while every row stays shared. The column walks must also see a later change of the clone, and several threads may read the same clone at once.
+ *
+ * @brief Time Complexity: O(f + n + r + c), where f is the number of multiplications of the products
+ */
+static void check_clone_column_reads(){
+    Sparse_Matrix *original = check_random_matrix(60, 50, 700);
+    Sparse_Matrix *clone = sparse_matrix_clone(original);
+    int rows = sparse_matrix_number_rows(clone);
+    int columns = sparse_matrix_number_columns(clone);
+    matrix_value_type *expected = (matrix_value_type *)malloc(columns * sizeof(matrix_value_type));
+    matrix_value_type *sums = (matrix_value_type *)malloc(columns * sizeof(matrix_value_type));
+    int same = 1;
+
+    sparse_matrix_column_sums(original, expected);
+    sparse_matrix_column_sums(clone, sums);
+
+    for(int j = 0; j < columns; j++){
+        same &= expected[j] == sums[j];
+    }
+
+    same &= sparse_matrix_norm_one(original) == sparse_matrix_norm_one(clone);
+    same &= sparse_matrix_analyze(original).symmetric == sparse_matrix_analyze(clone).symmetric;
+
+    Sparse_Matrix *transposed = sparse_matrix_transpose(original);
+    Sparse_Matrix *mask = check_random_matrix(columns, columns, 300);
+    Sparse_Matrix *masked = sparse_matrix_multiplication_masked(transposed, clone, mask, 0);
+    Sparse_Matrix *maskedOriginal = sparse_matrix_multiplication_masked(transposed, original, mask, 0);
+
+    same &= check_equal(masked, maskedOriginal);
+
+    Dense_Matrix *dense = dense_matrix_create(rows, 3);
+
+    for(int i = 0; i < rows; i++){
+        for(int k = 0; k < 3; k++){
+            dense_matrix_set_by_index(dense, (matrix_value_type)(i + k), i, k);
+        }
+    }
+
+    Dense_Matrix *product = dense_matrix_sparse_multiplication(clone, 1, dense, 0);
+    Dense_Matrix *productOriginal = dense_matrix_sparse_multiplication(original, 1, dense, 0);
+
+    for(int i = 0; i < columns; i++){
+        for(int k = 0; k < 3; k++){
+            same &= dense_matrix_get_by_index(product, i, k) == dense_matrix_get_by_index(productOriginal, i, k);
+        }
+    }
+
+    check_report("column reads of a clone match the original", same && check_equal(original, clone));
+    check_report("column reads of a clone keep its rows shared", sparse_matrix_shared_rows(clone) == sparse_matrix_shared_rows(original) && sparse_matrix_shared_rows(clone) > 0);
+
+    pthread_t threads[CHECK_WRITERS];
+    Sparse_Matrix *fresh = sparse_matrix_clone(original);
+    matrix_value_type total = 0;
+    int agree = 1;
+
+    for(int j = 0; j < columns; j++){
+        total += expected[j];
+    }
+
+    for(int t = 0; t < CHECK_WRITERS; t++){
+        pthread_create(&threads[t], NULL, check_column_reader, fresh);
+    }
+
+    for(int t = 0; t < CHECK_WRITERS; t++){
+        matrix_value_type *sum;
+
+        pthread_join(threads[t], (void **)&sum);
+        agree &= *sum == total;
+        free(sum);
+    }
+
+    check_report("threads reading the columns of the same clone agree", agree);
+
+    //A change of the clone must show in its column walks and not in the original
+    int column = 7;
+    matrix_value_type before = sums[column];
+
+    sparse_matrix_set_by_index(clone, 1000, 0, column);
+    sparse_matrix_column_sums(clone, sums);
+
+    Sparse_Matrix_Cursor cursor = sparse_matrix_column_cursor(clone, column);
+    matrix_value_type walked = 0;
+
+    while(sparse_matrix_cursor_next(&cursor)){
+        walked += cursor.value;
+    }
+
+    check_report("column walks of a clone see its changes", walked == sums[column] && sparse_matrix_get_by_index(clone, 0, column) == 1000 && sparse_matrix_get_by_index(original, 0, column) != 1000 && before == expected[column]);
+
+    free(expected);
+    free(sums);
+    dense_matrix_destroy(dense);
+    dense_matrix_destroy(product);
+    dense_matrix_destroy(productOriginal);
+    sparse_matrix_destroy(transposed);
+    sparse_matrix_destroy(mask);
+    sparse_matrix_destroy(masked);
+    sparse_matrix_destroy(maskedOriginal);
+    sparse_matrix_destroy(fresh);
+    sparse_matrix_destroy(clone);
+    sparse_matrix_destroy(original);
+}
+
+/**
+ * @brief This function checks that the pruned product, which drops the small values while each row is flushed, matches the full product pruned afterwards, on a sparse product (rows flushed by sorting) and on a dense one (rows flushed by scanning).
+ *
+ * @brief Time Complexity: O(f + n + r + c), where f is the number of multiplications of non-null values
+ */
+static void check_multiplication_pruned(){
+    int counts[] = {40, 1500};
+
+    for(int variant = 0; variant < 2; variant++){
+        char name[96];
+        Sparse_Matrix *matrix1 = check_random_matrix(40, 30, counts[variant]);
+        Sparse_Matrix *matrix2 = check_random_matrix(30, 50, counts[variant]);
+        Sparse_Matrix *pruned = sparse_matrix_multiplication_pruned(matrix1, matrix2, 20);
+        Sparse_Matrix *expected = sparse_matrix_multiplication(matrix1, matrix2);
+
+        sparse_matrix_prune(expected, 20);
+        snprintf(name, sizeof(name), "pruned product matches the pruned full product (%s rows)", variant ? "dense" : "sparse");
+        check_report(name, check_equal(pruned, expected));
+
+        sparse_matrix_destroy(matrix1);
+        sparse_matrix_destroy(matrix2);
+        sparse_matrix_destroy(pruned);
+        sparse_matrix_destroy(expected);
+    }
+}
+
+/**
+ * @brief This function checks that the product written tile by tile to a file reads back as the product in memory, with a budget small enough to split it into many tiles.
+ *
+ * @brief Time Complexity: O(f + n + r + c), where f is the number of multiplications of non-null values
+ */
+static void check_multiplication_to_file(){
+    Sparse_Matrix *matrix1 = check_random_matrix(200, 80, 2000);
+    Sparse_Matrix *matrix2 = check_random_matrix(80, 120, 1500);
+    Sparse_Matrix *expected = sparse_matrix_multiplication(matrix1, matrix2);
+    long written = sparse_matrix_multiplication_to_file(matrix1, matrix2, "check_tiled.bin", 120 * 24 + 80 * 4 + 120 * 12 + TILED_MIN_TILE_BYTES);
+    Sparse_Matrix *read = sparse_matrix_binary_read("check_tiled.bin");
+
+    check_report("tiled product written to a file matches the product", written == sparse_matrix_number_non_null(expected) && check_equal(expected, read));
+
+    remove("check_tiled.bin");
+    sparse_matrix_destroy(matrix1);
+    sparse_matrix_destroy(matrix2);
+    sparse_matrix_destroy(expected);
+    sparse_matrix_destroy(read);
+}
+
+/**
+ * @brief This function checks the diagonal storage against the sparse product by a vector, on a banded matrix with sub-diagonals and super-diagonals that isn't square.
+ *
+ * @brief Time Complexity: O(d*m + n)
+ */
+static void check_dia_multiply_vector(){
+    Sparse_Matrix *matrix = sparse_matrix_create();
+    int rows = 70, columns = 50;
+
+    for(int i = 0; i < rows; i++){
+        for(int offset = -3; offset <= 2; offset++){
+            if(i + offset >= 0 && i + offset < columns){
+                sparse_matrix_set_by_index(matrix, (matrix_value_type)(i % 5 + offset + 4), i, i + offset);
+            }
+        }
+    }
+
+    Dia_Matrix *dia = dia_matrix_from_sparse(matrix, 4);
+    matrix_value_type *vector = (matrix_value_type *)malloc(columns * sizeof(matrix_value_type));
+    matrix_value_type *expected = (matrix_value_type *)malloc(rows * sizeof(matrix_value_type));
+    matrix_value_type *result = (matrix_value_type *)malloc(rows * sizeof(matrix_value_type));
+    int same = dia != NULL;
+
+    for(int j = 0; j < columns; j++){
+        vector[j] = (matrix_value_type)(j % 7 - 3);
+    }
+
+    sparse_matrix_multiply_vector(matrix, vector, expected);
+
+    if(dia){
+        dia_matrix_multiply_vector(dia, vector, result);
+
+        for(int i = 0; i < rows; i++){
+            same &= result[i] == expected[i];
+        }
+
+        dia_matrix_destroy(dia);
+    }
+
+    check_report("diagonal product by a vector matches the sparse one", same);
+
+    free(vector);
+    free(expected);
+    free(result);
+    sparse_matrix_destroy(matrix);
+}
+
+/**
+ * @brief This function checks that the FFT convolution gives the same outputs as the direct one, over every padding, stride and dilation. The values are small integers, so both methods are exact and the outputs are compared with no tolerance.
+ *
+ * @brief Time Complexity: O(n*t + k*p*log(p)), where n is the number of non-null values, t the number of taps, k the number of kernels and p the size of the padded matrix
+ */
+static void check_convolution_fft(){
+    Sparse_Matrix *matrix = check_random_matrix(40, 30, 350);
+    Sparse_Matrix *kernels[] = {check_random_matrix(3, 3, 6), check_random_matrix(2, 5, 7)};
+    Convolution_Padding paddings[] = {CONVOLUTION_PADDING_ZERO, CONVOLUTION_PADDING_VALID, CONVOLUTION_PADDING_REFLECT};
+    const char *names[] = {"zero", "valid", "reflect"};
+    int numberKernels = sizeof(kernels) / sizeof(kernels[0]);
+
+    for(int p = 0; p < (int)(sizeof(paddings) / sizeof(paddings[0])); p++){
+        for(int stride = 1; stride <= 2; stride++){
+            for(int dilation = 1; dilation <= 2; dilation++){
+                Convolution_Options options = convolution_options_default();
+                Sparse_Matrix *direct[sizeof(kernels) / sizeof(kernels[0])], *fft[sizeof(kernels) / sizeof(kernels[0])];
+                int same = 1;
+                char name[96];
+
+                options.padding = paddings[p];
+                options.strideRow = stride;
+                options.strideColumn = 3 - stride;
+                options.dilationRow = dilation;
+                options.dilationColumn = dilation;
+
+                options.method = CONVOLUTION_METHOD_DIRECT;
+                sparse_matrix_convolution_bank(matrix, kernels, numberKernels, options, direct);
+                options.method = CONVOLUTION_METHOD_FFT;
+                sparse_matrix_convolution_bank(matrix, kernels, numberKernels, options, fft);
+
+                for(int q = 0; q < numberKernels; q++){
+                    same &= check_equal(direct[q], fft[q]);
+                    sparse_matrix_destroy(direct[q]);
+                    sparse_matrix_destroy(fft[q]);
+                }
+
+                snprintf(name, sizeof(name), "FFT convolution matches direct with %s padding, stride %dx%d and dilation %d", names[p], options.strideRow, options.strideColumn, dilation);
+                check_report(name, same);
+            }
+        }
+    }
+
+    for(int q = 0; q < numberKernels; q++){
+        sparse_matrix_destroy(kernels[q]);
+    }
+
+    sparse_matrix_destroy(matrix);
+}
+
+int main(){
+    sparse_matrix_set_verbose(0);
+
+    check_loader();
+    check_concurrent();
+    check_snapshot_readers();
+    check_dia_multiply_vector();
+    check_axpy_aliased();
+    check_convolution_fft();
+    check_multiplication_pruned();
+    check_multiplication_to_file();
+    check_hypersparse_multiplication();
+    check_clone_column_reads();
+
+    if(failures){
+        printf("\033[91m%d check(s) failed!\n\033[0m", failures);
+        return 1;
+    }
+
+    printf("\033[92mAll checks passed.\n\033[0m");
+
+    return 0;
+}
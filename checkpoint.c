@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "checkpoint.h"
+#include "instrument.h"
+
+typedef struct Checkpoint_Buffer{
+    unsigned char *data;
+    size_t size;
+    int full;
+} Checkpoint_Buffer;
+
+typedef struct Sparse_Matrix_Save{
+    Sparse_Matrix *snapshot;
+    FILE *fp;
+    pthread_t serializer, writer;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    Checkpoint_Buffer buffers[2];
+    int serialized;
+    int done;
+    int failed;
+    long bytes;
+} Sparse_Matrix_Save;
+
+/**
+ * @brief This function hands a full buffer to the writer and waits until the other buffer is free to be filled.
+ *
+ * @brief Time Complexity: O(1), apart from the wait for the writer
+ *
+ * @param save
+ * The save in progress
+ * @param current
+ * The index of the buffer that was filled
+ */
+static void _checkpoint_swap(Sparse_Matrix_Save *save, int current){
+    pthread_mutex_lock(&save->lock);
+
+    save->buffers[current].full = 1;
+    pthread_cond_broadcast(&save->changed);
+
+    while(save->buffers[!current].full){
+        pthread_cond_wait(&save->changed, &save->lock);
+    }
+
+    pthread_mutex_unlock(&save->lock);
+}
+
+/**
+ * @brief This function runs on the serializer thread: it walks the snapshot row by row and writes the plain binary format (the number of values, then row, column and value of each one) into the two buffers in turn.
+ *
+ * @brief Time Complexity: O(n + r), because each value is serialized once
+ *
+ * @param argument
+ * The save in progress
+ * @return void*
+ * NULL
+ */
+static void *_checkpoint_serialize(void *argument){
+    Sparse_Matrix_Save *save = argument;
+    Sparse_Matrix *matrix = save->snapshot;
+    int current = 0;
+    int numberNonNull = sparse_matrix_number_non_null(matrix);
+    Checkpoint_Buffer *buffer = &save->buffers[current];
+
+    memcpy(buffer->data, &numberNonNull, sizeof(int));
+    buffer->size = sizeof(int);
+
+    for(int i = 0; i < sparse_matrix_number_rows(matrix); i++){
+        Sparse_Matrix_Cursor cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            if(buffer->size + 2 * sizeof(int) + sizeof(float) > CHECKPOINT_BUFFER_BYTES){
+                _checkpoint_swap(save, current);
+                current = !current;
+                buffer = &save->buffers[current];
+                buffer->size = 0;
+            }
+
+            float value = cursor.value;
+
+            memcpy(buffer->data + buffer->size, &cursor.row, sizeof(int));
+            memcpy(buffer->data + buffer->size + sizeof(int), &cursor.column, sizeof(int));
+            memcpy(buffer->data + buffer->size + 2 * sizeof(int), &value, sizeof(float));
+            buffer->size += 2 * sizeof(int) + sizeof(float);
+        }
+    }
+
+    pthread_mutex_lock(&save->lock);
+    buffer->full = 1;
+    save->serialized = 1;
+    pthread_cond_broadcast(&save->changed);
+    pthread_mutex_unlock(&save->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief This function runs on the writer thread: it writes each full buffer with a unique call, in the order they were filled, and frees it for the serializer.
+ *
+ * @brief Time Complexity: O(b), where b is the size of the file
+ *
+ * @param argument
+ * The save in progress
+ * @return void*
+ * NULL
+ */
+static void *_checkpoint_write(void *argument){
+    Sparse_Matrix_Save *save = argument;
+    int current = 0;
+
+    while(1){
+        pthread_mutex_lock(&save->lock);
+
+        while(!save->buffers[current].full && !(save->serialized && !save->buffers[0].full && !save->buffers[1].full)){
+            pthread_cond_wait(&save->changed, &save->lock);
+        }
+
+        int finished = !save->buffers[current].full;
+
+        pthread_mutex_unlock(&save->lock);
+
+        if(finished){
+            break;
+        }
+
+        Checkpoint_Buffer *buffer = &save->buffers[current];
+        size_t written = fwrite(buffer->data, 1, buffer->size, save->fp);
+
+        if(written != buffer->size){
+            save->failed = 1;
+        }
+
+        INSTRUMENT_COUNT(INSTRUMENT_BYTES_WRITTEN, written);
+
+        pthread_mutex_lock(&save->lock);
+        save->bytes += written;
+        buffer->full = 0;
+        pthread_cond_broadcast(&save->changed);
+        pthread_mutex_unlock(&save->lock);
+
+        current = !current;
+    }
+
+    if(fclose(save->fp) != 0){
+        save->failed = 1;
+    }
+
+    pthread_mutex_lock(&save->lock);
+    save->done = 1;
+    pthread_mutex_unlock(&save->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief This function starts saving a matrix in the background, in the same format as sparse_matrix_binary_save. The state of the matrix at the call is taken with a copy-on-write clone, so the caller can keep changing the matrix while the file is written (the rows it changes are copied). One thread serializes the clone into a buffer while another writes the other buffer to the file.
+ *
+ * @brief Time Complexity: O(r + c) for the caller, because only the clone is made before the threads start
+ *
+ * @param matrix
+ * The matrix that will be saved
+ * @param path
+ * The path of the file that will be created
+ * @return Sparse_Matrix_Save*
+ * The handle of the save, to be polled or waited on
+ */
+Sparse_Matrix_Save *sparse_matrix_save_async(Sparse_Matrix *matrix, const char *path){
+    FILE *fp = fopen(path, "wb");
+
+    if(!fp){
+        printf("\033[91mError: Couldn't create the file!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix_Save *save = (Sparse_Matrix_Save *)calloc(1, sizeof(Sparse_Matrix_Save));
+
+    save->snapshot = sparse_matrix_clone(matrix);
+    save->fp = fp;
+    save->buffers[0].data = (unsigned char *)malloc(CHECKPOINT_BUFFER_BYTES);
+    save->buffers[1].data = (unsigned char *)malloc(CHECKPOINT_BUFFER_BYTES);
+
+    pthread_mutex_init(&save->lock, NULL);
+    pthread_cond_init(&save->changed, NULL);
+
+    if(pthread_create(&save->serializer, NULL, _checkpoint_serialize, save) || pthread_create(&save->writer, NULL, _checkpoint_write, save)){
+        printf("\033[91mError: Couldn't start the save thread!\n\033[0m");
+        exit(1);
+    }
+
+    return save;
+}
+
+/**
+ * @brief This function tells if a background save finished, without waiting.
+ *
+ * @brief Time Complexity: O(1), because only a flag is read
+ *
+ * @param save
+ * The handle of the save
+ * @return int
+ * 1 if the file is complete or 0 if it's still being written
+ */
+int sparse_matrix_save_poll(Sparse_Matrix_Save *save){
+    pthread_mutex_lock(&save->lock);
+
+    int done = save->done;
+
+    pthread_mutex_unlock(&save->lock);
+
+    return done;
+}
+
+/**
+ * @brief This function waits for a background save to finish and frees its handle and its clone. It must be called once for every save, even after a poll says it's finished.
+ *
+ * @brief Time Complexity: O(r), because the clone is released (plus the wait for the threads)
+ *
+ * @param save
+ * The handle of the save
+ * @return long
+ * The number of bytes written, or -1 if a write failed
+ */
+long sparse_matrix_save_wait(Sparse_Matrix_Save *save){
+    pthread_join(save->serializer, NULL);
+    pthread_join(save->writer, NULL);
+
+    long bytes = save->failed ? -1 : save->bytes;
+
+    //The clone is released here, on the thread that owns the matrix, because it changes the shared row counters
+    sparse_matrix_destroy(save->snapshot);
+    free(save->buffers[0].data);
+    free(save->buffers[1].data);
+    pthread_mutex_destroy(&save->lock);
+    pthread_cond_destroy(&save->changed);
+    free(save);
+
+    return bytes;
+}
@@ -0,0 +1,17 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "matrix.h"
+
+typedef struct Sparse_Matrix_Save Sparse_Matrix_Save;
+
+//Size of each of the two buffers that the serializer fills while the other one is written
+#define CHECKPOINT_BUFFER_BYTES (1 << 20)
+
+//File functions
+
+Sparse_Matrix_Save *sparse_matrix_save_async(Sparse_Matrix *matrix, const char *path);
+int sparse_matrix_save_poll(Sparse_Matrix_Save *save);
+long sparse_matrix_save_wait(Sparse_Matrix_Save *save);
+
+#endif
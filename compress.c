@@ -0,0 +1,345 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compress.h"
+#include "instrument.h"
+
+//Flags of the file header
+#define COMPRESSED_FORMAT_VERSION 1
+#define COMPRESSED_SHUFFLED 1
+
+typedef struct Compressed_Header{
+    int magic, formatVersion;
+    int numberRows, numberColumns, numberNonNull;
+    int flags;
+} Compressed_Header;
+
+typedef struct Compressed_Block_Header{
+    int firstRow, numberRows, numberValues, indexBytes;
+} Compressed_Block_Header;
+
+/**
+ * @brief This function appends an unsigned value to a buffer as a varint: 7 bits per byte, the high bit set in every byte but the last.
+ *
+ * @brief Time Complexity: O(1), because an int takes at most 5 bytes
+ *
+ * @param buffer
+ * The buffer that receives the bytes (with room for 5 more)
+ * @param value
+ * The value that will be encoded
+ * @return unsigned char*
+ * The position after the bytes written
+ */
+static unsigned char *_compressed_put_varint(unsigned char *buffer, unsigned int value){
+    while(value >= 0x80){
+        *buffer++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+
+    *buffer++ = (unsigned char)value;
+
+    return buffer;
+}
+
+/**
+ * @brief This function reads a varint from a buffer.
+ *
+ * @brief Time Complexity: O(1), because an int takes at most 5 bytes
+ *
+ * @param buffer
+ * Points to the first byte; it's moved past the value
+ * @param end
+ * The end of the buffer
+ * @param value
+ * Receives the value
+ * @return int
+ * 1 if the value was read or 0 if the buffer ended before it
+ */
+static int _compressed_get_varint(const unsigned char **buffer, const unsigned char *end, unsigned int *value){
+    unsigned int result = 0;
+    int shift = 0;
+
+    while(*buffer < end && shift < 35){
+        unsigned char byte = *(*buffer)++;
+
+        result |= (unsigned int)(byte & 0x7F) << shift;
+
+        if(!(byte & 0x80)){
+            *value = result;
+            return 1;
+        }
+
+        shift += 7;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief This function writes a block: its header, the index stream (the number of values of each row, then the column gaps, as varints) and the values, byte-shuffled if asked. Shuffling puts the first byte of every value together, then the second byte and so on, which groups the signs and exponents for later compression.
+ *
+ * @brief Time Complexity: O(k), where k is the number of values of the block
+ *
+ * @return size_t
+ * The number of bytes written
+ */
+static size_t _compressed_write_block(FILE *fp, Compressed_Block_Header *block, const unsigned char *lengths, size_t lengthBytes, const unsigned char *columns, size_t columnBytes, const matrix_value_type *values, unsigned char *scratch, int shuffleValues){
+    size_t valueBytes = (size_t)block->numberValues * sizeof(matrix_value_type);
+
+    block->indexBytes = (int)(lengthBytes + columnBytes);
+
+    size_t bytes = fwrite(block, 1, sizeof(Compressed_Block_Header), fp);
+
+    bytes += fwrite(lengths, 1, lengthBytes, fp);
+    bytes += fwrite(columns, 1, columnBytes, fp);
+
+    if(!shuffleValues){
+        return bytes + fwrite(values, 1, valueBytes, fp);
+    }
+
+    const unsigned char *raw = (const unsigned char *)values;
+
+    for(int b = 0; b < (int)sizeof(matrix_value_type); b++){
+        for(int k = 0; k < block->numberValues; k++){
+            scratch[(size_t)b * block->numberValues + k] = raw[(size_t)k * sizeof(matrix_value_type) + b];
+        }
+    }
+
+    return bytes + fwrite(scratch, 1, valueBytes, fp);
+}
+
+/**
+ * @brief This function saves a matrix in the compressed format. The rows are grouped in blocks of up to COMPRESSED_BLOCK_ROWS rows and COMPRESSED_BLOCK_VALUES values; each block stores the row lengths (the differences of the row pointers) and, for each row, the first column and the gaps between the sorted columns, all as varints, followed by the raw values. A typical value takes about 5 bytes instead of the 12 of sparse_matrix_binary_save, and each block is written with a few large writes.
+ *
+ * @brief Time Complexity: O(n + r), because each row and each value is encoded once
+ *
+ * @param matrix
+ * The matrix that will be saved
+ * @param path
+ * The path of the file that will be created
+ * @param shuffleValues
+ * 1 to store the values byte-shuffled or 0 to store them as they are
+ */
+void sparse_matrix_compressed_save(Sparse_Matrix *matrix, const char *path, int shuffleValues){
+    INSTRUMENT_BEGIN();
+
+    FILE *fp = fopen(path, "wb");
+
+    if(!fp){
+        printf("\033[91mError: Couldn't create the file!\n\033[0m");
+        exit(1);
+    }
+
+    Compressed_Header header = {COMPRESSED_MAGIC, COMPRESSED_FORMAT_VERSION, sparse_matrix_number_rows(matrix), sparse_matrix_number_columns(matrix), sparse_matrix_number_non_null(matrix), shuffleValues ? COMPRESSED_SHUFFLED : 0};
+    size_t bytes = fwrite(&header, 1, sizeof(Compressed_Header), fp);
+
+    //A row may be longer than a block, so the buffers grow with the longest row
+    int capacity = COMPRESSED_BLOCK_VALUES;
+    unsigned char *lengths = (unsigned char *)malloc(5 * COMPRESSED_BLOCK_ROWS);
+    unsigned char *columns = (unsigned char *)malloc(5 * (size_t)capacity);
+    matrix_value_type *values = (matrix_value_type *)malloc(capacity * sizeof(matrix_value_type));
+    unsigned char *scratch = (unsigned char *)malloc(capacity * sizeof(matrix_value_type));
+
+    Compressed_Block_Header block = {0, 0, 0, 0};
+    unsigned char *lengthsEnd = lengths;
+    unsigned char *columnsEnd = columns;
+
+    for(int i = 0; i <= header.numberRows; i++){
+        int length = 0;
+        Sparse_Matrix_Cursor cursor;
+
+        if(i < header.numberRows){
+            cursor = sparse_matrix_row_cursor(matrix, i);
+
+            while(sparse_matrix_cursor_next(&cursor)){
+                length++;
+            }
+        }
+
+        //The block is closed before the row that would overflow it, and after the last row
+        if(block.numberRows > 0 && (i == header.numberRows || block.numberRows == COMPRESSED_BLOCK_ROWS || block.numberValues + length > COMPRESSED_BLOCK_VALUES)){
+            bytes += _compressed_write_block(fp, &block, lengths, lengthsEnd - lengths, columns, columnsEnd - columns, values, scratch, shuffleValues);
+
+            block.firstRow = i;
+            block.numberRows = 0;
+            block.numberValues = 0;
+            lengthsEnd = lengths;
+            columnsEnd = columns;
+        }
+
+        if(i == header.numberRows){
+            break;
+        }
+
+        if(block.numberValues + length > capacity){
+            size_t used = columnsEnd - columns;
+
+            capacity = block.numberValues + length;
+            columns = (unsigned char *)realloc(columns, 5 * (size_t)capacity);
+            values = (matrix_value_type *)realloc(values, capacity * sizeof(matrix_value_type));
+            scratch = (unsigned char *)realloc(scratch, capacity * sizeof(matrix_value_type));
+            columnsEnd = columns + used;
+        }
+
+        lengthsEnd = _compressed_put_varint(lengthsEnd, length);
+
+        int previous = -1;
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            columnsEnd = _compressed_put_varint(columnsEnd, cursor.column - previous - 1);
+            values[block.numberValues++] = cursor.value;
+            previous = cursor.column;
+        }
+
+        block.numberRows++;
+    }
+
+    fclose(fp);
+    free(lengths);
+    free(columns);
+    free(values);
+    free(scratch);
+
+    INSTRUMENT_COUNT(INSTRUMENT_BYTES_WRITTEN, bytes);
+
+    INSTRUMENT_END(INSTRUMENT_OP_COMPRESSED_SAVE);
+}
+
+/**
+ * @brief This function stops the program when a compressed file is damaged.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static void _compressed_corrupted(){
+    printf("\033[91mError: The compressed file is corrupted!\n\033[0m");
+    exit(1);
+}
+
+/**
+ * @brief This function creates a sparse matrix from a file saved by sparse_matrix_compressed_save. Each block is read with one call and decoded in memory, and the values are linked with the builder, so the load is linear.
+ *
+ * @brief Time Complexity: O(n + r + c), because each value is decoded and linked once
+ *
+ * @param path
+ * The path to the compressed file
+ * @return Sparse_Matrix*
+ * The new matrix created
+ */
+Sparse_Matrix *sparse_matrix_compressed_read(const char *path){
+    INSTRUMENT_BEGIN();
+
+    FILE *fp = fopen(path, "rb");
+
+    if(!fp){
+        printf("\033[91mError: Couldn't open the file!\n\033[0m");
+        exit(1);
+    }
+
+    Compressed_Header header;
+    size_t bytes = fread(&header, 1, sizeof(Compressed_Header), fp);
+
+    if(bytes != sizeof(Compressed_Header) || header.magic != COMPRESSED_MAGIC || header.formatVersion != COMPRESSED_FORMAT_VERSION || header.numberRows < 0 || header.numberColumns < 0){
+        _compressed_corrupted();
+    }
+
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(header.numberRows, header.numberColumns);
+    size_t capacity = 0;
+    unsigned char *payload = NULL;
+    matrix_value_type *values = NULL;
+    int row = 0;
+    int total = 0;
+
+    while(row < header.numberRows){
+        Compressed_Block_Header block;
+
+        if(fread(&block, 1, sizeof(Compressed_Block_Header), fp) != sizeof(Compressed_Block_Header)){
+            _compressed_corrupted();
+        }
+
+        bytes += sizeof(Compressed_Block_Header);
+
+        if(block.firstRow != row || block.numberRows <= 0 || block.numberValues < 0 || block.indexBytes < 0 || row + block.numberRows > header.numberRows){
+            _compressed_corrupted();
+        }
+
+        size_t valueBytes = (size_t)block.numberValues * sizeof(matrix_value_type);
+        size_t size = block.indexBytes + valueBytes;
+
+        if(size > capacity){
+            capacity = size;
+            payload = (unsigned char *)realloc(payload, capacity);
+            values = (matrix_value_type *)realloc(values, capacity);
+        }
+
+        if(fread(payload, 1, size, fp) != size){
+            _compressed_corrupted();
+        }
+
+        bytes += size;
+
+        unsigned char *raw = payload + block.indexBytes;
+
+        if(header.flags & COMPRESSED_SHUFFLED){
+            unsigned char *output = (unsigned char *)values;
+
+            for(int b = 0; b < (int)sizeof(matrix_value_type); b++){
+                for(int k = 0; k < block.numberValues; k++){
+                    output[(size_t)k * sizeof(matrix_value_type) + b] = raw[(size_t)b * block.numberValues + k];
+                }
+            }
+        }
+
+        else{
+            memcpy(values, raw, valueBytes);
+        }
+
+        //The lengths of all rows of the block come first, then the columns
+        const unsigned char *lengths = payload;
+        const unsigned char *end = payload + block.indexBytes;
+        const unsigned char *columns = payload;
+        unsigned int length, gap;
+
+        for(int i = 0; i < block.numberRows; i++){
+            if(!_compressed_get_varint(&columns, end, &length)){
+                _compressed_corrupted();
+            }
+        }
+
+        int position = 0;
+
+        for(int i = 0; i < block.numberRows; i++, row++){
+            int column = -1;
+
+            _compressed_get_varint(&lengths, end, &length);
+
+            if(position + (long)length > block.numberValues){
+                _compressed_corrupted();
+            }
+
+            for(unsigned int k = 0; k < length; k++){
+                if(!_compressed_get_varint(&columns, end, &gap) || column + 1 + (long)gap >= header.numberColumns){
+                    _compressed_corrupted();
+                }
+
+                column += gap + 1;
+                sparse_matrix_builder_append(builder, values[position++], row, column);
+            }
+        }
+
+        total += position;
+    }
+
+    fclose(fp);
+    free(payload);
+    free(values);
+
+    if(total != header.numberNonNull){
+        _compressed_corrupted();
+    }
+
+    INSTRUMENT_COUNT(INSTRUMENT_BYTES_READ, bytes);
+
+    INSTRUMENT_END(INSTRUMENT_OP_COMPRESSED_READ);
+    return sparse_matrix_builder_finish(builder);
+}
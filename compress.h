@@ -0,0 +1,17 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include "matrix.h"
+
+//First int of a compressed file; it's negative, so it can't be confused with the number of values of the plain format
+#define COMPRESSED_MAGIC ((int)0x8D5A4331)
+//Maximum number of rows and of values in a block, the unit that is read and decoded at once
+#define COMPRESSED_BLOCK_ROWS 4096
+#define COMPRESSED_BLOCK_VALUES 65536
+
+//File functions
+
+void sparse_matrix_compressed_save(Sparse_Matrix *matrix, const char *path, int shuffleValues);
+Sparse_Matrix *sparse_matrix_compressed_read(const char *path);
+
+#endif
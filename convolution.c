@@ -0,0 +1,486 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <complex.h>
+#include "convolution.h"
+
+typedef struct Convolution_Tap{
+    int rowOffset, columnOffset;
+    matrix_value_type value;
+} Convolution_Tap;
+
+typedef struct Convolution_Plan{
+    int numberTaps;
+    Convolution_Tap *taps;
+    int numberRows, numberColumns;
+    int firstRow, firstColumn;
+    matrix_value_type *output;
+} Convolution_Plan;
+
+/**
+ * @brief This function returns the options of sparse_matrix_convolution: stride 1, no dilation and zero padding, with one output per input position, the method picked by the cost model and no drop tolerance.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @return Convolution_Options
+ * The default options
+ */
+Convolution_Options convolution_options_default(){
+    Convolution_Options options = {1, 1, 1, 1, CONVOLUTION_PADDING_ZERO, CONVOLUTION_METHOD_AUTO, 0};
+
+    return options;
+}
+
+/**
+ * @brief This function checks the options and computes the size of the output of one kernel and the input position of its first output (the position under the center of the kernel). With zero or reflect padding there is one output every stride positions of the input; with valid padding only the positions where the whole dilated kernel fits are computed.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static void _convolution_geometry(Sparse_Matrix *matrix, Sparse_Matrix *kernel, Convolution_Options options, int *numberRows, int *numberColumns, int *firstRow, int *firstColumn){
+    int rows = sparse_matrix_number_rows(matrix);
+    int columns = sparse_matrix_number_columns(matrix);
+    int kernelRows = sparse_matrix_number_rows(kernel);
+    int kernelColumns = sparse_matrix_number_columns(kernel);
+
+    if(options.strideRow < 1 || options.strideColumn < 1 || options.dilationRow < 1 || options.dilationColumn < 1){
+        printf("\033[91mError: Invalid convolution options!\n\033[0m");
+        exit(1);
+    }
+
+    //Distance from the center of the dilated kernel to its first and last taps
+    int top = (kernelRows / 2) * options.dilationRow;
+    int bottom = (kernelRows - 1 - kernelRows / 2) * options.dilationRow;
+    int left = (kernelColumns / 2) * options.dilationColumn;
+    int right = (kernelColumns - 1 - kernelColumns / 2) * options.dilationColumn;
+
+    if(options.padding == CONVOLUTION_PADDING_VALID){
+        if(top + bottom >= rows || left + right >= columns){
+            printf("\033[91mError: The kernel is larger than the matrix!\n\033[0m");
+            exit(1);
+        }
+
+        *firstRow = top;
+        *firstColumn = left;
+        *numberRows = (rows - top - bottom - 1) / options.strideRow + 1;
+        *numberColumns = (columns - left - right - 1) / options.strideColumn + 1;
+        return;
+    }
+
+    //A mirror of the border must stay inside the matrix
+    if(options.padding == CONVOLUTION_PADDING_REFLECT && (top >= rows || bottom >= rows || left >= columns || right >= columns)){
+        printf("\033[91mError: The kernel is too large to reflect the borders!\n\033[0m");
+        exit(1);
+    }
+
+    *firstRow = 0;
+    *firstColumn = 0;
+    *numberRows = (rows - 1) / options.strideRow + 1;
+    *numberColumns = (columns - 1) / options.strideColumn + 1;
+}
+
+/**
+ * @brief This function computes the size of the output of a kernel for the given options.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @param matrix
+ * The input matrix
+ * @param kernel
+ * The kernel
+ * @param options
+ * The stride, dilation and padding
+ * @param numberRows
+ * Receives the number of rows of the output
+ * @param numberColumns
+ * Receives the number of columns of the output
+ */
+void convolution_output_size(Sparse_Matrix *matrix, Sparse_Matrix *kernel, Convolution_Options options, int *numberRows, int *numberColumns){
+    int firstRow, firstColumn;
+
+    _convolution_geometry(matrix, kernel, options, numberRows, numberColumns, &firstRow, &firstColumn);
+}
+
+/**
+ * @brief This function adds the contribution of one input value, placed at a (possibly virtual) position, to the outputs of every kernel. An output at center (ci, cj) reads the input at (ci + rowOffset, cj + columnOffset) for each tap, so the value reaches the centers (row - rowOffset, column - columnOffset) that fall on the stride grid.
+ *
+ * @brief Time Complexity: O(t), where t is the number of taps of all kernels
+ */
+static void _convolution_scatter(Convolution_Plan *plans, int numberKernels, Convolution_Options options, int row, int column, matrix_value_type value){
+    for(int q = 0; q < numberKernels; q++){
+        Convolution_Plan *plan = &plans[q];
+
+        for(int t = 0; t < plan->numberTaps; t++){
+            int centerRow = row - plan->taps[t].rowOffset - plan->firstRow;
+            int centerColumn = column - plan->taps[t].columnOffset - plan->firstColumn;
+
+            if(centerRow < 0 || centerColumn < 0 || centerRow % options.strideRow || centerColumn % options.strideColumn){
+                continue;
+            }
+
+            centerRow /= options.strideRow;
+            centerColumn /= options.strideColumn;
+
+            if(centerRow < plan->numberRows && centerColumn < plan->numberColumns){
+                plan->output[(size_t)centerRow * plan->numberColumns + centerColumn] += value * plan->taps[t].value;
+            }
+        }
+    }
+}
+
+/**
+ * @brief This function lists the positions where an input index is read: the index itself and, with reflect padding, its mirrors past the borders that some kernel reaches.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @return int
+ * The number of positions (1 to 3)
+ */
+static int _convolution_mirrors(int index, int size, int before, int after, Convolution_Padding padding, int *positions){
+    int count = 0;
+
+    positions[count++] = index;
+
+    if(padding != CONVOLUTION_PADDING_REFLECT){
+        return count;
+    }
+
+    if(index > 0 && index <= before){
+        positions[count++] = -index;
+    }
+
+    if(index < size - 1 && 2 * (size - 1) - index <= size - 1 + after){
+        positions[count++] = 2 * (size - 1) - index;
+    }
+
+    return count;
+}
+
+/**
+ * @brief This function estimates both paths and picks the cheaper one. The direct path does one multiply-add per non-null value of the matrix and per non-null tap; the FFT path transforms the padded matrix once and, for each kernel, the kernel and the product back, each transform costing about CONVOLUTION_FFT_COST direct multiply-adds per point and per level (measured on a 256x256 input with a 31x31 kernel). Transforms larger than CONVOLUTION_FFT_MAX_POINTS always go direct.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static Convolution_Method _convolution_cost_choose(int rows, int columns, int numberNonNull, long long numberTaps, int numberKernels, int extentRows, int extentColumns){
+    int fftRows = 1, fftColumns = 1;
+
+    while(fftRows < rows + extentRows){
+        fftRows <<= 1;
+    }
+
+    while(fftColumns < columns + extentColumns){
+        fftColumns <<= 1;
+    }
+
+    double points = (double)fftRows * fftColumns;
+
+    if(points > CONVOLUTION_FFT_MAX_POINTS){
+        return CONVOLUTION_METHOD_DIRECT;
+    }
+
+    double directCost = (double)numberNonNull * numberTaps;
+    double fftCost = CONVOLUTION_FFT_COST * points * log2(points) * (1 + 2.0 * numberKernels) + points * numberKernels;
+
+    return fftCost < directCost ? CONVOLUTION_METHOD_FFT : CONVOLUTION_METHOD_DIRECT;
+}
+
+/**
+ * @brief This function tells which method sparse_matrix_convolution_bank uses with CONVOLUTION_METHOD_AUTO. Small or very sparse kernels and sparse inputs go direct, while large dense kernels over dense inputs go through the FFT.
+ *
+ * @brief Time Complexity: O(k), where k is the number of kernels
+ *
+ * @param matrix
+ * The input matrix
+ * @param kernels
+ * The kernels
+ * @param numberKernels
+ * The number of kernels
+ * @param options
+ * The options of the convolution (the method is ignored)
+ * @return Convolution_Method
+ * CONVOLUTION_METHOD_DIRECT or CONVOLUTION_METHOD_FFT
+ */
+Convolution_Method convolution_choose_method(Sparse_Matrix *matrix, Sparse_Matrix **kernels, int numberKernels, Convolution_Options options){
+    long long numberTaps = 0;
+    int extentRows = 0, extentColumns = 0;
+
+    for(int q = 0; q < numberKernels; q++){
+        int rows = (sparse_matrix_number_rows(kernels[q]) - 1) * options.dilationRow;
+        int columns = (sparse_matrix_number_columns(kernels[q]) - 1) * options.dilationColumn;
+
+        numberTaps += sparse_matrix_number_non_null(kernels[q]);
+        extentRows = rows > extentRows ? rows : extentRows;
+        extentColumns = columns > extentColumns ? columns : extentColumns;
+    }
+
+    return _convolution_cost_choose(sparse_matrix_number_rows(matrix), sparse_matrix_number_columns(matrix), sparse_matrix_number_non_null(matrix), numberTaps, numberKernels, extentRows, extentColumns);
+}
+
+/**
+ * @brief This function scatters each non-null value of the matrix (and its mirrors) through the taps of every kernel.
+ *
+ * @brief Time Complexity: O(n*t), where n is the number of non-null values of the matrix and t is the total number of non-null taps
+ */
+static void _convolution_direct(Sparse_Matrix *matrix, Convolution_Plan *plans, int numberKernels, Convolution_Options options, int before, int after, int left, int right){
+    int rows = sparse_matrix_number_rows(matrix);
+    int columns = sparse_matrix_number_columns(matrix);
+    int mirrorRows[3], mirrorColumns[3];
+
+    for(int i = 0; i < rows; i++){
+        Sparse_Matrix_Cursor cursor = sparse_matrix_row_cursor(matrix, i);
+        int numberMirrorRows = _convolution_mirrors(i, rows, before, after, options.padding, mirrorRows);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            int numberMirrorColumns = _convolution_mirrors(cursor.column, columns, left, right, options.padding, mirrorColumns);
+
+            for(int a = 0; a < numberMirrorRows; a++){
+                for(int b = 0; b < numberMirrorColumns; b++){
+                    _convolution_scatter(plans, numberKernels, options, mirrorRows[a], mirrorColumns[b], cursor.value);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief This function makes an in-place radix-2 FFT of size power of two (the inverse is not scaled).
+ *
+ * @brief Time Complexity: O(n*log(n))
+ */
+static void _convolution_fft_1d(double complex *values, int size, int inverse){
+    for(int i = 1, j = 0; i < size; i++){
+        int bit = size >> 1;
+
+        for(; j & bit; bit >>= 1){
+            j ^= bit;
+        }
+
+        j ^= bit;
+
+        if(i < j){
+            double complex swap = values[i];
+            values[i] = values[j];
+            values[j] = swap;
+        }
+    }
+
+    for(int length = 2; length <= size; length <<= 1){
+        double angle = (inverse ? 2 : -2) * M_PI / length;
+        double complex step = cos(angle) + I * sin(angle);
+
+        for(int i = 0; i < size; i += length){
+            double complex twiddle = 1;
+
+            for(int k = 0; k < length / 2; k++){
+                double complex even = values[i + k];
+                double complex odd = values[i + k + length / 2] * twiddle;
+
+                values[i + k] = even + odd;
+                values[i + k + length / 2] = even - odd;
+                twiddle *= step;
+            }
+        }
+    }
+}
+
+/**
+ * @brief This function makes the 2D FFT of a row-major grid: every row and then every column (copied to a contiguous buffer).
+ *
+ * @brief Time Complexity: O(r*c*log(r*c))
+ */
+static void _convolution_fft_2d(double complex *grid, int rows, int columns, int inverse, double complex *buffer){
+    for(int i = 0; i < rows; i++){
+        _convolution_fft_1d(&grid[(size_t)i * columns], columns, inverse);
+    }
+
+    for(int j = 0; j < columns; j++){
+        for(int i = 0; i < rows; i++){
+            buffer[i] = grid[(size_t)i * columns + j];
+        }
+
+        _convolution_fft_1d(buffer, rows, inverse);
+
+        for(int i = 0; i < rows; i++){
+            grid[(size_t)i * columns + j] = buffer[i];
+        }
+    }
+}
+
+/**
+ * @brief This function computes the outputs through the FFT. The matrix is padded by the reach of the taps (zeros, or mirrors with reflect padding) and transformed once; each kernel is flipped into a grid of the same size, so the circular convolution equals the correlation at every output position, and the product is transformed back and sampled at the strided centers. Rounding noise, measured against the norms of the operands, is dropped so that the outputs stay sparse.
+ *
+ * @brief Time Complexity: O(k*p*log(p)), where k is the number of kernels and p is the size of the padded grid
+ */
+static void _convolution_fft(Sparse_Matrix *matrix, Convolution_Plan *plans, int numberKernels, Convolution_Options options, int before, int after, int left, int right){
+    int rows = sparse_matrix_number_rows(matrix);
+    int columns = sparse_matrix_number_columns(matrix);
+    int fftRows = 1, fftColumns = 1;
+
+    while(fftRows < rows + before + after){
+        fftRows <<= 1;
+    }
+
+    while(fftColumns < columns + left + right){
+        fftColumns <<= 1;
+    }
+
+    size_t points = (size_t)fftRows * fftColumns;
+    double complex *input = (double complex *)calloc(points, sizeof(double complex));
+    double complex *grid = (double complex *)malloc(points * sizeof(double complex));
+    double complex *buffer = (double complex *)malloc((fftRows > fftColumns ? fftRows : fftColumns) * sizeof(double complex));
+    int mirrorRows[3], mirrorColumns[3];
+    double inputNorm = 0;
+
+    //The padded matrix: the value at (h, k) goes to (h + before, k + left)
+    for(int i = 0; i < rows; i++){
+        Sparse_Matrix_Cursor cursor = sparse_matrix_row_cursor(matrix, i);
+        int numberMirrorRows = _convolution_mirrors(i, rows, before, after, options.padding, mirrorRows);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            int numberMirrorColumns = _convolution_mirrors(cursor.column, columns, left, right, options.padding, mirrorColumns);
+
+            for(int a = 0; a < numberMirrorRows; a++){
+                for(int b = 0; b < numberMirrorColumns; b++){
+                    input[(size_t)(mirrorRows[a] + before) * fftColumns + mirrorColumns[b] + left] = cursor.value;
+                    inputNorm += fabs(cursor.value);
+                }
+            }
+        }
+    }
+
+    _convolution_fft_2d(input, fftRows, fftColumns, 0, buffer);
+
+    for(int q = 0; q < numberKernels; q++){
+        Convolution_Plan *plan = &plans[q];
+        double kernelNorm = 0;
+
+        //The flipped kernel: the tap at offset (o, p) goes to (after - o, right - p)
+        for(size_t i = 0; i < points; i++){
+            grid[i] = 0;
+        }
+
+        for(int t = 0; t < plan->numberTaps; t++){
+            grid[(size_t)(after - plan->taps[t].rowOffset) * fftColumns + right - plan->taps[t].columnOffset] += plan->taps[t].value;
+            kernelNorm += fabs(plan->taps[t].value);
+        }
+
+        _convolution_fft_2d(grid, fftRows, fftColumns, 0, buffer);
+
+        for(size_t i = 0; i < points; i++){
+            grid[i] *= input[i];
+        }
+
+        _convolution_fft_2d(grid, fftRows, fftColumns, 1, buffer);
+
+        //The output at center (ci, cj) is at (ci + before + after, cj + left + right)
+        double tolerance = 8 * DBL_EPSILON * log2((double)points) * inputNorm * kernelNorm;
+
+        for(int i = 0; i < plan->numberRows; i++){
+            int row = plan->firstRow + i * options.strideRow + before + after;
+
+            for(int j = 0; j < plan->numberColumns; j++){
+                int column = plan->firstColumn + j * options.strideColumn + left + right;
+                double value = creal(grid[(size_t)row * fftColumns + column]) / points;
+
+                plan->output[(size_t)i * plan->numberColumns + j] = fabs(value) > tolerance ? value : 0;
+            }
+        }
+    }
+
+    free(input);
+    free(grid);
+    free(buffer);
+}
+
+/**
+ * @brief This function convolves a matrix with a bank of kernels. The direct method makes a unique pass over the non-null values of the matrix: each value is scattered to the outputs of every kernel through the non-null taps of the kernels, so the cost follows the non-null values of the input and of the kernels and not the size of the outputs. The FFT method transforms the padded matrix once and multiplies it by each transformed kernel, which is cheaper for large dense kernels; CONVOLUTION_METHOD_AUTO picks one with convolution_choose_method. As in sparse_matrix_convolution, the kernel is not flipped and its center is at (rows / 2, columns / 2). The stride skips outputs instead of computing and dropping them, the dilation spreads the taps, and the padding is zero, valid (no padding, smaller output) or reflect (the borders are mirrored without repeating the edge). Nothing is printed.
+ *
+ * @brief Time Complexity: O(n*t + o) direct or O(k*p*log(p) + o) with the FFT, where n is the number of non-null values of the matrix, t is the total number of non-null taps of the kernels, k is the number of kernels, p is the size of the padded matrix and o is the total size of the outputs
+ *
+ * @param matrix
+ * The input matrix
+ * @param kernels
+ * The kernels (they may have different sizes)
+ * @param numberKernels
+ * The number of kernels
+ * @param options
+ * The stride, dilation, padding, method and drop tolerance (the outputs smaller in absolute value are not stored), shared by all kernels
+ * @param results
+ * Receives one new matrix per kernel
+ */
+void sparse_matrix_convolution_bank(Sparse_Matrix *matrix, Sparse_Matrix **kernels, int numberKernels, Convolution_Options options, Sparse_Matrix **results){
+    Convolution_Plan *plans = (Convolution_Plan *)calloc(numberKernels, sizeof(Convolution_Plan));
+    int before = 0, after = 0, left = 0, right = 0;
+
+    for(int q = 0; q < numberKernels; q++){
+        Convolution_Plan *plan = &plans[q];
+        Sparse_Matrix *kernel = kernels[q];
+        int centerRow = sparse_matrix_number_rows(kernel) / 2;
+        int centerColumn = sparse_matrix_number_columns(kernel) / 2;
+
+        _convolution_geometry(matrix, kernel, options, &plan->numberRows, &plan->numberColumns, &plan->firstRow, &plan->firstColumn);
+
+        plan->taps = (Convolution_Tap *)malloc((sparse_matrix_number_non_null(kernel) + 1) * sizeof(Convolution_Tap));
+        plan->output = (matrix_value_type *)calloc((size_t)plan->numberRows * plan->numberColumns, sizeof(matrix_value_type));
+
+        for(int a = 0; a < sparse_matrix_number_rows(kernel); a++){
+            Sparse_Matrix_Cursor cursor = sparse_matrix_row_cursor(kernel, a);
+
+            while(sparse_matrix_cursor_next(&cursor)){
+                Convolution_Tap *tap = &plan->taps[plan->numberTaps++];
+
+                tap->rowOffset = (cursor.row - centerRow) * options.dilationRow;
+                tap->columnOffset = (cursor.column - centerColumn) * options.dilationColumn;
+                tap->value = cursor.value;
+
+                //How far past each border some tap reads
+                before = -tap->rowOffset > before ? -tap->rowOffset : before;
+                after = tap->rowOffset > after ? tap->rowOffset : after;
+                left = -tap->columnOffset > left ? -tap->columnOffset : left;
+                right = tap->columnOffset > right ? tap->columnOffset : right;
+            }
+        }
+    }
+
+    Convolution_Method method = options.method;
+
+    if(method == CONVOLUTION_METHOD_AUTO){
+        long long numberTaps = 0;
+
+        for(int q = 0; q < numberKernels; q++){
+            numberTaps += plans[q].numberTaps;
+        }
+
+        method = _convolution_cost_choose(sparse_matrix_number_rows(matrix), sparse_matrix_number_columns(matrix), sparse_matrix_number_non_null(matrix), numberTaps, numberKernels, before + after, left + right);
+    }
+
+    if(method == CONVOLUTION_METHOD_FFT){
+        _convolution_fft(matrix, plans, numberKernels, options, before, after, left, right);
+    }
+
+    else{
+        _convolution_direct(matrix, plans, numberKernels, options, before, after, left, right);
+    }
+
+    for(int q = 0; q < numberKernels; q++){
+        Convolution_Plan *plan = &plans[q];
+        Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(plan->numberRows, plan->numberColumns);
+
+        for(int i = 0; i < plan->numberRows; i++){
+            for(int j = 0; j < plan->numberColumns; j++){
+                matrix_value_type value = plan->output[(size_t)i * plan->numberColumns + j];
+
+                if(fabsf(value) >= options.dropTolerance){
+                    sparse_matrix_builder_append(builder, value, i, j);
+                }
+            }
+        }
+
+        results[q] = sparse_matrix_builder_finish(builder);
+
+        free(plan->taps);
+        free(plan->output);
+    }
+
+    free(plans);
+}
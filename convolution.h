@@ -0,0 +1,39 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include "matrix.h"
+
+#define CONVOLUTION_FFT_COST 1
+#define CONVOLUTION_FFT_MAX_POINTS (1 << 24)
+
+typedef enum{
+    CONVOLUTION_PADDING_ZERO,
+    CONVOLUTION_PADDING_VALID,
+    CONVOLUTION_PADDING_REFLECT
+} Convolution_Padding;
+
+typedef enum{
+    CONVOLUTION_METHOD_AUTO,
+    CONVOLUTION_METHOD_DIRECT,
+    CONVOLUTION_METHOD_FFT
+} Convolution_Method;
+
+typedef struct Convolution_Options{
+    int strideRow, strideColumn;
+    int dilationRow, dilationColumn;
+    Convolution_Padding padding;
+    Convolution_Method method;
+    matrix_value_type dropTolerance;
+} Convolution_Options;
+
+//Options functions
+
+Convolution_Options convolution_options_default();
+void convolution_output_size(Sparse_Matrix *matrix, Sparse_Matrix *kernel, Convolution_Options options, int *numberRows, int *numberColumns);
+Convolution_Method convolution_choose_method(Sparse_Matrix *matrix, Sparse_Matrix **kernels, int numberKernels, Convolution_Options options);
+
+//Operation functions with matrices
+
+void sparse_matrix_convolution_bank(Sparse_Matrix *matrix, Sparse_Matrix **kernels, int numberKernels, Convolution_Options options, Sparse_Matrix **results);
+
+#endif
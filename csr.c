@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "cell.h"
+#include "csr.h"
+
+typedef struct Csr_Matrix{
+    int numberRows, numberColumns, numberNonNull;
+    int symmetric;
+    int *rowPointers;
+    int *columnIndexes;
+    matrix_value_type *values;
+} Csr_Matrix;
+
+/**
+ * @brief This function builds the compressed sparse row (CSR) form of a sparse matrix. When only the upper triangle is wanted, the values below the main diagonal are skipped.
+ *
+ * @brief Time Complexity: O(n), because the row lists are walked twice (one to count, one to copy)
+ *
+ * @param matrix
+ * The matrix that will be converted
+ * @param upperOnly
+ * 1 to keep only the values with column >= row, 0 to keep all of them
+ * @return Csr_Matrix*
+ * The new compressed matrix
+ */
+static Csr_Matrix *_csr_matrix_build(Sparse_Matrix *matrix, int upperOnly){
+    Csr_Matrix *csr = (Csr_Matrix *)malloc(sizeof(Csr_Matrix));
+    Cell *current;
+
+    csr->numberRows = sparse_matrix_number_rows(matrix);
+    csr->numberColumns = sparse_matrix_number_columns(matrix);
+    csr->symmetric = upperOnly;
+    csr->rowPointers = (int *)malloc((csr->numberRows + 1) * sizeof(int));
+    csr->rowPointers[0] = 0;
+
+    for(int i = 0; i < csr->numberRows; i++){
+        int count = 0;
+        current = _sparse_matrix_row_head(matrix, i);
+
+        while(current){
+            if(!upperOnly || current->positionColumn >= i){
+                count++;
+            }
+
+            current = current->nextRow;
+        }
+
+        csr->rowPointers[i + 1] = csr->rowPointers[i] + count;
+    }
+
+    csr->numberNonNull = csr->rowPointers[csr->numberRows];
+    csr->columnIndexes = (int *)malloc((csr->numberNonNull + 1) * sizeof(int));
+    csr->values = (matrix_value_type *)malloc((csr->numberNonNull + 1) * sizeof(matrix_value_type));
+
+    for(int i = 0; i < csr->numberRows; i++){
+        int position = csr->rowPointers[i];
+        current = _sparse_matrix_row_head(matrix, i);
+
+        while(current){
+            if(!upperOnly || current->positionColumn >= i){
+                csr->columnIndexes[position] = current->positionColumn;
+                csr->values[position] = current->value;
+                position++;
+            }
+
+            current = current->nextRow;
+        }
+    }
+
+    return csr;
+}
+
+/**
+ * @brief This function converts a sparse matrix to the compressed sparse row (CSR) format: the values and columns of each row are stored contiguously and the rows are delimited by an array of pointers.
+ *
+ * @brief Time Complexity: O(n), because the row lists are walked twice
+ *
+ * @param matrix
+ * The matrix that will be converted
+ * @return Csr_Matrix*
+ * The new compressed matrix
+ */
+Csr_Matrix *csr_matrix_from_sparse(Sparse_Matrix *matrix){
+    return _csr_matrix_build(matrix, 0);
+}
+
+/**
+ * @brief This function converts a symmetric sparse matrix to the symmetric compressed format, which stores only the upper triangle (main diagonal included) and halves the memory read by the operations.
+ *
+ * @brief Time Complexity: O(n), because the row lists are walked twice
+ *
+ * @param matrix
+ * The symmetric matrix that will be converted (the lower triangle is ignored)
+ * @return Csr_Matrix*
+ * The new compressed matrix
+ */
+Csr_Matrix *csr_matrix_from_sparse_symmetric(Sparse_Matrix *matrix){
+    if(sparse_matrix_number_rows(matrix) != sparse_matrix_number_columns(matrix)){
+        printf("\033[91mError: a symmetric matrix must be square!\n\033[0m");
+        exit(1);
+    }
+
+    return _csr_matrix_build(matrix, 1);
+}
+
+/**
+ * @brief This function frees the memory allocated for a compressed matrix.
+ *
+ * @brief Time Complexity: O(1), because the arrays are freed in a unique way
+ *
+ * @param matrix
+ * The compressed matrix that will be deallocated
+ */
+void csr_matrix_destroy(Csr_Matrix *matrix){
+    free(matrix->rowPointers);
+    free(matrix->columnIndexes);
+    free(matrix->values);
+    free(matrix);
+}
+
+/**
+ * @brief This function returns the number of rows of a compressed matrix.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param matrix
+ * The compressed matrix that will be evaluated
+ * @return int
+ * The number of rows
+ */
+int csr_matrix_number_rows(Csr_Matrix *matrix){
+    return matrix->numberRows;
+}
+
+/**
+ * @brief This function returns the number of columns of a compressed matrix.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param matrix
+ * The compressed matrix that will be evaluated
+ * @return int
+ * The number of columns
+ */
+int csr_matrix_number_columns(Csr_Matrix *matrix){
+    return matrix->numberColumns;
+}
+
+/**
+ * @brief This function returns the number of values stored in a compressed matrix (only the upper triangle in the symmetric format).
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param matrix
+ * The compressed matrix that will be evaluated
+ * @return int
+ * The number of stored values
+ */
+int csr_matrix_number_non_null(Csr_Matrix *matrix){
+    return matrix->numberNonNull;
+}
+
+/**
+ * @brief This function tells if a compressed matrix is stored in the symmetric format.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param matrix
+ * The compressed matrix that will be evaluated
+ * @return int
+ * 1 if only the upper triangle is stored or 0 if not
+ */
+int csr_matrix_is_symmetric(Csr_Matrix *matrix){
+    return matrix->symmetric;
+}
+
+/**
+ * @brief This function returns the array that delimits the rows of a compressed matrix: the values of row i are at the positions rowPointers[i] to rowPointers[i + 1] - 1.
+ *
+ * @brief Time Complexity: O(1), because the array is stored in the structure
+ *
+ * @param matrix
+ * The compressed matrix
+ * @return const int*
+ * The row pointers (numberRows + 1 values)
+ */
+const int *csr_matrix_row_pointers(Csr_Matrix *matrix){
+    return matrix->rowPointers;
+}
+
+/**
+ * @brief This function returns the columns of the values of a compressed matrix, sorted inside each row.
+ *
+ * @brief Time Complexity: O(1), because the array is stored in the structure
+ *
+ * @param matrix
+ * The compressed matrix
+ * @return const int*
+ * The column of each value
+ */
+const int *csr_matrix_column_indexes(Csr_Matrix *matrix){
+    return matrix->columnIndexes;
+}
+
+/**
+ * @brief This function returns the values of a compressed matrix, row by row.
+ *
+ * @brief Time Complexity: O(1), because the array is stored in the structure
+ *
+ * @param matrix
+ * The compressed matrix
+ * @return const matrix_value_type*
+ * The values
+ */
+const matrix_value_type *csr_matrix_values(Csr_Matrix *matrix){
+    return matrix->values;
+}
+
+/**
+ * @brief This function multiplies a compressed matrix by a dense vector (result = matrix * vector). In the symmetric format, each value above the main diagonal is used twice: once for its row and once for its mirrored position.
+ *
+ * @brief Time Complexity: O(n), because each stored value is read once
+ *
+ * @param matrix
+ * The compressed matrix
+ * @param vector
+ * The vector of size numberColumns
+ * @param result
+ * The vector of size numberRows that will receive the product
+ */
+void csr_matrix_multiply_vector(Csr_Matrix *matrix, const matrix_value_type *vector, matrix_value_type *result){
+    const int *restrict rowPointers = matrix->rowPointers;
+    const int *restrict columnIndexes = matrix->columnIndexes;
+    const matrix_value_type *restrict values = matrix->values;
+
+    if(!matrix->symmetric){
+        for(int i = 0; i < matrix->numberRows; i++){
+            matrix_value_type sum = 0;
+
+            for(int k = rowPointers[i]; k < rowPointers[i + 1]; k++){
+                sum += values[k] * vector[columnIndexes[k]];
+            }
+
+            result[i] = sum;
+        }
+
+        return;
+    }
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        result[i] = 0;
+    }
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        matrix_value_type sum = 0;
+        matrix_value_type mirrored = vector[i];
+
+        for(int k = rowPointers[i]; k < rowPointers[i + 1]; k++){
+            int column = columnIndexes[k];
+            sum += values[k] * vector[column];
+
+            if(column != i){
+                result[column] += values[k] * mirrored;
+            }
+        }
+
+        result[i] += sum;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include "matrix.h"
+
+typedef struct Csr_Matrix Csr_Matrix;
+
+//Allocation functions
+
+Csr_Matrix *csr_matrix_from_sparse(Sparse_Matrix *matrix);
+Csr_Matrix *csr_matrix_from_sparse_symmetric(Sparse_Matrix *matrix);
+void csr_matrix_destroy(Csr_Matrix *matrix);
+
+//Getters functions
+
+int csr_matrix_number_rows(Csr_Matrix *matrix);
+int csr_matrix_number_columns(Csr_Matrix *matrix);
+int csr_matrix_number_non_null(Csr_Matrix *matrix);
+int csr_matrix_is_symmetric(Csr_Matrix *matrix);
+const int *csr_matrix_row_pointers(Csr_Matrix *matrix);
+const int *csr_matrix_column_indexes(Csr_Matrix *matrix);
+const matrix_value_type *csr_matrix_values(Csr_Matrix *matrix);
+
+//Operation functions with matrices
+
+void csr_matrix_multiply_vector(Csr_Matrix *matrix, const matrix_value_type *vector, matrix_value_type *result);
+
+#endif
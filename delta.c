@@ -0,0 +1,315 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "delta.h"
+
+typedef struct Delta_Entry{
+    int row, column;
+    matrix_value_type value;
+} Delta_Entry;
+
+typedef struct Sparse_Matrix_Delta{
+    Sparse_Matrix *matrix;
+    int capacity, size;
+    Delta_Entry *entries;
+    int *table;
+    unsigned int tableMask;
+    int maxRow, maxColumn;
+    int *rows, *columns;
+    matrix_value_type *values;
+} Sparse_Matrix_Delta;
+
+/**
+ * @brief This function returns the slot of the table where the hash of a position starts its search.
+ *
+ * @brief Time Complexity: O(1), because only the hash is computed
+ */
+static unsigned int _sparse_matrix_delta_hash(Sparse_Matrix_Delta *delta, int row, int column){
+    unsigned long long key = ((unsigned long long)(unsigned int)row << 32) | (unsigned int)column;
+
+    key *= 0x9E3779B97F4A7C15ULL;
+
+    return (unsigned int)(key >> 32) & delta->tableMask;
+}
+
+/**
+ * @brief This function finds the slot of the table that holds a position, or the empty slot where it would be placed.
+ *
+ * @brief Time Complexity: O(1) on average, because the table is kept at most half full
+ *
+ * @param delta
+ * The delta buffer
+ * @param row
+ * The row of the position
+ * @param column
+ * The column of the position
+ * @return int*
+ * The slot (-1 if the position isn't buffered, or the index of its last update in the buffer)
+ */
+static int *_sparse_matrix_delta_find(Sparse_Matrix_Delta *delta, int row, int column){
+    unsigned int slot = _sparse_matrix_delta_hash(delta, row, column);
+
+    while(delta->table[slot] != -1){
+        Delta_Entry *entry = &delta->entries[delta->table[slot]];
+
+        if(entry->row == row && entry->column == column){
+            break;
+        }
+
+        slot = (slot + 1) & delta->tableMask;
+    }
+
+    return &delta->table[slot];
+}
+
+/**
+ * @brief This function creates a delta buffer for a matrix. The updates written through the buffer are appended to a log and indexed by position, with no change to the matrix; when the log is full (or when asked) the updates are merged into the matrix in a unique sorted pass.
+ *
+ * @brief Time Complexity: O(k), where k is the capacity, because the log and the index are allocated once
+ *
+ * @param matrix
+ * The matrix that will receive the updates (it isn't copied, so it must live longer than the buffer)
+ * @param capacity
+ * The number of updates buffered before an automatic merge (0 to use DELTA_DEFAULT_CAPACITY)
+ * @return Sparse_Matrix_Delta*
+ * The new delta buffer
+ */
+Sparse_Matrix_Delta *sparse_matrix_delta_create(Sparse_Matrix *matrix, int capacity){
+    if(capacity < 0){
+        printf("\033[91mError: Invalid capacity!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix_Delta *delta = (Sparse_Matrix_Delta *)calloc(1, sizeof(Sparse_Matrix_Delta));
+    unsigned int tableSize = 2;
+
+    delta->matrix = matrix;
+    delta->capacity = capacity ? capacity : DELTA_DEFAULT_CAPACITY;
+
+    //At least twice the capacity, so the probes stay short
+    while(tableSize < 2 * (unsigned int)delta->capacity){
+        tableSize *= 2;
+    }
+
+    delta->tableMask = tableSize - 1;
+    delta->table = (int *)malloc(tableSize * sizeof(int));
+    delta->entries = (Delta_Entry *)malloc(delta->capacity * sizeof(Delta_Entry));
+    delta->rows = (int *)malloc(delta->capacity * sizeof(int));
+    delta->columns = (int *)malloc(delta->capacity * sizeof(int));
+    delta->values = (matrix_value_type *)malloc(delta->capacity * sizeof(matrix_value_type));
+    delta->maxRow = -1;
+    delta->maxColumn = -1;
+
+    for(unsigned int i = 0; i < tableSize; i++){
+        delta->table[i] = -1;
+    }
+
+    return delta;
+}
+
+/**
+ * @brief This function merges the pending updates into the matrix and frees the memory allocated for the buffer. The matrix isn't destroyed.
+ *
+ * @brief Time Complexity: the cost of sparse_matrix_delta_merge
+ *
+ * @param delta
+ * The delta buffer that will be deallocated
+ */
+void sparse_matrix_delta_destroy(Sparse_Matrix_Delta *delta){
+    sparse_matrix_delta_merge(delta);
+
+    free(delta->table);
+    free(delta->entries);
+    free(delta->rows);
+    free(delta->columns);
+    free(delta->values);
+    free(delta);
+}
+
+/**
+ * @brief This function puts a value in a position through the buffer. The update is appended to the log and the index points the position to it, so a later update of the same position wins; a null value removes the value at the merge. The matrix isn't touched until the buffer is merged, which happens here when the log is full.
+ *
+ * @brief Time Complexity: O(1) amortized, because the update is appended and indexed with a hash (the merges are paid by the updates that fill the log)
+ *
+ * @param delta
+ * The delta buffer
+ * @param data
+ * The value that will be defined
+ * @param row
+ * The row wanted
+ * @param column
+ * The column wanted
+ */
+void sparse_matrix_delta_set(Sparse_Matrix_Delta *delta, matrix_value_type data, int row, int column){
+    if(row < 0 || column < 0){
+        printf("\033[91mError: invalid index was read!\n\033[0m");
+        exit(1);
+    }
+
+    if(delta->size == delta->capacity){
+        sparse_matrix_delta_merge(delta);
+    }
+
+    Delta_Entry *entry = &delta->entries[delta->size];
+
+    entry->row = row;
+    entry->column = column;
+    entry->value = data;
+
+    *_sparse_matrix_delta_find(delta, row, column) = delta->size;
+    delta->size++;
+
+    if(data != 0 && row > delta->maxRow){
+        delta->maxRow = row;
+    }
+
+    if(data != 0 && column > delta->maxColumn){
+        delta->maxColumn = column;
+    }
+}
+
+/**
+ * @brief This function compares two updates by position, in row-major order.
+ *
+ * @brief Time Complexity: O(1), because only two positions are compared
+ */
+static int _sparse_matrix_delta_compare(const void *a, const void *b){
+    const Delta_Entry *first = a;
+    const Delta_Entry *second = b;
+
+    if(first->row != second->row){
+        return first->row < second->row ? -1 : 1;
+    }
+
+    return (first->column > second->column) - (first->column < second->column);
+}
+
+/**
+ * @brief This function folds the pending updates into the matrix: only the last update of each position is kept, the survivors are sorted in row-major order and the matrix receives them in a unique pass over the rows and columns they touch. The buffer is emptied.
+ *
+ * @brief Time Complexity: O(k*log(k) + n' + r + c), where k is the number of pending updates and n' is the number of values of the rows and columns touched
+ *
+ * @param delta
+ * The delta buffer
+ */
+void sparse_matrix_delta_merge(Sparse_Matrix_Delta *delta){
+    int count = 0;
+
+    if(delta->size == 0){
+        return;
+    }
+
+    //Last writer wins: an update survives only if the index still points to it
+    for(int k = 0; k < delta->size; k++){
+        int *slot = _sparse_matrix_delta_find(delta, delta->entries[k].row, delta->entries[k].column);
+
+        if(*slot == k){
+            delta->entries[count++] = delta->entries[k];
+        }
+    }
+
+    qsort(delta->entries, count, sizeof(Delta_Entry), _sparse_matrix_delta_compare);
+
+    for(int k = 0; k < count; k++){
+        delta->rows[k] = delta->entries[k].row;
+        delta->columns[k] = delta->entries[k].column;
+        delta->values[k] = delta->entries[k].value;
+    }
+
+    _sparse_matrix_merge_sorted(delta->matrix, delta->rows, delta->columns, delta->values, count);
+
+    for(unsigned int i = 0; i <= delta->tableMask; i++){
+        delta->table[i] = -1;
+    }
+
+    delta->size = 0;
+    delta->maxRow = -1;
+    delta->maxColumn = -1;
+}
+
+/**
+ * @brief This function returns the value of a position, looking first at the buffer (the last update wins) and then at the matrix.
+ *
+ * @brief Time Complexity: O(1) on average if the position is buffered and the cost of sparse_matrix_get_by_index if not
+ *
+ * @param delta
+ * The delta buffer
+ * @param row
+ * The row wanted
+ * @param column
+ * The column wanted
+ * @return matrix_value_type
+ * The value of that index (null or non-null)
+ */
+matrix_value_type sparse_matrix_delta_get(Sparse_Matrix_Delta *delta, int row, int column){
+    int position = *_sparse_matrix_delta_find(delta, row, column);
+
+    if(position != -1){
+        return delta->entries[position].value;
+    }
+
+    if(row >= sparse_matrix_number_rows(delta->matrix) || column >= sparse_matrix_number_columns(delta->matrix)){
+        return 0.0;
+    }
+
+    return sparse_matrix_get_by_index(delta->matrix, row, column);
+}
+
+/**
+ * @brief This function returns the number of updates waiting in the buffer (repeated positions included).
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param delta
+ * The delta buffer
+ * @return int
+ * The number of pending updates
+ */
+int sparse_matrix_delta_pending(Sparse_Matrix_Delta *delta){
+    return delta->size;
+}
+
+/**
+ * @brief This function returns the number of rows the matrix will have after the merge (a buffered value removed by a later update still counts, so it can be greater).
+ *
+ * @brief Time Complexity: O(1), because the largest row buffered is kept
+ *
+ * @param delta
+ * The delta buffer
+ * @return int
+ * The number of rows
+ */
+int sparse_matrix_delta_number_rows(Sparse_Matrix_Delta *delta){
+    int rows = sparse_matrix_number_rows(delta->matrix);
+
+    return delta->maxRow + 1 > rows ? delta->maxRow + 1 : rows;
+}
+
+/**
+ * @brief This function returns the number of columns the matrix will have after the merge (a buffered value removed by a later update still counts, so it can be greater).
+ *
+ * @brief Time Complexity: O(1), because the largest column buffered is kept
+ *
+ * @param delta
+ * The delta buffer
+ * @return int
+ * The number of columns
+ */
+int sparse_matrix_delta_number_columns(Sparse_Matrix_Delta *delta){
+    int columns = sparse_matrix_number_columns(delta->matrix);
+
+    return delta->maxColumn + 1 > columns ? delta->maxColumn + 1 : columns;
+}
+
+/**
+ * @brief This function returns the matrix of the buffer, without the pending updates. Call sparse_matrix_delta_merge first to operate on the up-to-date matrix.
+ *
+ * @brief Time Complexity: O(1), because the matrix is stored in the structure
+ *
+ * @param delta
+ * The delta buffer
+ * @return Sparse_Matrix*
+ * The matrix
+ */
+Sparse_Matrix *sparse_matrix_delta_base(Sparse_Matrix_Delta *delta){
+    return delta->matrix;
+}
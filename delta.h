@@ -0,0 +1,29 @@
+#ifndef DELTA_H
+#define DELTA_H
+
+#include "matrix.h"
+
+typedef struct Sparse_Matrix_Delta Sparse_Matrix_Delta;
+
+//Number of updates buffered before they are merged into the matrix, when no capacity is given
+#define DELTA_DEFAULT_CAPACITY 65536
+
+//Allocation functions
+
+Sparse_Matrix_Delta *sparse_matrix_delta_create(Sparse_Matrix *matrix, int capacity);
+void sparse_matrix_delta_destroy(Sparse_Matrix_Delta *delta);
+
+//Setters functions
+
+void sparse_matrix_delta_set(Sparse_Matrix_Delta *delta, matrix_value_type data, int row, int column);
+void sparse_matrix_delta_merge(Sparse_Matrix_Delta *delta);
+
+//Getters functions
+
+matrix_value_type sparse_matrix_delta_get(Sparse_Matrix_Delta *delta, int row, int column);
+int sparse_matrix_delta_pending(Sparse_Matrix_Delta *delta);
+int sparse_matrix_delta_number_rows(Sparse_Matrix_Delta *delta);
+int sparse_matrix_delta_number_columns(Sparse_Matrix_Delta *delta);
+Sparse_Matrix *sparse_matrix_delta_base(Sparse_Matrix_Delta *delta);
+
+#endif
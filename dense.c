@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "cell.h"
+#include "dense.h"
+
+typedef struct Dense_Matrix{
+    int numberRows, numberColumns;
+    matrix_value_type *values;
+} Dense_Matrix;
+
+/**
+ * @brief This function allocates a dense matrix with all values zero. The values are stored row by row in a unique block.
+ *
+ * @brief Time Complexity: O(r*c), because every value is set to zero
+ *
+ * @param numberRows
+ * The number of rows
+ * @param numberColumns
+ * The number of columns
+ * @return Dense_Matrix*
+ * The new dense matrix
+ */
+Dense_Matrix *dense_matrix_create(int numberRows, int numberColumns){
+    if(numberRows < 0 || numberColumns < 0){
+        printf("\033[91mError: Invalid dimensions!\n\033[0m");
+        exit(1);
+    }
+
+    Dense_Matrix *matrix = (Dense_Matrix *)malloc(sizeof(Dense_Matrix));
+
+    matrix->numberRows = numberRows;
+    matrix->numberColumns = numberColumns;
+    matrix->values = (matrix_value_type *)calloc((size_t)numberRows * numberColumns + 1, sizeof(matrix_value_type));
+
+    return matrix;
+}
+
+/**
+ * @brief This function converts a sparse matrix to the dense form.
+ *
+ * @brief Time Complexity: O(r*c + n), because the block is cleared and each non-null value is copied once
+ *
+ * @param matrix
+ * The sparse matrix that will be converted
+ * @return Dense_Matrix*
+ * The new dense matrix
+ */
+Dense_Matrix *dense_matrix_from_sparse(Sparse_Matrix *matrix){
+    Dense_Matrix *dense = dense_matrix_create(sparse_matrix_number_rows(matrix), sparse_matrix_number_columns(matrix));
+    Cell *current;
+
+    for(int i = 0; i < dense->numberRows; i++){
+        for(current = _sparse_matrix_row_head(matrix, i); current; current = current->nextRow){
+            dense->values[(size_t)i * dense->numberColumns + current->positionColumn] = current->value;
+        }
+    }
+
+    return dense;
+}
+
+/**
+ * @brief This function frees the memory allocated for a dense matrix.
+ *
+ * @brief Time Complexity: O(1), because the values are stored in a unique block
+ *
+ * @param matrix
+ * The dense matrix that will be deallocated
+ */
+void dense_matrix_destroy(Dense_Matrix *matrix){
+    free(matrix->values);
+    free(matrix);
+}
+
+/**
+ * @brief This function returns the number of rows of a dense matrix.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param matrix
+ * The dense matrix
+ * @return int
+ * The number of rows
+ */
+int dense_matrix_number_rows(Dense_Matrix *matrix){
+    return matrix->numberRows;
+}
+
+/**
+ * @brief This function returns the number of columns of a dense matrix.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param matrix
+ * The dense matrix
+ * @return int
+ * The number of columns
+ */
+int dense_matrix_number_columns(Dense_Matrix *matrix){
+    return matrix->numberColumns;
+}
+
+/**
+ * @brief This function returns the block of values of a dense matrix, so it can be filled or read directly. The value (i, j) is at position i * columns + j.
+ *
+ * @brief Time Complexity: O(1), because the block is stored in the structure
+ *
+ * @param matrix
+ * The dense matrix
+ * @return matrix_value_type*
+ * The values, row by row
+ */
+matrix_value_type *dense_matrix_values(Dense_Matrix *matrix){
+    return matrix->values;
+}
+
+/**
+ * @brief This function returns the value of a position of a dense matrix.
+ *
+ * @brief Time Complexity: O(1), because the position is computed directly
+ *
+ * @param matrix
+ * The dense matrix
+ * @param row
+ * The row of the value
+ * @param column
+ * The column of the value
+ * @return matrix_value_type
+ * The value
+ */
+matrix_value_type dense_matrix_get_by_index(Dense_Matrix *matrix, int row, int column){
+    if(row < 0 || column < 0 || row >= matrix->numberRows || column >= matrix->numberColumns){
+        printf("\033[91mError: Invalid index!\n\033[0m");
+        exit(1);
+    }
+
+    return matrix->values[(size_t)row * matrix->numberColumns + column];
+}
+
+/**
+ * @brief This function changes the value of a position of a dense matrix.
+ *
+ * @brief Time Complexity: O(1), because the position is computed directly
+ *
+ * @param matrix
+ * The dense matrix
+ * @param data
+ * The new value
+ * @param row
+ * The row of the value
+ * @param column
+ * The column of the value
+ */
+void dense_matrix_set_by_index(Dense_Matrix *matrix, matrix_value_type data, int row, int column){
+    if(row < 0 || column < 0 || row >= matrix->numberRows || column >= matrix->numberColumns){
+        printf("\033[91mError: Invalid index!\n\033[0m");
+        exit(1);
+    }
+
+    matrix->values[(size_t)row * matrix->numberColumns + column] = data;
+}
+
+/**
+ * @brief This function adds value * source to output over a full block of columns. The width is a constant, so the compiler vectorizes the loop with no remainder.
+ *
+ * @brief Time Complexity: O(b), where b is DENSE_BLOCK_COLUMNS
+ */
+static void _dense_matrix_update_block(matrix_value_type value, const matrix_value_type *restrict source, matrix_value_type *restrict output){
+    for(int j = 0; j < DENSE_BLOCK_COLUMNS; j++){
+        output[j] += value * source[j];
+    }
+}
+
+/**
+ * @brief This function adds value * source to output over a partial block of columns.
+ *
+ * @brief Time Complexity: O(w), where w is the width of the block
+ */
+static void _dense_matrix_update(int width, matrix_value_type value, const matrix_value_type *restrict source, matrix_value_type *restrict output){
+    for(int j = 0; j < width; j++){
+        output[j] += value * source[j];
+    }
+}
+
+/**
+ * @brief This function multiplies a sparse matrix by a dense matrix (SpMM): op(matrix) * op(dense), where op transposes its operand when the matching flag is 1. The dense columns of the result are computed in blocks: each sparse row (or column, when the sparse operand is transposed) is walked once per block and every value updates the whole block at once, with the slice of the dense operand read by the block kept in cache. A transposed dense operand is first copied into a contiguous tile for each block, so the updates always read rows.
+ *
+ * @brief Time Complexity: O(n*m + r*m), where n is the number of non-null values of the sparse matrix, m is the number of columns of the result and r its number of rows
+ *
+ * @param matrix
+ * The sparse matrix
+ * @param transposeSparse
+ * 1 to use the transpose of the sparse matrix or 0 to use it as it is
+ * @param dense
+ * The dense matrix
+ * @param transposeDense
+ * 1 to use the transpose of the dense matrix or 0 to use it as it is
+ * @return Dense_Matrix*
+ * The new dense matrix with the product
+ */
+Dense_Matrix *dense_matrix_sparse_multiplication(Sparse_Matrix *matrix, int transposeSparse, Dense_Matrix *dense, int transposeDense){
+    int rows = transposeSparse ? sparse_matrix_number_columns(matrix) : sparse_matrix_number_rows(matrix);
+    int inner = transposeSparse ? sparse_matrix_number_rows(matrix) : sparse_matrix_number_columns(matrix);
+    int denseRows = transposeDense ? dense->numberColumns : dense->numberRows;
+    int columns = transposeDense ? dense->numberRows : dense->numberColumns;
+
+    if(inner != denseRows){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    Dense_Matrix *result = dense_matrix_create(rows, columns);
+
+    //The slice of the dense operand read by a block has inner rows, so it's narrowed until it fits in the cache
+    int blockColumns = DENSE_BLOCK_COLUMNS;
+
+    while(blockColumns > 8 && (size_t)inner * blockColumns * sizeof(matrix_value_type) > DENSE_CACHE_BYTES){
+        blockColumns /= 2;
+    }
+
+    matrix_value_type *tile = transposeDense ? (matrix_value_type *)malloc(((size_t)inner * blockColumns + 1) * sizeof(matrix_value_type)) : NULL;
+
+    for(int begin = 0; begin < columns; begin += blockColumns){
+        int width = columns - begin < blockColumns ? columns - begin : blockColumns;
+        const matrix_value_type *source;
+        size_t stride;
+
+        if(transposeDense){
+            for(int k = 0; k < inner; k++){
+                for(int j = 0; j < width; j++){
+                    tile[(size_t)k * width + j] = dense->values[(size_t)(begin + j) * dense->numberColumns + k];
+                }
+            }
+
+            source = tile;
+            stride = width;
+        }
+
+        else{
+            source = dense->values + begin;
+            stride = dense->numberColumns;
+        }
+
+        for(int i = 0; i < rows; i++){
+            matrix_value_type *output = result->values + (size_t)i * columns + begin;
+            Sparse_Matrix_Cursor cursor = transposeSparse ? sparse_matrix_column_cursor(matrix, i) : sparse_matrix_row_cursor(matrix, i);
+
+            while(sparse_matrix_cursor_next(&cursor)){
+                int k = transposeSparse ? cursor.row : cursor.column;
+
+                if(width == DENSE_BLOCK_COLUMNS){
+                    _dense_matrix_update_block(cursor.value, source + k * stride, output);
+                }
+
+                else{
+                    _dense_matrix_update(width, cursor.value, source + k * stride, output);
+                }
+            }
+        }
+    }
+
+    free(tile);
+
+    return result;
+}
@@ -0,0 +1,34 @@
+#ifndef DENSE_H
+#define DENSE_H
+
+#include "matrix.h"
+
+typedef struct Dense_Matrix Dense_Matrix;
+
+//Largest number of dense columns updated together by the sparse-dense multiplication (a multiple of the vector width)
+#define DENSE_BLOCK_COLUMNS 64
+//Size of the cache that the slice of the dense operand read by a block should fit in
+#define DENSE_CACHE_BYTES 262144
+
+//Allocation functions
+
+Dense_Matrix *dense_matrix_create(int numberRows, int numberColumns);
+Dense_Matrix *dense_matrix_from_sparse(Sparse_Matrix *matrix);
+void dense_matrix_destroy(Dense_Matrix *matrix);
+
+//Getters functions
+
+int dense_matrix_number_rows(Dense_Matrix *matrix);
+int dense_matrix_number_columns(Dense_Matrix *matrix);
+matrix_value_type *dense_matrix_values(Dense_Matrix *matrix);
+matrix_value_type dense_matrix_get_by_index(Dense_Matrix *matrix, int row, int column);
+
+//Setters functions
+
+void dense_matrix_set_by_index(Dense_Matrix *matrix, matrix_value_type data, int row, int column);
+
+//Operation functions with matrices
+
+Dense_Matrix *dense_matrix_sparse_multiplication(Sparse_Matrix *matrix, int transposeSparse, Dense_Matrix *dense, int transposeDense);
+
+#endif
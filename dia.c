@@ -0,0 +1,361 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "cell.h"
+#include "dia.h"
+
+typedef struct Dia_Matrix{
+    int numberRows, numberColumns, numberDiagonals;
+    int *offsets;
+    matrix_value_type *values;
+} Dia_Matrix;
+
+/**
+ * @brief This function marks which diagonals of a sparse matrix hold at least one non-null value. The diagonal with offset k (column - row) is marked at the position k + numberRows - 1.
+ *
+ * @brief Time Complexity: O(n), because the function visits each non-null value once
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @param occupied
+ * The array of size numberRows + numberColumns - 1 that will receive the marks
+ * @param numberNonNull
+ * The pointer that will receive the number of non-null values found
+ * @return int
+ * The number of occupied diagonals
+ */
+static int _dia_matrix_mark_diagonals(Sparse_Matrix *matrix, char *occupied, int *numberNonNull){
+    int numberRows = sparse_matrix_number_rows(matrix);
+    int numberDiagonals = 0;
+    Cell *current;
+
+    *numberNonNull = 0;
+
+    for(int i = 0; i < numberRows; i++){
+        current = _sparse_matrix_row_head(matrix, i);
+
+        while(current){
+            int position = current->positionColumn - current->positionRow + numberRows - 1;
+
+            if(!occupied[position]){
+                occupied[position] = 1;
+                numberDiagonals++;
+            }
+
+            (*numberNonNull)++;
+            current = current->nextRow;
+        }
+    }
+
+    return numberDiagonals;
+}
+
+/**
+ * @brief This function allocates an empty diagonal matrix with room for the number of diagonals wanted.
+ *
+ * @brief Time Complexity: O(d*n), because the values of the d diagonals (of size n) are zeroed
+ *
+ * @param numberRows
+ * The number of rows
+ * @param numberColumns
+ * The number of columns
+ * @param numberDiagonals
+ * The number of stored diagonals
+ * @return Dia_Matrix*
+ * The new diagonal matrix
+ */
+static Dia_Matrix *_dia_matrix_create(int numberRows, int numberColumns, int numberDiagonals){
+    Dia_Matrix *matrix = (Dia_Matrix *)malloc(sizeof(Dia_Matrix));
+
+    matrix->numberRows = numberRows;
+    matrix->numberColumns = numberColumns;
+    matrix->numberDiagonals = numberDiagonals;
+    matrix->offsets = (int *)malloc((numberDiagonals + 1) * sizeof(int));
+    matrix->values = (matrix_value_type *)calloc((size_t)numberDiagonals * numberRows + 1, sizeof(matrix_value_type));
+
+    return matrix;
+}
+
+/**
+ * @brief This function checks if the diagonal format is worth it for a matrix, i.e., if the number of stored slots (occupied diagonals times rows) doesn't exceed the number of non-null values by more than the ratio given.
+ *
+ * @brief Time Complexity: O(n), because the function visits each non-null value once
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @param maxFillRatio
+ * The maximum ratio between the stored slots and the non-null values
+ * @return int
+ * 1 if the diagonal format is accepted or 0 if not
+ */
+int dia_matrix_check_bandwidth(Sparse_Matrix *matrix, float maxFillRatio){
+    int numberRows = sparse_matrix_number_rows(matrix);
+    int numberColumns = sparse_matrix_number_columns(matrix);
+    int numberNonNull;
+
+    char *occupied = (char *)calloc(numberRows + numberColumns - 1, sizeof(char));
+    int numberDiagonals = _dia_matrix_mark_diagonals(matrix, occupied, &numberNonNull);
+
+    free(occupied);
+
+    if(numberNonNull == 0){
+        return 1;
+    }
+
+    return (double)numberDiagonals * numberRows <= (double)maxFillRatio * numberNonNull;
+}
+
+/**
+ * @brief This function converts a sparse matrix to the diagonal format, where each occupied diagonal is stored as a contiguous array of size numberRows with its offset (column - row). The conversion is rejected when it would waste too much space.
+ *
+ * @brief Time Complexity: O(n + d*m), because the non-null values are visited twice and the d diagonals of size m are allocated
+ *
+ * @param matrix
+ * The matrix that will be converted
+ * @param maxFillRatio
+ * The maximum ratio between the stored slots and the non-null values (DIA_MAX_FILL_RATIO is a sensible default)
+ * @return Dia_Matrix*
+ * The new diagonal matrix or NULL if the bandwidth check rejects the format
+ */
+Dia_Matrix *dia_matrix_from_sparse(Sparse_Matrix *matrix, float maxFillRatio){
+    int numberRows = sparse_matrix_number_rows(matrix);
+    int numberColumns = sparse_matrix_number_columns(matrix);
+    int numberNonNull;
+
+    char *occupied = (char *)calloc(numberRows + numberColumns - 1, sizeof(char));
+    int numberDiagonals = _dia_matrix_mark_diagonals(matrix, occupied, &numberNonNull);
+
+    if(numberNonNull > 0 && (double)numberDiagonals * numberRows > (double)maxFillRatio * numberNonNull){
+        free(occupied);
+        return NULL;
+    }
+
+    Dia_Matrix *dia = _dia_matrix_create(numberRows, numberColumns, numberDiagonals);
+    int *diagonal_of = (int *)malloc((numberRows + numberColumns - 1) * sizeof(int));
+    int d = 0;
+
+    for(int k = 0; k < numberRows + numberColumns - 1; k++){
+        if(occupied[k]){
+            dia->offsets[d] = k - (numberRows - 1);
+            diagonal_of[k] = d;
+            d++;
+        }
+    }
+
+    Cell *current;
+
+    for(int i = 0; i < numberRows; i++){
+        current = _sparse_matrix_row_head(matrix, i);
+
+        while(current){
+            int position = current->positionColumn - current->positionRow + numberRows - 1;
+            dia->values[(size_t)diagonal_of[position] * numberRows + i] = current->value;
+            current = current->nextRow;
+        }
+    }
+
+    free(diagonal_of);
+    free(occupied);
+
+    return dia;
+}
+
+/**
+ * @brief This function converts a diagonal matrix back to a sparse matrix.
+ *
+ * @brief Time Complexity: O(d*m*n), because each of the d*m slots that holds a non-null value is placed with a O(n) insertion
+ *
+ * @param matrix
+ * The diagonal matrix that will be converted
+ * @return Sparse_Matrix*
+ * The new sparse matrix
+ */
+Sparse_Matrix *dia_matrix_to_sparse(Dia_Matrix *matrix){
+    Sparse_Matrix *new_matrix = sparse_matrix_create();
+
+    for(int d = 0; d < matrix->numberDiagonals; d++){
+        int offset = matrix->offsets[d];
+        matrix_value_type *diagonal = matrix->values + (size_t)d * matrix->numberRows;
+
+        for(int i = 0; i < matrix->numberRows; i++){
+            if(diagonal[i] != 0){
+                sparse_matrix_set_by_index(new_matrix, diagonal[i], i, i + offset);
+            }
+        }
+    }
+
+    //Keeps the dimensions even if the last rows or columns are empty
+    if(matrix->numberRows > 0 && matrix->numberColumns > 0){
+        _sparse_matrix_realloc(new_matrix, matrix->numberRows - 1, matrix->numberColumns - 1);
+    }
+
+    return new_matrix;
+}
+
+/**
+ * @brief This function frees the memory allocated for a diagonal matrix.
+ *
+ * @brief Time Complexity: O(1), because the diagonals are stored in a unique block
+ *
+ * @param matrix
+ * The diagonal matrix that will be deallocated
+ */
+void dia_matrix_destroy(Dia_Matrix *matrix){
+    free(matrix->offsets);
+    free(matrix->values);
+    free(matrix);
+}
+
+/**
+ * @brief This function returns the number of diagonals stored in a diagonal matrix.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param matrix
+ * The diagonal matrix that will be evaluated
+ * @return int
+ * The number of stored diagonals
+ */
+int dia_matrix_number_diagonals(Dia_Matrix *matrix){
+    return matrix->numberDiagonals;
+}
+
+/**
+ * @brief This function multiplies a diagonal matrix by a dense vector (result = matrix * vector). Each diagonal is streamed as a contiguous array with no index lookups, so the inner loop can be vectorized by the compiler.
+ *
+ * @brief Time Complexity: O(d*m), because each of the d diagonals of size m is read once
+ *
+ * @param matrix
+ * The diagonal matrix
+ * @param vector
+ * The vector of size numberColumns
+ * @param result
+ * The vector of size numberRows that will receive the product
+ */
+void dia_matrix_multiply_vector(Dia_Matrix *matrix, const matrix_value_type *vector, matrix_value_type *result){
+    for(int i = 0; i < matrix->numberRows; i++){
+        result[i] = 0;
+    }
+
+    for(int d = 0; d < matrix->numberDiagonals; d++){
+        int offset = matrix->offsets[d];
+        int begin = offset < 0 ? -offset : 0;
+        int end = matrix->numberColumns - offset < matrix->numberRows ? matrix->numberColumns - offset : matrix->numberRows;
+
+        const matrix_value_type *restrict diagonal = matrix->values + (size_t)d * matrix->numberRows;
+        const matrix_value_type *restrict input = vector;
+        matrix_value_type *restrict output = result;
+
+        //The vector is indexed inside the loop, since vector + offset would point before it for a sub-diagonal
+        for(int i = begin; i < end; i++){
+            output[i] += diagonal[i] * input[i + offset];
+        }
+    }
+}
+
+/**
+ * @brief This function multiplies the values of a diagonal matrix by a scalar k and returns a new diagonal matrix.
+ *
+ * @brief Time Complexity: O(d*m), because each of the d diagonals of size m is read once
+ *
+ * @param matrix
+ * The original diagonal matrix
+ * @param scalar
+ * The factor by which the values will be multiplied
+ * @return Dia_Matrix*
+ * The new diagonal matrix with multiplied values
+ */
+Dia_Matrix *dia_matrix_multiply_scalar(Dia_Matrix *matrix, matrix_value_type scalar){
+    Dia_Matrix *new_matrix = _dia_matrix_create(matrix->numberRows, matrix->numberColumns, matrix->numberDiagonals);
+    size_t size = (size_t)matrix->numberDiagonals * matrix->numberRows;
+
+    for(int d = 0; d < matrix->numberDiagonals; d++){
+        new_matrix->offsets[d] = matrix->offsets[d];
+    }
+
+    for(size_t i = 0; i < size; i++){
+        new_matrix->values[i] = matrix->values[i] * scalar;
+    }
+
+    return new_matrix;
+}
+
+/**
+ * @brief This function adds two diagonal matrices and returns a new diagonal matrix. The sorted offsets of both matrices are merged, so each diagonal is added with a contiguous loop.
+ *
+ * @brief Time Complexity: O((d1 + d2)*m), because each diagonal of both matrices is read once
+ *
+ * @param matrix1
+ * The first diagonal matrix
+ * @param matrix2
+ * The second diagonal matrix
+ * @return Dia_Matrix*
+ * The new diagonal matrix that contains the result of the sum
+ */
+Dia_Matrix *dia_matrix_sum(Dia_Matrix *matrix1, Dia_Matrix *matrix2){
+    if(matrix1->numberRows != matrix2->numberRows || matrix1->numberColumns != matrix2->numberColumns){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    int numberRows = matrix1->numberRows;
+    int d1 = 0, d2 = 0, numberDiagonals = 0;
+
+    while(d1 < matrix1->numberDiagonals || d2 < matrix2->numberDiagonals){
+        if(d2 == matrix2->numberDiagonals || (d1 < matrix1->numberDiagonals && matrix1->offsets[d1] < matrix2->offsets[d2])){
+            d1++;
+        }
+
+        else if(d1 == matrix1->numberDiagonals || matrix2->offsets[d2] < matrix1->offsets[d1]){
+            d2++;
+        }
+
+        else{
+            d1++;
+            d2++;
+        }
+
+        numberDiagonals++;
+    }
+
+    Dia_Matrix *new_matrix = _dia_matrix_create(numberRows, matrix1->numberColumns, numberDiagonals);
+    d1 = 0;
+    d2 = 0;
+
+    for(int d = 0; d < numberDiagonals; d++){
+        matrix_value_type *restrict output = new_matrix->values + (size_t)d * numberRows;
+        const matrix_value_type *restrict first = NULL;
+        const matrix_value_type *restrict second = NULL;
+
+        if(d2 == matrix2->numberDiagonals || (d1 < matrix1->numberDiagonals && matrix1->offsets[d1] < matrix2->offsets[d2])){
+            new_matrix->offsets[d] = matrix1->offsets[d1];
+            first = matrix1->values + (size_t)d1++ * numberRows;
+        }
+
+        else if(d1 == matrix1->numberDiagonals || matrix2->offsets[d2] < matrix1->offsets[d1]){
+            new_matrix->offsets[d] = matrix2->offsets[d2];
+            second = matrix2->values + (size_t)d2++ * numberRows;
+        }
+
+        else{
+            new_matrix->offsets[d] = matrix1->offsets[d1];
+            first = matrix1->values + (size_t)d1++ * numberRows;
+            second = matrix2->values + (size_t)d2++ * numberRows;
+        }
+
+        if(first && second){
+            for(int i = 0; i < numberRows; i++){
+                output[i] = first[i] + second[i];
+            }
+        }
+
+        else{
+            const matrix_value_type *source = first ? first : second;
+
+            for(int i = 0; i < numberRows; i++){
+                output[i] = source[i];
+            }
+        }
+    }
+
+    return new_matrix;
+}
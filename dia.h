@@ -0,0 +1,28 @@
+#ifndef DIA_H
+#define DIA_H
+
+#include "matrix.h"
+
+typedef struct Dia_Matrix Dia_Matrix;
+
+//Maximum ratio between the stored slots and the non-null values accepted by the bandwidth check
+#define DIA_MAX_FILL_RATIO 3.0
+
+//Allocation functions
+
+Dia_Matrix *dia_matrix_from_sparse(Sparse_Matrix *matrix, float maxFillRatio);
+Sparse_Matrix *dia_matrix_to_sparse(Dia_Matrix *matrix);
+void dia_matrix_destroy(Dia_Matrix *matrix);
+
+//Verification functions
+
+int dia_matrix_check_bandwidth(Sparse_Matrix *matrix, float maxFillRatio);
+int dia_matrix_number_diagonals(Dia_Matrix *matrix);
+
+//Operation functions with matrices
+
+void dia_matrix_multiply_vector(Dia_Matrix *matrix, const matrix_value_type *vector, matrix_value_type *result);
+Dia_Matrix *dia_matrix_multiply_scalar(Dia_Matrix *matrix, matrix_value_type scalar);
+Dia_Matrix *dia_matrix_sum(Dia_Matrix *matrix1, Dia_Matrix *matrix2);
+
+#endif
@@ -0,0 +1,639 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "expression.h"
+
+typedef enum{
+    EXPRESSION_LEAF,
+    EXPRESSION_SCALE,
+    EXPRESSION_SUM,
+    EXPRESSION_MULTIPLY_POINT,
+    EXPRESSION_TRANSPOSE,
+    EXPRESSION_MULTIPLICATION
+} Expression_Kind;
+
+typedef struct Expression_Row{
+    int length;
+    int *columns;
+    matrix_value_type *values;
+} Expression_Row;
+
+typedef struct Expression_List{
+    int size, capacity;
+    Sparse_Expression **items;
+} Expression_List;
+
+typedef struct Sparse_Expression{
+    Expression_Kind kind;
+    int references;
+    int numberRows, numberColumns;
+    matrix_value_type scalar;
+    struct Sparse_Expression *left, *right;
+    Sparse_Matrix *matrix;
+    int uses;
+    unsigned long countMark, regionMark;
+    Expression_Row rows[2];
+} Sparse_Expression;
+
+//Marks that tell if a node was already visited in the current evaluation or region
+static unsigned long evaluation_stamp;
+static unsigned long region_stamp;
+
+/**
+ * @brief This function allocates a node of the expression graph.
+ *
+ * @brief Time Complexity: O(1), because only the node is allocated
+ *
+ * @param kind
+ * The kind of the node
+ * @param numberRows
+ * The number of rows of the matrix the node represents
+ * @param numberColumns
+ * The number of columns of the matrix the node represents
+ * @param left
+ * The first operand (or NULL)
+ * @param right
+ * The second operand (or NULL)
+ * @return Sparse_Expression*
+ * The new node, with one reference
+ */
+static Sparse_Expression *_sparse_expression_create(Expression_Kind kind, int numberRows, int numberColumns, Sparse_Expression *left, Sparse_Expression *right){
+    Sparse_Expression *expression = (Sparse_Expression *)calloc(1, sizeof(Sparse_Expression));
+
+    expression->kind = kind;
+    expression->references = 1;
+    expression->numberRows = numberRows;
+    expression->numberColumns = numberColumns;
+    expression->left = left;
+    expression->right = right;
+
+    return expression;
+}
+
+/**
+ * @brief This function creates a leaf of the expression graph, which represents an existing matrix. The matrix isn't copied, so it must not change or be destroyed until the expression is evaluated.
+ *
+ * @brief Time Complexity: O(1), because only the node is allocated
+ *
+ * @param matrix
+ * The matrix represented
+ * @return Sparse_Expression*
+ * The new expression
+ */
+Sparse_Expression *sparse_expression_leaf(Sparse_Matrix *matrix){
+    Sparse_Expression *expression = _sparse_expression_create(EXPRESSION_LEAF, sparse_matrix_number_rows(matrix), sparse_matrix_number_columns(matrix), NULL, NULL);
+
+    expression->matrix = matrix;
+
+    return expression;
+}
+
+/**
+ * @brief This function records the multiplication of an expression by a scalar k.
+ *
+ * @brief Time Complexity: O(1), because nothing is computed until the evaluation
+ *
+ * @param operand
+ * The expression that will be multiplied
+ * @param scalar
+ * The factor by which the values will be multiplied
+ * @return Sparse_Expression*
+ * The new expression
+ */
+Sparse_Expression *sparse_expression_scale(Sparse_Expression *operand, matrix_value_type scalar){
+    Sparse_Expression *expression = _sparse_expression_create(EXPRESSION_SCALE, operand->numberRows, operand->numberColumns, operand, NULL);
+
+    expression->scalar = scalar;
+
+    return expression;
+}
+
+/**
+ * @brief This function records the sum of two expressions.
+ *
+ * @brief Time Complexity: O(1), because nothing is computed until the evaluation
+ *
+ * @param operand1
+ * The first expression
+ * @param operand2
+ * The second expression
+ * @return Sparse_Expression*
+ * The new expression
+ */
+Sparse_Expression *sparse_expression_sum(Sparse_Expression *operand1, Sparse_Expression *operand2){
+    if(operand1->numberRows != operand2->numberRows || operand1->numberColumns != operand2->numberColumns){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    return _sparse_expression_create(EXPRESSION_SUM, operand1->numberRows, operand1->numberColumns, operand1, operand2);
+}
+
+/**
+ * @brief This function records the multiplication by points of two expressions.
+ *
+ * @brief Time Complexity: O(1), because nothing is computed until the evaluation
+ *
+ * @param operand1
+ * The first expression
+ * @param operand2
+ * The second expression
+ * @return Sparse_Expression*
+ * The new expression
+ */
+Sparse_Expression *sparse_expression_multiply_point(Sparse_Expression *operand1, Sparse_Expression *operand2){
+    if(operand1->numberRows != operand2->numberRows || operand1->numberColumns != operand2->numberColumns){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    return _sparse_expression_create(EXPRESSION_MULTIPLY_POINT, operand1->numberRows, operand1->numberColumns, operand1, operand2);
+}
+
+/**
+ * @brief This function records the transpose of an expression. The transpose is never built: the nodes below it read their columns instead of their rows.
+ *
+ * @brief Time Complexity: O(1), because nothing is computed until the evaluation
+ *
+ * @param operand
+ * The expression that will be transposed
+ * @return Sparse_Expression*
+ * The new expression
+ */
+Sparse_Expression *sparse_expression_transpose(Sparse_Expression *operand){
+    return _sparse_expression_create(EXPRESSION_TRANSPOSE, operand->numberColumns, operand->numberRows, operand, NULL);
+}
+
+/**
+ * @brief This function records the multiplication of two expressions.
+ *
+ * @brief Time Complexity: O(1), because nothing is computed until the evaluation
+ *
+ * @param operand1
+ * The first expression
+ * @param operand2
+ * The second expression
+ * @return Sparse_Expression*
+ * The new expression
+ */
+Sparse_Expression *sparse_expression_multiplication(Sparse_Expression *operand1, Sparse_Expression *operand2){
+    if(operand1->numberColumns != operand2->numberRows){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    return _sparse_expression_create(EXPRESSION_MULTIPLICATION, operand1->numberRows, operand2->numberColumns, operand1, operand2);
+}
+
+/**
+ * @brief This function returns a new reference to an expression, so it can be used as the operand of more than one node (the graph becomes a DAG and the shared node is computed once per evaluation).
+ *
+ * @brief Time Complexity: O(1), because only the counter of references changes
+ *
+ * @param expression
+ * The expression that will be shared
+ * @return Sparse_Expression*
+ * The same expression
+ */
+Sparse_Expression *sparse_expression_share(Sparse_Expression *expression){
+    expression->references++;
+
+    return expression;
+}
+
+/**
+ * @brief This function drops a reference to an expression. When the last one is dropped, the node and the operands it holds are freed. The matrices of the leaves aren't destroyed.
+ *
+ * @brief Time Complexity: O(e), because each of the e nodes that lose their last reference is freed once
+ *
+ * @param expression
+ * The expression that will be released
+ */
+void sparse_expression_destroy(Sparse_Expression *expression){
+    if(expression == NULL || --expression->references > 0){
+        return;
+    }
+
+    sparse_expression_destroy(expression->left);
+    sparse_expression_destroy(expression->right);
+
+    if(expression->kind == EXPRESSION_MULTIPLICATION && expression->matrix){
+        sparse_matrix_destroy(expression->matrix);
+    }
+
+    for(int t = 0; t < 2; t++){
+        free(expression->rows[t].columns);
+        free(expression->rows[t].values);
+    }
+
+    free(expression);
+}
+
+/**
+ * @brief This function returns the number of rows of the matrix an expression represents.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the node
+ *
+ * @param expression
+ * The expression that will be evaluated
+ * @return int
+ * The number of rows
+ */
+int sparse_expression_number_rows(Sparse_Expression *expression){
+    return expression->numberRows;
+}
+
+/**
+ * @brief This function returns the number of columns of the matrix an expression represents.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the node
+ *
+ * @param expression
+ * The expression that will be evaluated
+ * @return int
+ * The number of columns
+ */
+int sparse_expression_number_columns(Sparse_Expression *expression){
+    return expression->numberColumns;
+}
+
+/**
+ * @brief This function adds a node to a list, growing it when needed.
+ *
+ * @brief Time Complexity: O(1), amortized
+ *
+ * @param list
+ * The list that will receive the node
+ * @param expression
+ * The node that will be added
+ */
+static void _expression_list_push(Expression_List *list, Sparse_Expression *expression){
+    if(list->size == list->capacity){
+        list->capacity = list->capacity ? 2 * list->capacity : 4;
+        list->items = (Sparse_Expression **)realloc(list->items, list->capacity * sizeof(Sparse_Expression *));
+    }
+
+    list->items[list->size++] = expression;
+}
+
+/**
+ * @brief This function walks a fused region (the nodes computed together, row by row) and collects the multiplications it reads. Each multiplication is collected once per region, even if the region reaches it by more than one path.
+ *
+ * @brief Time Complexity: O(e), because each node of the region is visited once
+ *
+ * @param expression
+ * The current node
+ * @param list
+ * The list that will receive the multiplications
+ */
+static void _sparse_expression_collect_visit(Sparse_Expression *expression, Expression_List *list){
+    if(expression == NULL || expression->regionMark == region_stamp){
+        return;
+    }
+
+    expression->regionMark = region_stamp;
+
+    if(expression->kind == EXPRESSION_MULTIPLICATION){
+        _expression_list_push(list, expression);
+        return;
+    }
+
+    _sparse_expression_collect_visit(expression->left, list);
+    _sparse_expression_collect_visit(expression->right, list);
+}
+
+/**
+ * @brief This function collects the multiplications read by the fused region that starts at a node.
+ *
+ * @brief Time Complexity: O(e), because each node of the region is visited once
+ *
+ * @param expression
+ * The root of the region
+ * @return Expression_List
+ * The multiplications of the region
+ */
+static Expression_List _sparse_expression_collect(Sparse_Expression *expression){
+    Expression_List list = {0, 0, NULL};
+
+    region_stamp++;
+    _sparse_expression_collect_visit(expression, &list);
+
+    return list;
+}
+
+static void _sparse_expression_count_region(Sparse_Expression *expression);
+
+/**
+ * @brief This function counts how many regions will read the result of each multiplication, by walking the graph in the same order as the evaluation. The counts let the evaluation free each product as soon as its last reader is done.
+ *
+ * @brief Time Complexity: O(e), because each region is walked once
+ *
+ * @param product
+ * The multiplication whose operands will be counted
+ */
+static void _sparse_expression_count_product(Sparse_Expression *product){
+    _sparse_expression_count_region(product->left);
+    _sparse_expression_count_region(product->right);
+}
+
+/**
+ * @brief This function counts the readers of the multiplications of a region, descending into each multiplication the first time it's found.
+ *
+ * @brief Time Complexity: O(e), because each region is walked once
+ *
+ * @param expression
+ * The root of the region
+ */
+static void _sparse_expression_count_region(Sparse_Expression *expression){
+    Expression_List list = _sparse_expression_collect(expression);
+
+    for(int i = 0; i < list.size; i++){
+        Sparse_Expression *product = list.items[i];
+
+        if(product->countMark != evaluation_stamp){
+            product->countMark = evaluation_stamp;
+            product->uses = 0;
+            _sparse_expression_count_product(product);
+        }
+
+        product->uses++;
+    }
+
+    free(list.items);
+}
+
+/**
+ * @brief This function computes one row of the matrix a node represents (or one column, when the node is read transposed), with the columns in increasing order. Elementwise nodes are fused: they combine the rows of their operands with no intermediate matrix, and a transpose only switches the operands to their columns.
+ *
+ * @brief Time Complexity: O(k), where k is the number of values of that row in the leaves and products below the node
+ *
+ * @param expression
+ * The node
+ * @param row
+ * The row wanted
+ * @param transposed
+ * 1 if the node is read transposed or 0 if not
+ * @return Expression_Row*
+ * The row computed (owned by the node, valid until the next row is asked)
+ */
+static Expression_Row *_sparse_expression_row(Sparse_Expression *expression, int row, int transposed){
+    if(expression->kind == EXPRESSION_TRANSPOSE){
+        return _sparse_expression_row(expression->left, row, !transposed);
+    }
+
+    Expression_Row *output = &expression->rows[transposed];
+
+    if(output->columns == NULL){
+        int width = expression->numberRows > expression->numberColumns ? expression->numberRows : expression->numberColumns;
+
+        output->columns = (int *)malloc(width * sizeof(int));
+        output->values = (matrix_value_type *)malloc(width * sizeof(matrix_value_type));
+    }
+
+    output->length = 0;
+
+    if(expression->kind == EXPRESSION_LEAF || expression->kind == EXPRESSION_MULTIPLICATION){
+        Sparse_Matrix_Cursor cursor = transposed ? sparse_matrix_column_cursor(expression->matrix, row) : sparse_matrix_row_cursor(expression->matrix, row);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            output->columns[output->length] = transposed ? cursor.row : cursor.column;
+            output->values[output->length] = cursor.value;
+            output->length++;
+        }
+
+        return output;
+    }
+
+    if(expression->kind == EXPRESSION_SCALE){
+        Expression_Row *input = _sparse_expression_row(expression->left, row, transposed);
+
+        for(int k = 0; k < input->length && expression->scalar != 0; k++){
+            output->columns[output->length] = input->columns[k];
+            output->values[output->length] = input->values[k] * expression->scalar;
+            output->length++;
+        }
+
+        return output;
+    }
+
+    Expression_Row *first = _sparse_expression_row(expression->left, row, transposed);
+    Expression_Row *second = _sparse_expression_row(expression->right, row, transposed);
+    int a = 0, b = 0;
+
+    while(a < first->length || b < second->length){
+        int column;
+        matrix_value_type data;
+
+        if(b == second->length || (a < first->length && first->columns[a] < second->columns[b])){
+            column = first->columns[a];
+            data = expression->kind == EXPRESSION_SUM ? first->values[a] : 0;
+            a++;
+        }
+
+        else if(a == first->length || second->columns[b] < first->columns[a]){
+            column = second->columns[b];
+            data = expression->kind == EXPRESSION_SUM ? second->values[b] : 0;
+            b++;
+        }
+
+        else{
+            column = first->columns[a];
+            data = expression->kind == EXPRESSION_SUM ? first->values[a] + second->values[b] : first->values[a] * second->values[b];
+            a++;
+            b++;
+        }
+
+        if(data != 0){
+            output->columns[output->length] = column;
+            output->values[output->length] = data;
+            output->length++;
+        }
+    }
+
+    return output;
+}
+
+static Sparse_Matrix *_sparse_expression_multiply(Sparse_Expression *product);
+
+/**
+ * @brief This function computes the multiplications of a region that weren't computed yet.
+ *
+ * @brief Time Complexity: the cost of the multiplications computed
+ *
+ * @param list
+ * The multiplications of the region
+ */
+static void _sparse_expression_acquire(Expression_List *list){
+    for(int i = 0; i < list->size; i++){
+        if(list->items[i]->matrix == NULL){
+            list->items[i]->matrix = _sparse_expression_multiply(list->items[i]);
+        }
+    }
+}
+
+/**
+ * @brief This function tells the multiplications of a region that the region is done, freeing each product whose last reader was this region.
+ *
+ * @brief Time Complexity: O(n), where n is the number of values of the products freed
+ *
+ * @param list
+ * The multiplications of the region (the list is freed too)
+ */
+static void _sparse_expression_release(Expression_List *list){
+    for(int i = 0; i < list->size; i++){
+        Sparse_Expression *product = list->items[i];
+
+        if(--product->uses == 0 && product->matrix){
+            sparse_matrix_destroy(product->matrix);
+            product->matrix = NULL;
+        }
+    }
+
+    free(list->items);
+}
+
+/**
+ * @brief This function compares two integers, to sort the columns of a row.
+ *
+ * @brief Time Complexity: O(1), because only two values are compared
+ */
+static int _expression_compare_columns(const void *a, const void *b){
+    return *(const int *)a - *(const int *)b;
+}
+
+/**
+ * @brief This function computes the matrix of a multiplication node. The rows of the first operand come straight from its fused region; the second operand is read in place when it's a leaf or a product (transposed or not) and is built only otherwise. Each row of the result is accumulated from the rows of the second operand (Gustavson's algorithm).
+ *
+ * @brief Time Complexity: O(f + r*log(c)), where f is the number of multiplications of non-null values and each row of the result is sorted
+ *
+ * @param product
+ * The multiplication node
+ * @return Sparse_Matrix*
+ * The new matrix with the product
+ */
+static Sparse_Matrix *_sparse_expression_multiply(Sparse_Expression *product){
+    Sparse_Expression *right = product->right;
+    int transposed = 0;
+    Sparse_Matrix *rightMatrix;
+    int ownsRight = 0;
+
+    Expression_List rightList = _sparse_expression_collect(right);
+    _sparse_expression_acquire(&rightList);
+
+    while(right->kind == EXPRESSION_TRANSPOSE){
+        transposed = !transposed;
+        right = right->left;
+    }
+
+    if(right->kind == EXPRESSION_LEAF || right->kind == EXPRESSION_MULTIPLICATION){
+        rightMatrix = right->matrix;
+    }
+
+    //The second operand is read by rows in any order, so a fused chain has to be built first
+    else{
+        Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(product->right->numberRows, product->right->numberColumns);
+
+        for(int i = 0; i < product->right->numberRows; i++){
+            Expression_Row *row = _sparse_expression_row(product->right, i, 0);
+
+            for(int k = 0; k < row->length; k++){
+                sparse_matrix_builder_append(builder, row->values[k], i, row->columns[k]);
+            }
+        }
+
+        rightMatrix = sparse_matrix_builder_finish(builder);
+        transposed = 0;
+        ownsRight = 1;
+    }
+
+    Expression_List leftList = _sparse_expression_collect(product->left);
+    _sparse_expression_acquire(&leftList);
+
+    matrix_value_type *accumulator = (matrix_value_type *)malloc(product->numberColumns * sizeof(matrix_value_type));
+    int *marker = (int *)malloc(product->numberColumns * sizeof(int));
+    int *touched = (int *)malloc(product->numberColumns * sizeof(int));
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(product->numberRows, product->numberColumns);
+
+    for(int j = 0; j < product->numberColumns; j++){
+        marker[j] = -1;
+    }
+
+    for(int i = 0; i < product->numberRows; i++){
+        Expression_Row *row = _sparse_expression_row(product->left, i, 0);
+        int numberTouched = 0;
+
+        for(int k = 0; k < row->length; k++){
+            Sparse_Matrix_Cursor cursor = transposed ? sparse_matrix_column_cursor(rightMatrix, row->columns[k]) : sparse_matrix_row_cursor(rightMatrix, row->columns[k]);
+
+            while(sparse_matrix_cursor_next(&cursor)){
+                int column = transposed ? cursor.row : cursor.column;
+
+                if(marker[column] != i){
+                    marker[column] = i;
+                    accumulator[column] = 0;
+                    touched[numberTouched++] = column;
+                }
+
+                accumulator[column] += row->values[k] * cursor.value;
+            }
+        }
+
+        qsort(touched, numberTouched, sizeof(int), _expression_compare_columns);
+
+        for(int k = 0; k < numberTouched; k++){
+            sparse_matrix_builder_append(builder, accumulator[touched[k]], i, touched[k]);
+        }
+    }
+
+    free(accumulator);
+    free(marker);
+    free(touched);
+
+    _sparse_expression_release(&leftList);
+
+    if(ownsRight){
+        sparse_matrix_destroy(rightMatrix);
+    }
+
+    _sparse_expression_release(&rightList);
+
+    return sparse_matrix_builder_finish(builder);
+}
+
+/**
+ * @brief This function evaluates an expression and returns the matrix it represents. Chains of sums, scalar multiplications, multiplications by points and transposes are fused and computed row by row in a unique pass; only the multiplications are built, and each one is freed as soon as the last node that reads it is done. Nothing is printed.
+ *
+ * @brief Time Complexity: O(n + f), where n is the number of values read from the leaves and f is the work of the multiplications
+ *
+ * @param expression
+ * The expression that will be evaluated (it can be evaluated again later)
+ * @return Sparse_Matrix*
+ * The new matrix with the result
+ */
+Sparse_Matrix *sparse_expression_evaluate(Sparse_Expression *expression){
+    evaluation_stamp++;
+
+    if(expression->kind == EXPRESSION_MULTIPLICATION){
+        _sparse_expression_count_product(expression);
+
+        return _sparse_expression_multiply(expression);
+    }
+
+    _sparse_expression_count_region(expression);
+
+    Expression_List list = _sparse_expression_collect(expression);
+    _sparse_expression_acquire(&list);
+
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(expression->numberRows, expression->numberColumns);
+
+    for(int i = 0; i < expression->numberRows; i++){
+        Expression_Row *row = _sparse_expression_row(expression, i, 0);
+
+        for(int k = 0; k < row->length; k++){
+            sparse_matrix_builder_append(builder, row->values[k], i, row->columns[k]);
+        }
+    }
+
+    _sparse_expression_release(&list);
+
+    return sparse_matrix_builder_finish(builder);
+}
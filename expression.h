@@ -0,0 +1,25 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include "matrix.h"
+
+typedef struct Sparse_Expression Sparse_Expression;
+
+//Construction functions (each one takes over the references of its operands)
+
+Sparse_Expression *sparse_expression_leaf(Sparse_Matrix *matrix);
+Sparse_Expression *sparse_expression_scale(Sparse_Expression *operand, matrix_value_type scalar);
+Sparse_Expression *sparse_expression_sum(Sparse_Expression *operand1, Sparse_Expression *operand2);
+Sparse_Expression *sparse_expression_multiply_point(Sparse_Expression *operand1, Sparse_Expression *operand2);
+Sparse_Expression *sparse_expression_transpose(Sparse_Expression *operand);
+Sparse_Expression *sparse_expression_multiplication(Sparse_Expression *operand1, Sparse_Expression *operand2);
+Sparse_Expression *sparse_expression_share(Sparse_Expression *expression);
+void sparse_expression_destroy(Sparse_Expression *expression);
+
+//Evaluation functions
+
+int sparse_expression_number_rows(Sparse_Expression *expression);
+int sparse_expression_number_columns(Sparse_Expression *expression);
+Sparse_Matrix *sparse_expression_evaluate(Sparse_Expression *expression);
+
+#endif
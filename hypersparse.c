@@ -0,0 +1,786 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "hypersparse.h"
+
+typedef struct Hypersparse_Cell{
+    hypersparse_index positionRow, positionColumn;
+    matrix_value_type value;
+    struct Hypersparse_Cell *nextRow;
+    struct Hypersparse_Cell *nextColumn;
+} Hypersparse_Cell;
+
+//A slot of a table; the slot is free when head is NULL
+typedef struct Hypersparse_Header{
+    hypersparse_index index;
+    long long length;
+    Hypersparse_Cell *head, *tail;
+} Hypersparse_Header;
+
+typedef struct Hypersparse_Table{
+    Hypersparse_Header *slots;
+    long long numberSlots, numberUsed;
+    hypersparse_index *sorted;
+} Hypersparse_Table;
+
+typedef struct Hypersparse_Matrix{
+    hypersparse_index numberRows, numberColumns;
+    long long numberNonNull;
+    Hypersparse_Table rows, columns;
+} Hypersparse_Matrix;
+
+typedef struct Hypersparse_Entry{
+    hypersparse_index column;
+    long long slot;
+    matrix_value_type value;
+} Hypersparse_Entry;
+
+/**
+ * @brief This function mixes the bits of an index (the finalizer of splitmix64), so that the indexes spread over the slots of a table.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static unsigned long long _hypersparse_hash(hypersparse_index index){
+    unsigned long long x = (unsigned long long)index;
+
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+
+    return x;
+}
+
+/**
+ * @brief This function compares two indexes, to sort them.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static int _hypersparse_compare_indexes(const void *a, const void *b){
+    hypersparse_index x = *(const hypersparse_index *)a;
+    hypersparse_index y = *(const hypersparse_index *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief This function compares two entries of a row by column, to sort them.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static int _hypersparse_compare_entries(const void *a, const void *b){
+    return _hypersparse_compare_indexes(&((const Hypersparse_Entry *)a)->column, &((const Hypersparse_Entry *)b)->column);
+}
+
+/**
+ * @brief This function allocates an empty table of headers.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static void _hypersparse_table_create(Hypersparse_Table *table){
+    table->slots = (Hypersparse_Header *)calloc(HYPERSPARSE_INITIAL_SLOTS, sizeof(Hypersparse_Header));
+    table->numberSlots = HYPERSPARSE_INITIAL_SLOTS;
+    table->numberUsed = 0;
+    table->sorted = NULL;
+}
+
+/**
+ * @brief This function finds the header of a row or column in a table (open addressing with linear probing).
+ *
+ * @brief Time Complexity: O(1) on average
+ *
+ * @return Hypersparse_Header*
+ * The header, or NULL if the row or column is empty
+ */
+static Hypersparse_Header *_hypersparse_table_find(Hypersparse_Table *table, hypersparse_index index){
+    long long mask = table->numberSlots - 1;
+
+    for(long long slot = _hypersparse_hash(index) & mask; table->slots[slot].head; slot = (slot + 1) & mask){
+        if(table->slots[slot].index == index){
+            return &table->slots[slot];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief This function claims the header of an index that isn't in a table. The table doubles when it would be more than half full. The caller must link a cell to the header before the table is used again, since a header with no cells is a free slot.
+ *
+ * @brief Time Complexity: O(1) on average (amortized, when the table doubles)
+ */
+static Hypersparse_Header *_hypersparse_table_insert(Hypersparse_Table *table, hypersparse_index index){
+    if((table->numberUsed + 1) * 2 > table->numberSlots){
+        Hypersparse_Header *old = table->slots;
+        long long numberOld = table->numberSlots;
+
+        table->numberSlots *= 2;
+        table->slots = (Hypersparse_Header *)calloc(table->numberSlots, sizeof(Hypersparse_Header));
+
+        for(long long s = 0; s < numberOld; s++){
+            if(old[s].head){
+                long long slot = _hypersparse_hash(old[s].index) & (table->numberSlots - 1);
+
+                while(table->slots[slot].head){
+                    slot = (slot + 1) & (table->numberSlots - 1);
+                }
+
+                table->slots[slot] = old[s];
+            }
+        }
+
+        free(old);
+    }
+
+    long long mask = table->numberSlots - 1;
+    long long slot = _hypersparse_hash(index) & mask;
+
+    while(table->slots[slot].head){
+        slot = (slot + 1) & mask;
+    }
+
+    table->slots[slot].index = index;
+    table->slots[slot].length = 0;
+    table->slots[slot].tail = NULL;
+    table->numberUsed++;
+
+    free(table->sorted);
+    table->sorted = NULL;
+
+    return &table->slots[slot];
+}
+
+/**
+ * @brief This function frees the header of a row or column that became empty. The headers after it in the same run are shifted back, so no search ever stops early at the freed slot.
+ *
+ * @brief Time Complexity: O(1) on average
+ */
+static void _hypersparse_table_remove(Hypersparse_Table *table, Hypersparse_Header *header){
+    long long mask = table->numberSlots - 1;
+    long long hole = header - table->slots;
+
+    table->slots[hole].head = NULL;
+
+    for(long long slot = (hole + 1) & mask; table->slots[slot].head; slot = (slot + 1) & mask){
+        long long home = _hypersparse_hash(table->slots[slot].index) & mask;
+
+        //The header stays if its home is cyclically in (hole, slot]
+        if(hole <= slot ? (hole < home && home <= slot) : (hole < home || home <= slot)){
+            continue;
+        }
+
+        table->slots[hole] = table->slots[slot];
+        table->slots[slot].head = NULL;
+        hole = slot;
+    }
+
+    table->numberUsed--;
+
+    free(table->sorted);
+    table->sorted = NULL;
+}
+
+/**
+ * @brief This function returns the indexes in a table in increasing order, sorting them again only after the table changed.
+ *
+ * @brief Time Complexity: O(1) if the table didn't change and O(s + k*log(k)) if it did, where s is the number of slots and k the number of indexes
+ */
+static const hypersparse_index *_hypersparse_table_sorted(Hypersparse_Table *table){
+    if(table->sorted == NULL){
+        long long count = 0;
+
+        table->sorted = (hypersparse_index *)malloc((table->numberUsed + 1) * sizeof(hypersparse_index));
+
+        for(long long s = 0; s < table->numberSlots; s++){
+            if(table->slots[s].head){
+                table->sorted[count++] = table->slots[s].index;
+            }
+        }
+
+        qsort(table->sorted, count, sizeof(hypersparse_index), _hypersparse_compare_indexes);
+    }
+
+    return table->sorted;
+}
+
+/**
+ * @brief This function allocates an empty hypersparse matrix. Only the non-empty rows and columns have a header, kept in hash tables indexed by 64-bit indexes, so the memory follows the number of non-null values and not the dimensions.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @return Hypersparse_Matrix*
+ * The new matrix
+ */
+Hypersparse_Matrix *hypersparse_matrix_create(){
+    Hypersparse_Matrix *matrix = (Hypersparse_Matrix *)calloc(1, sizeof(Hypersparse_Matrix));
+
+    _hypersparse_table_create(&matrix->rows);
+    _hypersparse_table_create(&matrix->columns);
+
+    return matrix;
+}
+
+/**
+ * @brief This function frees a hypersparse matrix and its cells.
+ *
+ * @brief Time Complexity: O(n + s), where s is the number of slots of the tables
+ *
+ * @param matrix
+ * The matrix that will be freed
+ */
+void hypersparse_matrix_destroy(Hypersparse_Matrix *matrix){
+    for(long long s = 0; s < matrix->rows.numberSlots; s++){
+        Hypersparse_Cell *current = matrix->rows.slots[s].head;
+
+        while(current){
+            Hypersparse_Cell *next = current->nextRow;
+            free(current);
+            current = next;
+        }
+    }
+
+    free(matrix->rows.slots);
+    free(matrix->rows.sorted);
+    free(matrix->columns.slots);
+    free(matrix->columns.sorted);
+    free(matrix);
+}
+
+/**
+ * @brief This function checks an index and raises a dimension to hold it.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static void _hypersparse_check_index(hypersparse_index *dimension, hypersparse_index index){
+    if(index < 0 || index == LLONG_MAX){
+        printf("\033[91mError: invalid index was read!\n\033[0m");
+        exit(1);
+    }
+
+    if(index >= *dimension){
+        *dimension = index + 1;
+    }
+}
+
+/**
+ * @brief This function links a new cell at the end of its row and of its column, so the values must come in row-major order (each one after every value already in its row and in its column).
+ *
+ * @brief Time Complexity: O(1) on average
+ */
+static void _hypersparse_append(Hypersparse_Matrix *matrix, matrix_value_type data, hypersparse_index row, hypersparse_index column){
+    Hypersparse_Cell *cell = (Hypersparse_Cell *)malloc(sizeof(Hypersparse_Cell));
+    Hypersparse_Header *header;
+
+    cell->positionRow = row;
+    cell->positionColumn = column;
+    cell->value = data;
+    cell->nextRow = NULL;
+    cell->nextColumn = NULL;
+
+    _hypersparse_check_index(&matrix->numberRows, row);
+    _hypersparse_check_index(&matrix->numberColumns, column);
+
+    header = _hypersparse_table_find(&matrix->rows, row);
+
+    if(header == NULL){
+        header = _hypersparse_table_insert(&matrix->rows, row);
+        header->head = cell;
+    }
+
+    else{
+        header->tail->nextRow = cell;
+    }
+
+    header->tail = cell;
+    header->length++;
+
+    header = _hypersparse_table_find(&matrix->columns, column);
+
+    if(header == NULL){
+        header = _hypersparse_table_insert(&matrix->columns, column);
+        header->head = cell;
+    }
+
+    else{
+        header->tail->nextColumn = cell;
+    }
+
+    header->tail = cell;
+    header->length++;
+
+    matrix->numberNonNull++;
+}
+
+/**
+ * @brief This function converts a sparse matrix to the hypersparse form.
+ *
+ * @brief Time Complexity: O(n + r), because each row is visited once and each value is appended once
+ *
+ * @param matrix
+ * The sparse matrix that will be converted
+ * @return Hypersparse_Matrix*
+ * The new hypersparse matrix, with the same dimensions
+ */
+Hypersparse_Matrix *hypersparse_matrix_from_sparse(Sparse_Matrix *matrix){
+    Hypersparse_Matrix *hypersparse = hypersparse_matrix_create();
+
+    for(int i = 0; i < sparse_matrix_number_rows(matrix); i++){
+        Sparse_Matrix_Cursor cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            _hypersparse_append(hypersparse, cursor.value, cursor.row, cursor.column);
+        }
+    }
+
+    hypersparse->numberRows = sparse_matrix_number_rows(matrix);
+    hypersparse->numberColumns = sparse_matrix_number_columns(matrix);
+
+    return hypersparse;
+}
+
+/**
+ * @brief This function converts a hypersparse matrix to the usual sparse form, whose headers cover every row and column; the dimensions must fit in an int.
+ *
+ * @brief Time Complexity: O(n + r + c + k*log(k)), where k is the number of non-empty rows
+ *
+ * @param matrix
+ * The hypersparse matrix that will be converted
+ * @return Sparse_Matrix*
+ * The new sparse matrix, with the same dimensions
+ */
+Sparse_Matrix *hypersparse_matrix_to_sparse(Hypersparse_Matrix *matrix){
+    if(matrix->numberRows > INT_MAX || matrix->numberColumns > INT_MAX){
+        printf("\033[91mError: the matrix is too large for the sparse form!\n\033[0m");
+        exit(1);
+    }
+
+    if(matrix->numberRows == 0 || matrix->numberColumns == 0){
+        return sparse_matrix_create();
+    }
+
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(matrix->numberRows, matrix->numberColumns);
+    const hypersparse_index *rows = _hypersparse_table_sorted(&matrix->rows);
+
+    for(long long r = 0; r < matrix->rows.numberUsed; r++){
+        for(Hypersparse_Cell *current = _hypersparse_table_find(&matrix->rows, rows[r])->head; current; current = current->nextRow){
+            sparse_matrix_builder_append(builder, current->value, current->positionRow, current->positionColumn);
+        }
+    }
+
+    return sparse_matrix_builder_finish(builder);
+}
+
+/**
+ * @brief This function returns the number of rows of the matrix (the highest row index used plus one).
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @return hypersparse_index
+ * The number of rows
+ */
+hypersparse_index hypersparse_matrix_number_rows(Hypersparse_Matrix *matrix){
+    return matrix->numberRows;
+}
+
+/**
+ * @brief This function returns the number of columns of the matrix (the highest column index used plus one).
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @return hypersparse_index
+ * The number of columns
+ */
+hypersparse_index hypersparse_matrix_number_columns(Hypersparse_Matrix *matrix){
+    return matrix->numberColumns;
+}
+
+/**
+ * @brief This function returns the number of non-null values of the matrix.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @return long long
+ * The number of non-null values
+ */
+long long hypersparse_matrix_number_non_null(Hypersparse_Matrix *matrix){
+    return matrix->numberNonNull;
+}
+
+/**
+ * @brief This function returns the number of rows with at least one non-null value.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @return long long
+ * The number of non-empty rows
+ */
+long long hypersparse_matrix_number_non_empty_rows(Hypersparse_Matrix *matrix){
+    return matrix->rows.numberUsed;
+}
+
+/**
+ * @brief This function returns the number of columns with at least one non-null value.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @return long long
+ * The number of non-empty columns
+ */
+long long hypersparse_matrix_number_non_empty_columns(Hypersparse_Matrix *matrix){
+    return matrix->columns.numberUsed;
+}
+
+/**
+ * @brief This function returns the indexes of the non-empty rows in increasing order (the row list of the DCSR form). The array belongs to the matrix and is valid until a row becomes empty or non-empty.
+ *
+ * @brief Time Complexity: O(1) if no row became empty or non-empty since the last call and O(s + k*log(k)) if not, where s is the number of slots and k the number of non-empty rows
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @return const hypersparse_index*
+ * The indexes, as many as hypersparse_matrix_number_non_empty_rows
+ */
+const hypersparse_index *hypersparse_matrix_row_indexes(Hypersparse_Matrix *matrix){
+    return _hypersparse_table_sorted(&matrix->rows);
+}
+
+/**
+ * @brief This function creates a cursor over the non-null values of a row, in increasing order of columns.
+ *
+ * @brief Time Complexity: O(1) on average
+ *
+ * @param matrix
+ * The matrix that will be walked
+ * @param row
+ * The row walked
+ * @return Hypersparse_Cursor
+ * The cursor, before the first value
+ */
+Hypersparse_Cursor hypersparse_matrix_row_cursor(Hypersparse_Matrix *matrix, hypersparse_index row){
+    Hypersparse_Header *header = _hypersparse_table_find(&matrix->rows, row);
+    Hypersparse_Cursor cursor = {header ? header->head : NULL, 0, row, -1, 0};
+
+    return cursor;
+}
+
+/**
+ * @brief This function creates a cursor over the non-null values of a column, in increasing order of rows.
+ *
+ * @brief Time Complexity: O(1) on average
+ *
+ * @param matrix
+ * The matrix that will be walked
+ * @param column
+ * The column walked
+ * @return Hypersparse_Cursor
+ * The cursor, before the first value
+ */
+Hypersparse_Cursor hypersparse_matrix_column_cursor(Hypersparse_Matrix *matrix, hypersparse_index column){
+    Hypersparse_Header *header = _hypersparse_table_find(&matrix->columns, column);
+    Hypersparse_Cursor cursor = {header ? header->head : NULL, 1, -1, column, 0};
+
+    return cursor;
+}
+
+/**
+ * @brief This function moves a cursor to the next value. The matrix must not change while the cursor is used.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @param cursor
+ * The cursor that will be moved
+ * @return int
+ * 1 if the cursor has a value (in row, column and value) or 0 if the row or column ended
+ */
+int hypersparse_matrix_cursor_next(Hypersparse_Cursor *cursor){
+    Hypersparse_Cell *current = cursor->cell;
+
+    if(current == NULL){
+        return 0;
+    }
+
+    cursor->row = current->positionRow;
+    cursor->column = current->positionColumn;
+    cursor->value = current->value;
+    cursor->cell = cursor->byColumn ? current->nextColumn : current->nextRow;
+
+    return 1;
+}
+
+/**
+ * @brief This function puts a value in the matrix by the index. A null value removes the value stored there, and a row or column left empty loses its header. As in sparse_matrix_set_by_index, the dimensions grow to hold the index even for a null value.
+ *
+ * @brief Time Complexity: O(a + b) on average, where a and b are the lengths of the row and of the column
+ *
+ * @param matrix
+ * The matrix that will be changed
+ * @param data
+ * The value that will be put
+ * @param row
+ * The row wanted
+ * @param column
+ * The column wanted
+ */
+void hypersparse_matrix_set_by_index(Hypersparse_Matrix *matrix, matrix_value_type data, hypersparse_index row, hypersparse_index column){
+    _hypersparse_check_index(&matrix->numberRows, row);
+    _hypersparse_check_index(&matrix->numberColumns, column);
+
+    Hypersparse_Header *rowHeader = _hypersparse_table_find(&matrix->rows, row);
+    Hypersparse_Cell *current = rowHeader ? rowHeader->head : NULL;
+    Hypersparse_Cell *previous = NULL;
+
+    while(current && current->positionColumn < column){
+        previous = current;
+        current = current->nextRow;
+    }
+
+    if(current && current->positionColumn == column){
+        if(data != 0){
+            current->value = data;
+            return;
+        }
+
+        //The cell leaves its row and its column
+        if(previous){
+            previous->nextRow = current->nextRow;
+        }
+
+        else{
+            rowHeader->head = current->nextRow;
+        }
+
+        if(rowHeader->tail == current){
+            rowHeader->tail = previous;
+        }
+
+        if(--rowHeader->length == 0){
+            _hypersparse_table_remove(&matrix->rows, rowHeader);
+        }
+
+        Hypersparse_Header *columnHeader = _hypersparse_table_find(&matrix->columns, column);
+        Hypersparse_Cell *above = NULL;
+
+        for(Hypersparse_Cell *cell = columnHeader->head; cell != current; cell = cell->nextColumn){
+            above = cell;
+        }
+
+        if(above){
+            above->nextColumn = current->nextColumn;
+        }
+
+        else{
+            columnHeader->head = current->nextColumn;
+        }
+
+        if(columnHeader->tail == current){
+            columnHeader->tail = above;
+        }
+
+        if(--columnHeader->length == 0){
+            _hypersparse_table_remove(&matrix->columns, columnHeader);
+        }
+
+        free(current);
+        matrix->numberNonNull--;
+        return;
+    }
+
+    if(data == 0){
+        return;
+    }
+
+    Hypersparse_Cell *cell = (Hypersparse_Cell *)malloc(sizeof(Hypersparse_Cell));
+
+    cell->positionRow = row;
+    cell->positionColumn = column;
+    cell->value = data;
+    cell->nextRow = current;
+    cell->nextColumn = NULL;
+
+    if(rowHeader == NULL){
+        rowHeader = _hypersparse_table_insert(&matrix->rows, row);
+        rowHeader->head = cell;
+    }
+
+    else if(previous){
+        previous->nextRow = cell;
+    }
+
+    else{
+        rowHeader->head = cell;
+    }
+
+    if(current == NULL){
+        rowHeader->tail = cell;
+    }
+
+    rowHeader->length++;
+
+    //The column is kept sorted by row
+    Hypersparse_Header *columnHeader = _hypersparse_table_find(&matrix->columns, column);
+
+    if(columnHeader == NULL){
+        columnHeader = _hypersparse_table_insert(&matrix->columns, column);
+        columnHeader->head = cell;
+        columnHeader->tail = cell;
+    }
+
+    else{
+        Hypersparse_Cell *above = NULL;
+        Hypersparse_Cell *below = columnHeader->head;
+
+        while(below && below->positionRow < row){
+            above = below;
+            below = below->nextColumn;
+        }
+
+        cell->nextColumn = below;
+
+        if(above){
+            above->nextColumn = cell;
+        }
+
+        else{
+            columnHeader->head = cell;
+        }
+
+        if(below == NULL){
+            columnHeader->tail = cell;
+        }
+    }
+
+    columnHeader->length++;
+    matrix->numberNonNull++;
+}
+
+/**
+ * @brief This function returns the value of an index of the matrix (0 if nothing is stored there).
+ *
+ * @brief Time Complexity: O(a) on average, where a is the length of the row
+ *
+ * @param matrix
+ * The matrix that will be evaluated
+ * @param row
+ * The row wanted
+ * @param column
+ * The column wanted
+ * @return matrix_value_type
+ * The value of the index
+ */
+matrix_value_type hypersparse_matrix_get_by_index(Hypersparse_Matrix *matrix, hypersparse_index row, hypersparse_index column){
+    Hypersparse_Header *header = _hypersparse_table_find(&matrix->rows, row);
+
+    for(Hypersparse_Cell *current = header ? header->head : NULL; current && current->positionColumn <= column; current = current->nextRow){
+        if(current->positionColumn == column){
+            return current->value;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief This function multiplies two hypersparse matrices with Gustavson's algorithm over the non-empty rows only: each row of matrix1 accumulates the rows of matrix2 in a hash table sized for the row, which is then sorted by column and appended. No array has the size of a dimension, so the indexes may be any 64-bit values. The columns of matrix1 must match the rows of matrix2; since the dimensions follow the highest index set, a null value put at a corner fixes them. The product has the rows of matrix1 and the columns of matrix2.
+ *
+ * @brief Time Complexity: O(f + k*log(k) + p*log(p)) on average, where f is the number of multiplications of non-null values, k is the number of non-empty rows of matrix1 and p is the largest number of values of a row of the product
+ *
+ * @param matrix1
+ * The first matrix to multiply
+ * @param matrix2
+ * The second matrix to multiply
+ * @return Hypersparse_Matrix*
+ * The new matrix with the product
+ */
+Hypersparse_Matrix *hypersparse_matrix_multiplication(Hypersparse_Matrix *matrix1, Hypersparse_Matrix *matrix2){
+    if(matrix1->numberColumns != matrix2->numberRows){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    Hypersparse_Matrix *result = hypersparse_matrix_create();
+    const hypersparse_index *rows = _hypersparse_table_sorted(&matrix1->rows);
+    long long numberSlots = 0;
+    long long *slots = NULL;
+    Hypersparse_Entry *entries = NULL;
+
+    for(long long r = 0; r < matrix1->rows.numberUsed; r++){
+        Hypersparse_Header *rowHeader = _hypersparse_table_find(&matrix1->rows, rows[r]);
+        long long bound = 0;
+
+        for(Hypersparse_Cell *first = rowHeader->head; first; first = first->nextRow){
+            Hypersparse_Header *other = _hypersparse_table_find(&matrix2->rows, first->positionColumn);
+
+            bound += other ? other->length : 0;
+        }
+
+        if(bound == 0){
+            continue;
+        }
+
+        //The accumulator is at most half full; a slot holds the position of its entry plus one
+        if(2 * bound > numberSlots){
+            while(2 * bound > numberSlots){
+                numberSlots = numberSlots ? 2 * numberSlots : HYPERSPARSE_INITIAL_SLOTS;
+            }
+
+            free(slots);
+            free(entries);
+            slots = (long long *)calloc(numberSlots, sizeof(long long));
+            entries = (Hypersparse_Entry *)malloc((numberSlots / 2) * sizeof(Hypersparse_Entry));
+        }
+
+        long long numberEntries = 0;
+
+        for(Hypersparse_Cell *first = rowHeader->head; first; first = first->nextRow){
+            Hypersparse_Header *other = _hypersparse_table_find(&matrix2->rows, first->positionColumn);
+
+            for(Hypersparse_Cell *second = other ? other->head : NULL; second; second = second->nextRow){
+                long long slot = _hypersparse_hash(second->positionColumn) & (numberSlots - 1);
+
+                while(slots[slot] && entries[slots[slot] - 1].column != second->positionColumn){
+                    slot = (slot + 1) & (numberSlots - 1);
+                }
+
+                if(slots[slot] == 0){
+                    entries[numberEntries].column = second->positionColumn;
+                    entries[numberEntries].slot = slot;
+                    entries[numberEntries].value = 0;
+                    slots[slot] = ++numberEntries;
+                }
+
+                entries[slots[slot] - 1].value += first->value * second->value;
+            }
+        }
+
+        qsort(entries, numberEntries, sizeof(Hypersparse_Entry), _hypersparse_compare_entries);
+
+        for(long long e = 0; e < numberEntries; e++){
+            if(entries[e].value != 0){
+                _hypersparse_append(result, entries[e].value, rows[r], entries[e].column);
+            }
+
+            //Only the slots used by this row are cleared
+            slots[entries[e].slot] = 0;
+        }
+    }
+
+    free(slots);
+    free(entries);
+
+    //The trailing rows and columns may have no values
+    result->numberRows = matrix1->numberRows;
+    result->numberColumns = matrix2->numberColumns;
+
+    return result;
+}
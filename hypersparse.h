@@ -0,0 +1,50 @@
+#ifndef HYPERSPARSE_H
+#define HYPERSPARSE_H
+
+#include "matrix.h"
+
+typedef long long hypersparse_index;
+typedef struct Hypersparse_Matrix Hypersparse_Matrix;
+
+typedef struct Hypersparse_Cursor{
+    void *cell;
+    int byColumn;
+    hypersparse_index row, column;
+    matrix_value_type value;
+} Hypersparse_Cursor;
+
+//Initial number of slots of the tables of rows and columns (a power of two)
+#define HYPERSPARSE_INITIAL_SLOTS 16
+
+//Allocation functions
+
+Hypersparse_Matrix *hypersparse_matrix_create();
+void hypersparse_matrix_destroy(Hypersparse_Matrix *matrix);
+Hypersparse_Matrix *hypersparse_matrix_from_sparse(Sparse_Matrix *matrix);
+Sparse_Matrix *hypersparse_matrix_to_sparse(Hypersparse_Matrix *matrix);
+
+//Dimension functions
+
+hypersparse_index hypersparse_matrix_number_rows(Hypersparse_Matrix *matrix);
+hypersparse_index hypersparse_matrix_number_columns(Hypersparse_Matrix *matrix);
+long long hypersparse_matrix_number_non_null(Hypersparse_Matrix *matrix);
+long long hypersparse_matrix_number_non_empty_rows(Hypersparse_Matrix *matrix);
+long long hypersparse_matrix_number_non_empty_columns(Hypersparse_Matrix *matrix);
+const hypersparse_index *hypersparse_matrix_row_indexes(Hypersparse_Matrix *matrix);
+
+//Iteration functions
+
+Hypersparse_Cursor hypersparse_matrix_row_cursor(Hypersparse_Matrix *matrix, hypersparse_index row);
+Hypersparse_Cursor hypersparse_matrix_column_cursor(Hypersparse_Matrix *matrix, hypersparse_index column);
+int hypersparse_matrix_cursor_next(Hypersparse_Cursor *cursor);
+
+//Setters and getters functions
+
+void hypersparse_matrix_set_by_index(Hypersparse_Matrix *matrix, matrix_value_type data, hypersparse_index row, hypersparse_index column);
+matrix_value_type hypersparse_matrix_get_by_index(Hypersparse_Matrix *matrix, hypersparse_index row, hypersparse_index column);
+
+//Operation functions with matrices
+
+Hypersparse_Matrix *hypersparse_matrix_multiplication(Hypersparse_Matrix *matrix1, Hypersparse_Matrix *matrix2);
+
+#endif
@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "instrument.h"
+
+typedef struct Instrument_Event{
+    int operation, thread;
+    unsigned long long begin, duration;
+} Instrument_Event;
+
+static unsigned long long counters[INSTRUMENT_NUMBER_COUNTERS];
+static unsigned long long calls[INSTRUMENT_NUMBER_OPERATIONS];
+static unsigned long long nanoseconds[INSTRUMENT_NUMBER_OPERATIONS];
+static Instrument_Event events[INSTRUMENT_MAX_EVENTS];
+static unsigned long long numberEvents;
+static unsigned long long origin;
+static int numberThreads;
+static __thread int thread_id;
+
+static const char *counter_names[INSTRUMENT_NUMBER_COUNTERS] = {
+    "cells_allocated", "cells_freed", "nodes_traversed", "realloc_calls", "bytes_written", "bytes_read"
+};
+
+static const char *operation_names[INSTRUMENT_NUMBER_OPERATIONS] = {
+    "sparse_matrix_create", "sparse_matrix_destroy", "sparse_matrix_set_by_index", "sparse_matrix_get_by_index",
+    "sparse_matrix_multiply_vector", "sparse_matrix_multiply_scalar", "sparse_matrix_sum", "sparse_matrix_multiplication",
+    "sparse_matrix_multiply_point", "sparse_matrix_transpose", "sparse_matrix_swap_columns", "sparse_matrix_swap_rows",
+    "sparse_matrix_slice", "sparse_matrix_convolution", "sparse_matrix_binary_save", "sparse_matrix_binary_read",
+    "sparse_matrix_axpby", "sparse_matrix_axpy", "sparse_matrix_multiplication_masked",
+    "sparse_matrix_compressed_save", "sparse_matrix_compressed_read", "sparse_matrix_binary_read_parallel",
+    "sparse_matrix_hstack", "sparse_matrix_vstack", "sparse_matrix_block_diagonal", "sparse_matrix_kronecker",
+    "sparse_matrix_compact", "sparse_matrix_multiplication_semiring",
+    "sparse_matrix_multiplication_pruned", "sparse_matrix_prune",
+    "sparse_matrix_multiplication_to_file"
+};
+
+/**
+ * @brief This function returns the current time of a monotonic clock.
+ *
+ * @brief Time Complexity: O(1), because only the clock is read
+ *
+ * @return unsigned long long
+ * The time in nanoseconds
+ */
+unsigned long long instrument_now(){
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * @brief This function adds an amount to a counter. The addition is atomic, so threads can share the counters.
+ *
+ * @brief Time Complexity: O(1), because only one value is changed
+ *
+ * @param counter
+ * The counter that will be increased
+ * @param amount
+ * The amount added
+ */
+void instrument_count(Instrument_Counter counter, unsigned long long amount){
+    __atomic_fetch_add(&counters[counter], amount, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief This function records a call of a public operation: its time is added to the totals and, while there is room, the call is kept for the timeline.
+ *
+ * @brief Time Complexity: O(1), because only one slot of the timeline is written
+ *
+ * @param operation
+ * The operation that was called
+ * @param begin
+ * The time (from instrument_now) when the operation began
+ */
+void instrument_record(Instrument_Operation operation, unsigned long long begin){
+    unsigned long long duration = instrument_now() - begin;
+
+    __atomic_fetch_add(&calls[operation], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&nanoseconds[operation], duration, __ATOMIC_RELAXED);
+
+    if(thread_id == 0){
+        thread_id = __atomic_add_fetch(&numberThreads, 1, __ATOMIC_RELAXED);
+    }
+
+    unsigned long long slot = __atomic_fetch_add(&numberEvents, 1, __ATOMIC_RELAXED);
+
+    if(slot < INSTRUMENT_MAX_EVENTS){
+        events[slot].operation = operation;
+        events[slot].thread = thread_id;
+        events[slot].begin = begin;
+        events[slot].duration = duration;
+    }
+}
+
+/**
+ * @brief This function tells if the library was built with the instrumentation hooks.
+ *
+ * @brief Time Complexity: O(1), because the answer is decided at compile time
+ *
+ * @return int
+ * 1 if the hooks are compiled in or 0 if not (the stats stay at zero)
+ */
+int instrument_enabled(){
+#ifdef SPARSE_MATRIX_INSTRUMENT
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief This function returns a copy of the counters and of the time spent in each operation since the last reset.
+ *
+ * @brief Time Complexity: O(1), because the number of counters and operations is constant
+ *
+ * @return Instrument_Stats
+ * The current stats
+ */
+Instrument_Stats instrument_stats(){
+    Instrument_Stats stats;
+
+    for(int i = 0; i < INSTRUMENT_NUMBER_COUNTERS; i++){
+        stats.counters[i] = __atomic_load_n(&counters[i], __ATOMIC_RELAXED);
+    }
+
+    for(int i = 0; i < INSTRUMENT_NUMBER_OPERATIONS; i++){
+        stats.calls[i] = __atomic_load_n(&calls[i], __ATOMIC_RELAXED);
+        stats.nanoseconds[i] = __atomic_load_n(&nanoseconds[i], __ATOMIC_RELAXED);
+    }
+
+    unsigned long long total = __atomic_load_n(&numberEvents, __ATOMIC_RELAXED);
+
+    stats.recordedEvents = total < INSTRUMENT_MAX_EVENTS ? total : INSTRUMENT_MAX_EVENTS;
+    stats.droppedEvents = total - stats.recordedEvents;
+
+    return stats;
+}
+
+/**
+ * @brief This function sets the counters, the totals and the timeline back to zero. It must not run while other threads use the library.
+ *
+ * @brief Time Complexity: O(1), because the number of counters and operations is constant
+ */
+void instrument_reset(){
+    for(int i = 0; i < INSTRUMENT_NUMBER_COUNTERS; i++){
+        counters[i] = 0;
+    }
+
+    for(int i = 0; i < INSTRUMENT_NUMBER_OPERATIONS; i++){
+        calls[i] = 0;
+        nanoseconds[i] = 0;
+    }
+
+    numberEvents = 0;
+    origin = instrument_now();
+}
+
+/**
+ * @brief This function returns the name of a counter.
+ *
+ * @brief Time Complexity: O(1), because the names are constant
+ *
+ * @param counter
+ * The counter wanted
+ * @return const char*
+ * The name of the counter
+ */
+const char *instrument_counter_name(Instrument_Counter counter){
+    return counter_names[counter];
+}
+
+/**
+ * @brief This function returns the name of an operation.
+ *
+ * @brief Time Complexity: O(1), because the names are constant
+ *
+ * @param operation
+ * The operation wanted
+ * @return const char*
+ * The name of the operation
+ */
+const char *instrument_operation_name(Instrument_Operation operation){
+    return operation_names[operation];
+}
+
+/**
+ * @brief This function shows on the screen the counters and the time spent in each operation that was called.
+ *
+ * @brief Time Complexity: O(1), because the number of counters and operations is constant
+ */
+void instrument_show(){
+    Instrument_Stats stats = instrument_stats();
+
+    printf("\033[92mSHOW INSTRUMENTATION:\nENABLED: %s\n\n\033[0m", instrument_enabled() ? "yes" : "no");
+
+    for(int i = 0; i < INSTRUMENT_NUMBER_COUNTERS; i++){
+        printf("\033[95m%s\033[0m \033[97m--> \033[0m%llu\n", counter_names[i], stats.counters[i]);
+    }
+
+    for(int i = 0; i < INSTRUMENT_NUMBER_OPERATIONS; i++){
+        if(stats.calls[i]){
+            printf("\033[95m%s\033[0m \033[97m--> \033[0m%llu calls, %.3f ms\n", operation_names[i], stats.calls[i], stats.nanoseconds[i] / 1e6);
+        }
+    }
+}
+
+/**
+ * @brief This function writes the recorded calls as a Chrome trace-event JSON file (chrome://tracing or Perfetto), one complete event per call and one counter event with the final values of the counters.
+ *
+ * @brief Time Complexity: O(e), because each of the e recorded calls is written once
+ *
+ * @param path
+ * The path of the file that will be created
+ */
+void instrument_export_trace(const char *path){
+    FILE *fp = fopen(path, "w");
+
+    if(!fp){
+        printf("\033[91mError: Couldn't create the file!\n\033[0m");
+        exit(1);
+    }
+
+    Instrument_Stats stats = instrument_stats();
+    unsigned long long end = instrument_now();
+
+    //Without a reset, the timeline starts at the first recorded call
+    if(origin == 0){
+        origin = end;
+
+        for(unsigned long long i = 0; i < stats.recordedEvents; i++){
+            if(events[i].begin < origin){
+                origin = events[i].begin;
+            }
+        }
+    }
+
+    fprintf(fp, "{\"traceEvents\": [\n");
+
+    for(unsigned long long i = 0; i < stats.recordedEvents; i++){
+        Instrument_Event *event = &events[i];
+        double begin = event->begin > origin ? (event->begin - origin) / 1e3 : 0;
+
+        fprintf(fp, "{\"name\": \"%s\", \"cat\": \"sparse_matrix\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d},\n",
+            operation_names[event->operation], begin, event->duration / 1e3, event->thread);
+    }
+
+    fprintf(fp, "{\"name\": \"counters\", \"ph\": \"C\", \"ts\": %.3f, \"pid\": 1, \"args\": {", end > origin ? (end - origin) / 1e3 : 0);
+
+    for(int i = 0; i < INSTRUMENT_NUMBER_COUNTERS; i++){
+        fprintf(fp, "%s\"%s\": %llu", i ? ", " : "", counter_names[i], stats.counters[i]);
+    }
+
+    fprintf(fp, "}}\n], \"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped_events\": %llu}}\n", stats.droppedEvents);
+
+    fclose(fp);
+}
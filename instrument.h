@@ -0,0 +1,86 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+typedef enum{
+    INSTRUMENT_CELLS_ALLOCATED,
+    INSTRUMENT_CELLS_FREED,
+    INSTRUMENT_NODES_TRAVERSED,
+    INSTRUMENT_REALLOC_CALLS,
+    INSTRUMENT_BYTES_WRITTEN,
+    INSTRUMENT_BYTES_READ,
+    INSTRUMENT_NUMBER_COUNTERS
+} Instrument_Counter;
+
+typedef enum{
+    INSTRUMENT_OP_CREATE,
+    INSTRUMENT_OP_DESTROY,
+    INSTRUMENT_OP_SET_BY_INDEX,
+    INSTRUMENT_OP_GET_BY_INDEX,
+    INSTRUMENT_OP_MULTIPLY_VECTOR,
+    INSTRUMENT_OP_MULTIPLY_SCALAR,
+    INSTRUMENT_OP_SUM,
+    INSTRUMENT_OP_MULTIPLICATION,
+    INSTRUMENT_OP_MULTIPLY_POINT,
+    INSTRUMENT_OP_TRANSPOSE,
+    INSTRUMENT_OP_SWAP_COLUMNS,
+    INSTRUMENT_OP_SWAP_ROWS,
+    INSTRUMENT_OP_SLICE,
+    INSTRUMENT_OP_CONVOLUTION,
+    INSTRUMENT_OP_BINARY_SAVE,
+    INSTRUMENT_OP_BINARY_READ,
+    INSTRUMENT_OP_AXPBY,
+    INSTRUMENT_OP_AXPY,
+    INSTRUMENT_OP_MULTIPLICATION_MASKED,
+    INSTRUMENT_OP_COMPRESSED_SAVE,
+    INSTRUMENT_OP_COMPRESSED_READ,
+    INSTRUMENT_OP_BINARY_READ_PARALLEL,
+    INSTRUMENT_OP_HSTACK,
+    INSTRUMENT_OP_VSTACK,
+    INSTRUMENT_OP_BLOCK_DIAGONAL,
+    INSTRUMENT_OP_KRONECKER,
+    INSTRUMENT_OP_COMPACT,
+    INSTRUMENT_OP_MULTIPLICATION_SEMIRING,
+    INSTRUMENT_OP_MULTIPLICATION_PRUNED,
+    INSTRUMENT_OP_PRUNE,
+    INSTRUMENT_OP_MULTIPLICATION_TO_FILE,
+    INSTRUMENT_NUMBER_OPERATIONS
+} Instrument_Operation;
+
+typedef struct Instrument_Stats{
+    unsigned long long counters[INSTRUMENT_NUMBER_COUNTERS];
+    unsigned long long calls[INSTRUMENT_NUMBER_OPERATIONS];
+    unsigned long long nanoseconds[INSTRUMENT_NUMBER_OPERATIONS];
+    unsigned long long recordedEvents, droppedEvents;
+} Instrument_Stats;
+
+//Maximum number of operation calls kept for the timeline (the totals keep counting after it's full)
+#define INSTRUMENT_MAX_EVENTS 65536
+
+//The hooks are compiled out unless the library is built with -DSPARSE_MATRIX_INSTRUMENT (make INSTRUMENT=1)
+#ifdef SPARSE_MATRIX_INSTRUMENT
+#define INSTRUMENT_COUNT(counter, amount) instrument_count(counter, amount)
+#define INSTRUMENT_BEGIN() unsigned long long instrument_begin = instrument_now()
+#define INSTRUMENT_END(operation) instrument_record(operation, instrument_begin)
+#else
+#define INSTRUMENT_COUNT(counter, amount) ((void)(amount))
+#define INSTRUMENT_BEGIN() ((void)0)
+#define INSTRUMENT_END(operation) ((void)0)
+#endif
+
+//Hook functions
+
+unsigned long long instrument_now();
+void instrument_count(Instrument_Counter counter, unsigned long long amount);
+void instrument_record(Instrument_Operation operation, unsigned long long begin);
+
+//Stats functions
+
+int instrument_enabled();
+Instrument_Stats instrument_stats();
+void instrument_reset();
+const char *instrument_counter_name(Instrument_Counter counter);
+const char *instrument_operation_name(Instrument_Operation operation);
+void instrument_show();
+void instrument_export_trace(const char *path);
+
+#endif
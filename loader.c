@@ -0,0 +1,424 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "cell.h"
+#include "loader.h"
+#include "compress.h"
+#include "instrument.h"
+
+typedef struct Loader_Triplet{
+    int row, column;
+    float value;
+    int order;
+} Loader_Triplet;
+
+typedef struct Loader Loader;
+
+typedef struct Loader_Thread{
+    Loader *loader;
+    int id;
+    long begin, end;
+    Loader_Triplet *triplets;
+    int maxRow, maxColumn;
+    long *bucketCounts;
+    long *bucketOffsets;
+    Cell **columnHeads;
+    Cell **columnTails;
+    int linked;
+} Loader_Thread;
+
+typedef struct Loader{
+    const char *path;
+    int numberThreads;
+    long numberEntries;
+    int numberRows, numberColumns;
+    Loader_Triplet *sorted;
+    long *bucketBegin;
+    Cell **rows;
+    Cell **columns;
+    Loader_Thread *threads;
+} Loader;
+
+/**
+ * @brief This function runs a phase of the load: one call of the function per thread, all at the same time, and waits for them.
+ *
+ * @brief Time Complexity: the time of the slowest thread
+ *
+ * @param loader
+ * The load in progress
+ * @param phase
+ * The function that each thread runs with its Loader_Thread
+ */
+static void _loader_run(Loader *loader, void *(*phase)(void *)){
+    pthread_t *handles = (pthread_t *)malloc(loader->numberThreads * sizeof(pthread_t));
+
+    for(int t = 0; t < loader->numberThreads; t++){
+        if(pthread_create(&handles[t], NULL, phase, &loader->threads[t])){
+            printf("\033[91mError: Couldn't start the loader threads!\n\033[0m");
+            exit(1);
+        }
+    }
+
+    for(int t = 0; t < loader->numberThreads; t++){
+        pthread_join(handles[t], NULL);
+    }
+
+    free(handles);
+}
+
+/**
+ * @brief This function returns the bucket of a row: the rows are split in one contiguous range per thread.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static int _loader_bucket(Loader *loader, int row){
+    return (int)((long)row * loader->numberThreads / loader->numberRows);
+}
+
+/**
+ * @brief This function decodes the byte range of a thread into its own triplets, reading the file in large chunks with its own stream.
+ *
+ * @brief Time Complexity: O(k), where k is the number of values of the range
+ *
+ * @param argument
+ * The Loader_Thread of the thread
+ * @return void*
+ * NULL
+ */
+static void *_loader_decode(void *argument){
+    Loader_Thread *thread = argument;
+    FILE *fp = fopen(thread->loader->path, "rb");
+    long count = thread->end - thread->begin;
+    unsigned char *chunk = (unsigned char *)malloc((size_t)LOADER_CHUNK_ENTRIES * 12);
+
+    if(!fp){
+        printf("\033[91mError: Couldn't open the file!\n\033[0m");
+        exit(1);
+    }
+
+    thread->triplets = (Loader_Triplet *)malloc((count + 1) * sizeof(Loader_Triplet));
+    thread->maxRow = -1;
+    thread->maxColumn = -1;
+
+    fseek(fp, sizeof(int) + thread->begin * 12, SEEK_SET);
+
+    for(long done = 0; done < count; ){
+        long size = count - done < LOADER_CHUNK_ENTRIES ? count - done : LOADER_CHUNK_ENTRIES;
+
+        if(fread(chunk, 12, size, fp) != (size_t)size){
+            printf("\033[91mError: The file is truncated!\n\033[0m");
+            exit(1);
+        }
+
+        INSTRUMENT_COUNT(INSTRUMENT_BYTES_READ, size * 12);
+
+        for(long k = 0; k < size; k++){
+            Loader_Triplet *triplet = &thread->triplets[done + k];
+
+            memcpy(&triplet->row, chunk + k * 12, sizeof(int));
+            memcpy(&triplet->column, chunk + k * 12 + 4, sizeof(int));
+            memcpy(&triplet->value, chunk + k * 12 + 8, sizeof(float));
+
+            if(triplet->row < 0 || triplet->column < 0){
+                printf("\033[91mError: invalid index was read!\n\033[0m");
+                exit(1);
+            }
+
+            if(triplet->row > thread->maxRow){
+                thread->maxRow = triplet->row;
+            }
+
+            if(triplet->column > thread->maxColumn){
+                thread->maxColumn = triplet->column;
+            }
+        }
+
+        done += size;
+    }
+
+    free(chunk);
+    fclose(fp);
+
+    return NULL;
+}
+
+/**
+ * @brief This function counts how many triplets of a thread fall in each row bucket.
+ *
+ * @brief Time Complexity: O(k), where k is the number of triplets of the thread
+ */
+static void *_loader_count(void *argument){
+    Loader_Thread *thread = argument;
+    Loader *loader = thread->loader;
+
+    thread->bucketCounts = (long *)calloc(loader->numberThreads, sizeof(long));
+
+    for(long k = 0; k < thread->end - thread->begin; k++){
+        thread->bucketCounts[_loader_bucket(loader, thread->triplets[k].row)]++;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief This function moves the triplets of a thread to their buckets. Inside a bucket, the triplets keep the order of the file.
+ *
+ * @brief Time Complexity: O(k), where k is the number of triplets of the thread
+ */
+static void *_loader_scatter(void *argument){
+    Loader_Thread *thread = argument;
+    Loader *loader = thread->loader;
+
+    for(long k = 0; k < thread->end - thread->begin; k++){
+        int bucket = _loader_bucket(loader, thread->triplets[k].row);
+
+        loader->sorted[thread->bucketOffsets[bucket]++] = thread->triplets[k];
+    }
+
+    free(thread->triplets);
+    thread->triplets = NULL;
+
+    return NULL;
+}
+
+/**
+ * @brief This function compares two triplets by position and then by their order in the file.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static int _loader_compare(const void *a, const void *b){
+    const Loader_Triplet *first = a;
+    const Loader_Triplet *second = b;
+
+    if(first->row != second->row){
+        return first->row < second->row ? -1 : 1;
+    }
+
+    if(first->column != second->column){
+        return first->column < second->column ? -1 : 1;
+    }
+
+    return (first->order > second->order) - (first->order < second->order);
+}
+
+/**
+ * @brief This function sorts the bucket of a thread and links its cells. Like the serial reader, the last value of a repeated position wins and a null value leaves the position empty. Each row of the bucket is linked completely; each column gets a partial list (head and tail) that is stitched to the other buckets later.
+ *
+ * @brief Time Complexity: O(k*log(k) + c), where k is the number of triplets of the bucket
+ */
+static void *_loader_link(void *argument){
+    Loader_Thread *thread = argument;
+    Loader *loader = thread->loader;
+    Loader_Triplet *bucket = loader->sorted + loader->bucketBegin[thread->id];
+    long count = loader->bucketBegin[thread->id + 1] - loader->bucketBegin[thread->id];
+    Cell *rowTail = NULL;
+    int lastRow = -1;
+
+    thread->columnHeads = (Cell **)calloc(loader->numberColumns, sizeof(Cell *));
+    thread->columnTails = (Cell **)calloc(loader->numberColumns, sizeof(Cell *));
+    thread->linked = 0;
+
+    for(long k = 0; k < count; k++){
+        bucket[k].order = (int)k;
+    }
+
+    qsort(bucket, count, sizeof(Loader_Triplet), _loader_compare);
+
+    for(long k = 0; k < count; k++){
+        Loader_Triplet *triplet = &bucket[k];
+
+        if((k + 1 < count && bucket[k + 1].row == triplet->row && bucket[k + 1].column == triplet->column) || triplet->value == 0){
+            continue;
+        }
+
+        Cell *cell = cell_creating(triplet->column, triplet->row, triplet->value, NULL, NULL);
+
+        if(triplet->row != lastRow){
+            loader->rows[triplet->row] = cell;
+            lastRow = triplet->row;
+        }
+
+        else{
+            rowTail->nextRow = cell;
+        }
+
+        if(thread->columnTails[triplet->column]){
+            thread->columnTails[triplet->column]->nextColumn = cell;
+        }
+
+        else{
+            thread->columnHeads[triplet->column] = cell;
+        }
+
+        rowTail = cell;
+        thread->columnTails[triplet->column] = cell;
+        thread->linked++;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief This function joins the partial column lists of the buckets, in the order of the buckets, for the range of columns of a thread.
+ *
+ * @brief Time Complexity: O(c), because each thread stitches c/t columns through the t buckets
+ */
+static void *_loader_stitch(void *argument){
+    Loader_Thread *thread = argument;
+    Loader *loader = thread->loader;
+    int first = (int)((long)thread->id * loader->numberColumns / loader->numberThreads);
+    int last = (int)((long)(thread->id + 1) * loader->numberColumns / loader->numberThreads);
+
+    for(int j = first; j < last; j++){
+        Cell *tail = NULL;
+
+        loader->columns[j] = NULL;
+
+        for(int t = 0; t < loader->numberThreads; t++){
+            Loader_Thread *other = &loader->threads[t];
+
+            if(other->columnHeads[j] == NULL){
+                continue;
+            }
+
+            if(tail){
+                tail->nextColumn = other->columnHeads[j];
+            }
+
+            else{
+                loader->columns[j] = other->columnHeads[j];
+            }
+
+            tail = other->columnTails[j];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief This function reads a file saved by sparse_matrix_binary_save using many threads. The values are split in one byte range per thread, and each thread decodes its range into its own triplets; the triplets are then distributed by row range, and each thread sorts its rows and links their cells, with the columns stitched at the end. The result is the same as sparse_matrix_binary_read (repeated positions keep the last value), and the work scales with the threads until the disk is the limit. Each thread keeps two pointers per column while linking.
+ *
+ * @brief Time Complexity: O((n*log(n/t) + c*t) / t), where t is the number of threads
+ *
+ * @param path
+ * The path to the binary file
+ * @param numberThreads
+ * The number of threads (0 to use one per processor)
+ * @return Sparse_Matrix*
+ * The new matrix created
+ */
+Sparse_Matrix *sparse_matrix_binary_read_parallel(const char *path, int numberThreads){
+    INSTRUMENT_BEGIN();
+
+    FILE *fp = fopen(path, "rb");
+
+    if(!fp){
+        printf("\033[91mError: Couldn't open the file!\n\033[0m");
+        exit(1);
+    }
+
+    int numberNonNullValues = 0;
+
+    size_t bytes = fread(&numberNonNullValues, 1, sizeof(int), fp);
+
+    fclose(fp);
+
+    //Compressed files are decoded block by block by their own reader
+    if(bytes == sizeof(int) && numberNonNullValues == COMPRESSED_MAGIC){
+        INSTRUMENT_END(INSTRUMENT_OP_BINARY_READ_PARALLEL);
+        return sparse_matrix_compressed_read(path);
+    }
+
+    if(bytes != sizeof(int) || numberNonNullValues < 0){
+        printf("\033[91mError: Couldn't read the file!\n\033[0m");
+        exit(1);
+    }
+
+    Loader loader = {path, numberThreads, numberNonNullValues, 1, 1, NULL, NULL, NULL, NULL, NULL};
+
+    if(loader.numberThreads <= 0){
+        loader.numberThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    if(loader.numberThreads > loader.numberEntries / LOADER_MIN_ENTRIES_PER_THREAD){
+        loader.numberThreads = (int)(loader.numberEntries / LOADER_MIN_ENTRIES_PER_THREAD);
+    }
+
+    if(loader.numberThreads < 1){
+        loader.numberThreads = 1;
+    }
+
+    loader.threads = (Loader_Thread *)calloc(loader.numberThreads, sizeof(Loader_Thread));
+
+    for(int t = 0; t < loader.numberThreads; t++){
+        loader.threads[t].loader = &loader;
+        loader.threads[t].id = t;
+        loader.threads[t].begin = loader.numberEntries * t / loader.numberThreads;
+        loader.threads[t].end = loader.numberEntries * (t + 1) / loader.numberThreads;
+    }
+
+    _loader_run(&loader, _loader_decode);
+
+    //Like the serial reader, every index read counts for the size, even the ones of null values
+    for(int t = 0; t < loader.numberThreads; t++){
+        if(loader.threads[t].maxRow + 1 > loader.numberRows){
+            loader.numberRows = loader.threads[t].maxRow + 1;
+        }
+
+        if(loader.threads[t].maxColumn + 1 > loader.numberColumns){
+            loader.numberColumns = loader.threads[t].maxColumn + 1;
+        }
+    }
+
+    _loader_run(&loader, _loader_count);
+
+    //The buckets are laid out in row order and, inside each one, the threads in file order
+    loader.bucketBegin = (long *)malloc((loader.numberThreads + 1) * sizeof(long));
+    long position = 0;
+
+    for(int t = 0; t < loader.numberThreads; t++){
+        loader.threads[t].bucketOffsets = (long *)malloc(loader.numberThreads * sizeof(long));
+    }
+
+    for(int b = 0; b < loader.numberThreads; b++){
+        loader.bucketBegin[b] = position;
+
+        for(int t = 0; t < loader.numberThreads; t++){
+            loader.threads[t].bucketOffsets[b] = position;
+            position += loader.threads[t].bucketCounts[b];
+        }
+    }
+
+    loader.bucketBegin[loader.numberThreads] = position;
+    loader.sorted = (Loader_Triplet *)malloc((loader.numberEntries + 1) * sizeof(Loader_Triplet));
+
+    _loader_run(&loader, _loader_scatter);
+
+    loader.rows = (Cell **)calloc(loader.numberRows, sizeof(Cell *));
+    loader.columns = (Cell **)calloc(loader.numberColumns, sizeof(Cell *));
+
+    _loader_run(&loader, _loader_link);
+    _loader_run(&loader, _loader_stitch);
+
+    int linked = 0;
+
+    for(int t = 0; t < loader.numberThreads; t++){
+        linked += loader.threads[t].linked;
+        free(loader.threads[t].bucketCounts);
+        free(loader.threads[t].bucketOffsets);
+        free(loader.threads[t].columnHeads);
+        free(loader.threads[t].columnTails);
+    }
+
+    free(loader.threads);
+    free(loader.sorted);
+    free(loader.bucketBegin);
+
+    INSTRUMENT_COUNT(INSTRUMENT_BYTES_READ, bytes);
+
+    INSTRUMENT_END(INSTRUMENT_OP_BINARY_READ_PARALLEL);
+    return _sparse_matrix_adopt(loader.numberRows, loader.numberColumns, linked, (void **)loader.rows, (void **)loader.columns);
+}
@@ -0,0 +1,15 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "matrix.h"
+
+//Number of values each loader thread reads from the file at once
+#define LOADER_CHUNK_ENTRIES 65536
+//Minimum number of values per thread; smaller files use fewer threads
+#define LOADER_MIN_ENTRIES_PER_THREAD 16384
+
+//File functions
+
+Sparse_Matrix *sparse_matrix_binary_read_parallel(const char *path, int numberThreads);
+
+#endif
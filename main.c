@@ -27,10 +27,10 @@ int main(){
     SHOW SPARSE MATRIX:
     ROWS: 3 COLUMNS: 3
 
-    [0][1] --> 2.00
     [0][0] --> 4.00
-    [1][1] --> 3.00
+    [0][1] --> 2.00
     [1][0] --> 1.00
+    [1][1] --> 3.00
     [2][2] --> 7.00
     */
 
@@ -265,10 +265,10 @@ int main(){
     SHOW SPARSE MATRIX:
     ROWS: 3 COLUMNS: 3
 
-    [0][1] --> 2.00
     [0][0] --> 4.00
-    [1][1] --> 3.00
+    [0][1] --> 2.00
     [1][0] --> 1.00
+    [1][1] --> 3.00
     [2][2] --> 7.00
     */
 
@@ -1,14 +1,59 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+#include <limits.h>
+#include <pthread.h>
 #include "cell.h"
 #include "matrix.h"
+#include "instrument.h"
+#include "compress.h"
+#include "convolution.h"
+#include "semiring.h"
+
+typedef struct Cell_Slab{
+    int references;
+    int numberCells;
+    Cell cells[];
+} Cell_Slab;
+
+//Column order of a clone without column lists: the cells of each column in increasing row, each column ended by NULL
+typedef struct Column_Index{
+    Cell ***heads;
+    Cell **cells;
+} Column_Index;
+
+typedef struct Lock_Stripe{
+    pthread_mutex_t mutex;
+} __attribute__((aligned(64))) Lock_Stripe;
+
+typedef struct Sparse_Matrix_Locks{
+    Lock_Stripe rowStripes[MATRIX_LOCK_STRIPES];
+    Lock_Stripe columnStripes[MATRIX_LOCK_STRIPES];
+    int rowCapacity, columnCapacity;
+} Sparse_Matrix_Locks;
 
 typedef struct Sparse_Matrix{
     int numberRows, numberColumns, numberNonNullValues;
+    unsigned long version;
     Cell **rows;
     Cell **columns;
+    int **rowShares;
+    int columnsDetached;
+    Cell_Slab *slab;
+    Sparse_Matrix_Locks *locks;
+    Column_Index *columnIndex;
 } Sparse_Matrix;
 
+typedef struct Sparse_Matrix_Builder{
+    Sparse_Matrix *matrix;
+    Cell **rowTails;
+    Cell **columnTails;
+    int lastRow, lastColumn;
+    int numberRows, numberColumns;
+} Sparse_Matrix_Builder;
+
+static int verbose = 1;
+
 /**
  * @brief This function allocates memory for Sparse_Matrix type based on the number of rows and columns in the original matrix.
  *
@@ -17,6 +62,8 @@ typedef struct Sparse_Matrix{
  * An allocated and empty sparse matrix
  */
 Sparse_Matrix *sparse_matrix_create(){
+    INSTRUMENT_BEGIN();
+
     Sparse_Matrix *matrix = calloc(1, sizeof(Sparse_Matrix));
 
     matrix->rows = (Cell **)calloc(1, sizeof(Cell *));
@@ -26,9 +73,140 @@ Sparse_Matrix *sparse_matrix_create(){
     matrix->numberColumns = 1;
     matrix->numberNonNullValues = 0;
 
+    INSTRUMENT_END(INSTRUMENT_OP_CREATE);
     return matrix;
 }
 
+/**
+ * @brief This function turns on or off the report that the operations print on the screen (the operands and the result in dense form). It's turned on by default; programs that time the operations or handle big matrices should turn it off.
+ * 
+ * @brief Time Complexity: O(1), because only a flag is changed
+ * 
+ * @param enabled 
+ * 1 to print the reports or 0 to keep the operations silent
+ */
+void sparse_matrix_set_verbose(int enabled){
+    verbose = enabled;
+}
+
+/**
+ * @brief This function frees a cell unlinked from a matrix. The cells in the slab of the matrix (see sparse_matrix_compact) stay allocated until the slab is released.
+ * 
+ * @brief Time Complexity: O(1)
+ * 
+ * @param matrix 
+ * The matrix that owned the cell
+ * @param cell 
+ * The cell that will be freed
+ * @return long long 
+ * The number of bytes given back to the heap
+ */
+static long long _sparse_matrix_free_cell(Sparse_Matrix *matrix, Cell *cell){
+    if(matrix->slab && cell >= matrix->slab->cells && cell < matrix->slab->cells + matrix->slab->numberCells){
+        cell->nextRow = NULL;
+        cell->nextColumn = NULL;
+        return 0;
+    }
+
+    cell_destroy(cell);
+
+    return sizeof(Cell) + MATRIX_CELL_HEAP_OVERHEAD;
+}
+
+/**
+ * @brief This function drops a reference to a slab of cells, which is freed by the last matrix that uses it (a clone shares the slab of its original along with its rows).
+ * 
+ * @brief Time Complexity: O(1)
+ * 
+ * @param slab 
+ * The slab, or NULL
+ * @return long long 
+ * The number of bytes given back to the heap
+ */
+static long long _sparse_matrix_release_slab(Cell_Slab *slab){
+    if(slab == NULL || --slab->references > 0){
+        return 0;
+    }
+
+    long long bytes = sizeof(Cell_Slab) + (long long)slab->numberCells * sizeof(Cell);
+
+    INSTRUMENT_COUNT(INSTRUMENT_CELLS_FREED, slab->numberCells);
+    free(slab);
+
+    return bytes;
+}
+
+/**
+ * @brief This function returns the column index of a clone without column lists, building it the first time. The index points to the cells of the rows (shared or not), so no cell is copied and the matrix isn't changed: readers that race to build it publish only one, and the others free theirs.
+ * 
+ * @brief Time Complexity: O(1) if the index exists and O(n + r + c) if not
+ */
+static Column_Index *_sparse_matrix_column_index(Sparse_Matrix *matrix){
+    Column_Index *index = __atomic_load_n(&matrix->columnIndex, __ATOMIC_ACQUIRE);
+
+    if(index){
+        return index;
+    }
+
+    index = (Column_Index *)malloc(sizeof(Column_Index));
+    index->heads = (Cell ***)malloc(matrix->numberColumns * sizeof(Cell **));
+    index->cells = (Cell **)malloc(((size_t)matrix->numberNonNullValues + matrix->numberColumns) * sizeof(Cell *));
+
+    int *positions = (int *)calloc(matrix->numberColumns, sizeof(int));
+    int next = 0;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        for(Cell *current = matrix->rows[i]; current; current = current->nextRow){
+            positions[current->positionColumn]++;
+        }
+    }
+
+    //Each column gets its cells and one NULL after them
+    for(int j = 0; j < matrix->numberColumns; j++){
+        int length = positions[j];
+
+        positions[j] = next;
+        index->heads[j] = &index->cells[next];
+        next += length;
+        index->cells[next++] = NULL;
+    }
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        for(Cell *current = matrix->rows[i]; current; current = current->nextRow){
+            index->cells[positions[current->positionColumn]++] = current;
+        }
+    }
+
+    free(positions);
+
+    Column_Index *expected = NULL;
+
+    if(!__atomic_compare_exchange_n(&matrix->columnIndex, &expected, index, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+        free(index->heads);
+        free(index->cells);
+        free(index);
+        index = expected;
+    }
+
+    return index;
+}
+
+/**
+ * @brief This function frees the column index of a matrix, which every change of a clone without column lists makes outdated. Only a writer calls it, so no reader holds the index.
+ * 
+ * @brief Time Complexity: O(1)
+ */
+static void _sparse_matrix_drop_column_index(Sparse_Matrix *matrix){
+    if(matrix->columnIndex == NULL){
+        return;
+    }
+
+    free(matrix->columnIndex->heads);
+    free(matrix->columnIndex->cells);
+    free(matrix->columnIndex);
+    matrix->columnIndex = NULL;
+}
+
 /**
  * @brief This function frees the memory allocated for Sparse_Matrix type.
  * 
@@ -37,292 +215,555 @@ Sparse_Matrix *sparse_matrix_create(){
  * The pointer to a matrix that will be deallocated
  */
 void sparse_matrix_destroy(Sparse_Matrix *matrix){
+    INSTRUMENT_BEGIN();
+
     Cell *current;
     Cell *aux;
 
     for(int i = 0; i < matrix->numberRows; i++){
+        //A row shared with clones is freed by the last matrix that uses it
+        if(matrix->rowShares && matrix->rowShares[i]){
+            if(--(*matrix->rowShares[i]) > 0){
+                continue;
+            }
+
+            free(matrix->rowShares[i]);
+        }
+
         current = matrix->rows[i];
 
         while(current){
             aux = current->nextRow;
-            cell_destroy(current);
+            _sparse_matrix_free_cell(matrix, current);
             current = aux;
         }
     }
 
+    _sparse_matrix_release_slab(matrix->slab);
+    _sparse_matrix_drop_column_index(matrix);
+
+    if(matrix->locks){
+        for(int s = 0; s < MATRIX_LOCK_STRIPES; s++){
+            pthread_mutex_destroy(&matrix->locks->rowStripes[s].mutex);
+            pthread_mutex_destroy(&matrix->locks->columnStripes[s].mutex);
+        }
+
+        free(matrix->locks);
+    }
+
     free(matrix->rows);
     free(matrix->columns);
+    free(matrix->rowShares);
     free(matrix);
+
+    INSTRUMENT_END(INSTRUMENT_OP_DESTROY);
 }
 
 /**
- * @brief This function checks if the index exists in the Sparsed Matrix, i.e., if it represents some non-null value.
+ * @brief This function wraps row and column lists built outside of this file (by the parallel loader) in a new matrix. The lists must be sorted and consistent, and the header arrays must have been allocated with malloc, since the matrix takes them over.
  * 
- * @brief Time Complexity: O(n), because the function goes straight to the line that needs to be evaluated and traverses its size n.
+ * @brief Time Complexity: O(1), because the headers aren't copied
  * 
- * @param matrix 
- * The matrix that will be evaluated
- * @param row 
- * The row wanted
- * @param column 
- * The column wanted
- * @return void*
- * The pointer to the Cell if it exists or NULL if not
+ * @param numberRows 
+ * The number of rows (the size of rows)
+ * @param numberColumns 
+ * The number of columns (the size of columns)
+ * @param numberNonNull 
+ * The number of cells linked
+ * @param rows 
+ * The first cell of each row
+ * @param columns 
+ * The first cell of each column
+ * @return Sparse_Matrix* 
+ * The new matrix
  */
-void *sparse_matrix_index_exists(Sparse_Matrix *matrix, int row, int column){
-    if(!matrix->rows[row] || !matrix->columns[column]){
-        return NULL;
-    }
-
-    Cell *aux = matrix->rows[row];
-
-    while(aux){
-        if(aux->positionRow == row && aux->positionColumn == column){
-            return aux;
-        }
+Sparse_Matrix *_sparse_matrix_adopt(int numberRows, int numberColumns, int numberNonNull, void **rows, void **columns){
+    Sparse_Matrix *matrix = calloc(1, sizeof(Sparse_Matrix));
 
-        aux = aux->nextRow;
-    }
+    matrix->numberRows = numberRows;
+    matrix->numberColumns = numberColumns;
+    matrix->numberNonNullValues = numberNonNull;
+    matrix->rows = (Cell **)rows;
+    matrix->columns = (Cell **)columns;
+    matrix->version = 1;
 
-    return NULL;
+    return matrix;
 }
 
 /**
- * @brief This function inserts a value in the middle or at the beginning of the row.
+ * @brief This function clones a matrix with copy-on-write at row granularity: the clone points to the same rows as the original and a row is copied only when one of the matrices writes to it. The clone starts without column lists: reading a column goes through a column index over the shared cells, and the lists are only built when the columns are changed (see _sparse_matrix_attach_columns).
  * 
- * @brief Time Complexity: O(1) if the value is inserted at the beginning of the list and O(n) if the value is inserted in the middle of the list, requiring it to be traversed
+ * @brief Time Complexity: O(r + c), because only the headers are copied
  * 
  * @param matrix 
- * The matrix that will receive the value
- * @param cell 
- * The pointer of the cell that will be placed at the matrix
- * @param row 
- * The index of the row where the cell will be placed
+ * The matrix that will be cloned
+ * @return Sparse_Matrix* 
+ * The new matrix, with the same values as the original
  */
-void _sparse_matrix_push_row(Sparse_Matrix *matrix, void *cell, int row){
-    Cell *current = matrix->rows[row];
-    Cell *previous = NULL;
-    Cell *cell_to_push = cell;
+Sparse_Matrix *sparse_matrix_clone(Sparse_Matrix *matrix){
+    Sparse_Matrix *clone = calloc(1, sizeof(Sparse_Matrix));
+
+    clone->numberRows = matrix->numberRows;
+    clone->numberColumns = matrix->numberColumns;
+    clone->numberNonNullValues = matrix->numberNonNullValues;
+    clone->rows = (Cell **)malloc(matrix->numberRows * sizeof(Cell *));
+    clone->columns = (Cell **)calloc(matrix->numberColumns, sizeof(Cell *));
+    clone->rowShares = (int **)calloc(matrix->numberRows, sizeof(int *));
+    clone->columnsDetached = 1;
+    clone->slab = matrix->slab;
+
+    if(matrix->slab){
+        matrix->slab->references++;
+    }
 
-    if(current == NULL){
-        matrix->rows[row] = cell_to_push;
-        cell_to_push->nextRow = NULL;
-        return; 
+    if(matrix->rowShares == NULL){
+        matrix->rowShares = (int **)calloc(matrix->numberRows, sizeof(int *));
     }
 
-    while(current){
-        if(current->positionRow > row){
-            if(previous == NULL){
-                cell_to_push->nextRow = current;
-                break;
-            }
-            else{
-                previous->nextRow = cell_to_push;
-                cell_to_push->nextRow = current;
-                break;
-            }
+    //Each shared row has a counter of the matrices that use it
+    for(int i = 0; i < matrix->numberRows; i++){
+        clone->rows[i] = matrix->rows[i];
+
+        if(matrix->rows[i] == NULL){
+            continue;
         }
 
-        if(current->nextRow == NULL){
-            current->nextRow = cell_to_push;
-            break;
+        if(matrix->rowShares[i] == NULL){
+            matrix->rowShares[i] = (int *)malloc(sizeof(int));
+            *matrix->rowShares[i] = 1;
         }
 
-        previous = current;
-        current = current->nextRow;
+        (*matrix->rowShares[i])++;
+        clone->rowShares[i] = matrix->rowShares[i];
     }
+
+    return clone;
 }
 
 /**
- * @brief This function inserts a value in the middle or at the beginning of the column.
+ * @brief This function gives a matrix its own copy of a row shared with clones, before the row is changed. If the matrix has column lists, the copies take the place of the shared cells in them.
  * 
- * @brief Time Complexity: O(1) if the value is inserted at the beginning of the list and O(n) if the value is inserted in the middle of the list, requiring it to be traversed
+ * @brief Time Complexity: O(1) if the row isn't shared, O(k) for a matrix without column lists and O(k*m) for one with them, where k is the length of the row and m the length of its columns
  * 
  * @param matrix 
- * The matrix that will receive the value
- * @param cell 
- * The pointer of the cell that will be placed at the matrix
+ * The matrix that will change the row
  * @param row 
- * The index of the column where the cell will be placed
+ * The row that will be changed
  */
-void _sparse_matrix_push_column(Sparse_Matrix *matrix, void *cell, int column){
-    Cell *current = matrix->columns[column];
-    Cell *previous = NULL;
-    Cell *cell_to_push = cell;
+void _sparse_matrix_private_row(Sparse_Matrix *matrix, int row){
+    if(matrix->rowShares == NULL || row >= matrix->numberRows || matrix->rowShares[row] == NULL){
+        return;
+    }
 
-    if(current == NULL){
-        matrix->columns[column] = cell_to_push;
-        cell_to_push->nextColumn = NULL;
-        return; 
+    int *share = matrix->rowShares[row];
+    matrix->rowShares[row] = NULL;
+
+    //The other matrices already dropped the row
+    if(*share == 1){
+        free(share);
+        return;
     }
 
+    (*share)--;
+    _sparse_matrix_drop_column_index(matrix);
+
+    Cell *current = matrix->rows[row];
+    Cell *tail = NULL;
+
+    matrix->rows[row] = NULL;
+
     while(current){
-        if(current->positionColumn > column){
-            if(previous == NULL){
-                cell_to_push->nextColumn = current;
-                break;
-            }
-            else{
-                previous->nextColumn = cell_to_push;
-                cell_to_push->nextColumn = current;
-                break;
-            }
+        Cell *copy = cell_creating(current->positionColumn, row, current->value, NULL, current->nextColumn);
+
+        if(tail){
+            tail->nextRow = copy;
         }
 
-        if(current->nextColumn == NULL){
-            current->nextColumn = cell_to_push;
-            break;
+        else{
+            matrix->rows[row] = copy;
         }
 
-        previous = current;
-        current = current->nextColumn;
+        if(!matrix->columnsDetached){
+            Cell **link = &matrix->columns[current->positionColumn];
+
+            while(*link != current){
+                link = &(*link)->nextColumn;
+            }
+
+            *link = copy;
+        }
+
+        tail = copy;
+        current = current->nextRow;
     }
 }
 
 /**
- * @brief This function frees the memory allocated for a cell when the user puts a 0 in place of a non-null value.
+ * @brief This function builds the column lists of a clone, which starts without them. The rows still shared are copied first, since a cell can be linked in the columns of only one matrix. Every function that changes the columns or follows the column lists calls it; read-only column walks go through the column index (see sparse_matrix_column_cursor), so reading a clone never copies it.
  * 
- * @brief Time Complexity: O(n), because the function goes straight to the row you want to destroy, traversing the size n of the list
+ * @brief Time Complexity: O(1) if the matrix has column lists and O(n + r + c) if not
  * 
  * @param matrix 
- * The matrix that will be modified
- * @param row 
- * The row of the cell that will be freed
- * @param column 
- * The column of the cell that will be freed
+ * The matrix that needs the column lists
  */
-void _sparse_matrix_destroy_cell(Sparse_Matrix *matrix, int row, int column){
-    Cell *current = matrix->rows[row];
-    Cell *aux = NULL;
-    Cell *prev = NULL;
+void _sparse_matrix_attach_columns(Sparse_Matrix *matrix){
+    if(!matrix->columnsDetached){
+        return;
+    }
 
-    while(current){
-        if(current->positionColumn == column && current->positionRow == row){
-            if(column == 0){
-                aux = current;
-                matrix->rows[row] = aux->nextRow;
-                cell_destroy(aux);
-                break;
+    Cell **tails = (Cell **)calloc(matrix->numberColumns, sizeof(Cell *));
+
+    for(int j = 0; j < matrix->numberColumns; j++){
+        matrix->columns[j] = NULL;
+    }
+
+    //The rows are walked in increasing order, so each column comes out sorted by row
+    for(int i = 0; i < matrix->numberRows; i++){
+        _sparse_matrix_private_row(matrix, i);
+
+        for(Cell *current = matrix->rows[i]; current; current = current->nextRow){
+            int column = current->positionColumn;
+
+            current->nextColumn = NULL;
+
+            if(tails[column]){
+                tails[column]->nextColumn = current;
             }
 
             else{
-                aux = current;
-                prev->nextRow = current->nextRow;
-                cell_destroy(aux);
-                break;
+                matrix->columns[column] = current;
             }
-        }
 
-        prev = current;
-        current = current->nextRow;
+            tails[column] = current;
+        }
     }
+
+    free(tails);
+    matrix->columnsDetached = 0;
+    _sparse_matrix_drop_column_index(matrix);
 }
 
 /**
- * @brief This function creates a cell when the user puts a non-null value in the matrix.
+ * @brief This function returns the number of rows of a matrix that are still shared with clones.
  * 
- * @brief Time Complexity: O(2n), because this function uses the push functions two times (each one has time complexity O(n))
+ * @brief Time Complexity: O(r), because each header is checked once
  * 
  * @param matrix 
- * The matrix that will be defined
- * @param data 
- * The value that will be defined
- * @param row 
- * The row wanted
- * @param column 
- * The column wanted
- * @return void* 
- * The return is a void pointer that will be transformed in Cell* in other functions
+ * The matrix that will be evaluated
+ * @return int 
+ * The number of shared rows
  */
-void *_sparse_matrix_create_cell(Sparse_Matrix *matrix, matrix_value_type data, int row, int column){
-    Cell *new_cell = cell_creating(column, row, data, NULL, NULL);
+int sparse_matrix_shared_rows(Sparse_Matrix *matrix){
+    int shared = 0;
 
-    _sparse_matrix_push_row(matrix, new_cell, row);
-    _sparse_matrix_push_column(matrix, new_cell, column);
+    for(int i = 0; matrix->rowShares && i < matrix->numberRows; i++){
+        if(matrix->rowShares[i] && *matrix->rowShares[i] > 1){
+            shared++;
+        }
+    }
 
-    return new_cell;
+    return shared;
 }
 
 /**
- * @brief This function reallocates the memory for a matrix when the user puts a non-null value in a index higher than the current indexes.
+ * @brief This function moves all the cells of a matrix to one contiguous block, in row-major order, so that walking a row (and, mostly, a column) reads neighbouring memory instead of cells scattered by the order of insertion. Both link sets are rebuilt over the new block, the rows shared with clones are copied (the clones keep the old cells) and the counters of shared rows are dropped, since no row is shared anymore. The headers already have the size of the matrix and are kept. Cells removed later stay in the block until the next compaction or the destruction of the matrix.
+ * 
+ * @brief Time Complexity: O(n + r + c), because each cell is copied once and each header is visited once
  * 
- * @brief Time Complexity: O(2n), because this function relocates the row and column list, moving the components once (depends on size n)
  * @param matrix 
- * The matrix that will be reallocated
- * @param row 
- * The new number of rows
- * @param column 
- * The new number of columns
+ * The matrix that will be compacted
+ * @return long long 
+ * The number of bytes reclaimed, counting MATRIX_CELL_HEAP_OVERHEAD per cell allocated alone (it is negative when the old cells are still used by clones)
  */
-void _sparse_matrix_realloc(Sparse_Matrix *matrix, int row, int column){
-    if(row > matrix->numberRows - 1){
-        matrix->rows = (Cell **)realloc(matrix->rows, (row + 1) * sizeof(Cell *));
+long long sparse_matrix_compact(Sparse_Matrix *matrix){
+    INSTRUMENT_BEGIN();
 
-        for(int i = matrix->numberRows; i < row + 1; i++){
-            matrix->rows[i] = NULL;
+    int numberCells = 0;
+
+    //The slab is sized from the rows themselves, and checked before any cell is moved
+    for(int i = 0; i < matrix->numberRows; i++){
+        for(Cell *current = matrix->rows[i]; current; current = current->nextRow){
+            numberCells++;
         }
+    }
 
-        matrix->numberRows = row + 1;
+    if(numberCells != matrix->numberNonNullValues){
+        printf("\033[91mError: the matrix is corrupted!\n\033[0m");
+        exit(1);
     }
 
-    if(column > matrix->numberColumns - 1){
-        matrix->columns = (Cell **)realloc(matrix->columns, (column + 1) * sizeof(Cell *));
+    long long reclaimed = -(long long)(sizeof(Cell_Slab) + (long long)numberCells * sizeof(Cell));
+    Cell_Slab *slab = (Cell_Slab *)malloc(sizeof(Cell_Slab) + (size_t)numberCells * sizeof(Cell));
+    Cell **tails = (Cell **)calloc(matrix->numberColumns, sizeof(Cell *));
+    int count = 0;
 
-        for(int i = matrix->numberColumns; i < column + 1; i++){
-            matrix->columns[i] = NULL;
-        }
+    slab->references = 1;
+    slab->numberCells = numberCells;
 
-        matrix->numberColumns = column + 1;
+    INSTRUMENT_COUNT(INSTRUMENT_CELLS_ALLOCATED, numberCells);
+
+    for(int j = 0; j < matrix->numberColumns; j++){
+        matrix->columns[j] = NULL;
     }
-}
 
-/**
- * @brief This function puts a value in the matrix by the index. If the user tries to put a 0 in the matrix, the memory will be deleted if there is a non-null value. If a non-null value is placed into an empty index, memory will be allocated to it.
- * 
- * @brief Time Complexity: O(2n) if not necessary relocate the list and O(3n) if necessary
- * 
- * @param matrix 
- * The matrix that will be defined
- * @param data
- * The value that will be defined 
- * @param row 
- * The row wanted
- * @param column 
- * The column wanted
+    for(int i = 0; i < matrix->numberRows; i++){
+        int shared = 0;
+
+        //The clones keep the old cells of a shared row
+        if(matrix->rowShares && matrix->rowShares[i]){
+            shared = --(*matrix->rowShares[i]) > 0;
+
+            if(!shared){
+                free(matrix->rowShares[i]);
+            }
+        }
+
+        Cell *current = matrix->rows[i];
+        Cell *tail = NULL;
+
+        matrix->rows[i] = NULL;
+
+        while(current){
+            Cell *cell = &slab->cells[count++];
+            Cell *next = current->nextRow;
+            int column = current->positionColumn;
+
+            cell->positionColumn = column;
+            cell->positionRow = i;
+            cell->value = current->value;
+            cell->nextRow = NULL;
+            cell->nextColumn = NULL;
+
+            if(tail){
+                tail->nextRow = cell;
+            }
+
+            else{
+                matrix->rows[i] = cell;
+            }
+
+            if(tails[column]){
+                tails[column]->nextColumn = cell;
+            }
+
+            else{
+                matrix->columns[column] = cell;
+            }
+
+            tail = cell;
+            tails[column] = cell;
+
+            if(!shared){
+                reclaimed += _sparse_matrix_free_cell(matrix, current);
+            }
+
+            current = next;
+        }
+    }
+
+    if(matrix->rowShares){
+        reclaimed += (long long)matrix->numberRows * sizeof(int *);
+        free(matrix->rowShares);
+        matrix->rowShares = NULL;
+    }
+
+    reclaimed += _sparse_matrix_release_slab(matrix->slab);
+    matrix->slab = slab;
+    matrix->columnsDetached = 0;
+    matrix->version++;
+    _sparse_matrix_drop_column_index(matrix);
+
+    free(tails);
+
+    INSTRUMENT_END(INSTRUMENT_OP_COMPACT);
+    return reclaimed;
+}
+
+/**
+ * @brief This function returns the number of rows of the matrix (the highest row index ever used plus one).
+ * 
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return int 
+ * The number of rows
  */
-void sparse_matrix_set_by_index(Sparse_Matrix *matrix, matrix_value_type data, int row, int column){
-    if(row < 0 || column < 0){
-        printf("\033[91mError: invalid index was read!\n\033[0m");
-        exit(1);
+int sparse_matrix_number_rows(Sparse_Matrix *matrix){
+    return matrix->numberRows;
+}
+
+/**
+ * @brief This function returns the number of columns of the matrix (the highest column index ever used plus one).
+ * 
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return int 
+ * The number of columns
+ */
+int sparse_matrix_number_columns(Sparse_Matrix *matrix){
+    return matrix->numberColumns;
+}
+
+/**
+ * @brief This function returns the first cell of a row, so other modules can walk the row list without knowing the structure of the matrix.
+ * 
+ * @brief Time Complexity: O(1), because the function goes straight to the header of the row
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @param row 
+ * The row wanted
+ * @return void* 
+ * The pointer to the first Cell of the row or NULL if the row is empty
+ */
+void *_sparse_matrix_row_head(Sparse_Matrix *matrix, int row){
+    if(row < 0 || row >= matrix->numberRows){
+        return NULL;
     }
-    
-    if((row > matrix->numberRows - 1 || column > matrix->numberColumns - 1)){
-        _sparse_matrix_realloc(matrix, row, column);
+
+    return matrix->rows[row];
+}
+
+/**
+ * @brief This function returns the first cell of a column, so other modules can walk the column list without knowing the structure of the matrix. A clone gets its own column lists first, copying its shared rows; read-only walks should use sparse_matrix_column_cursor instead.
+ * 
+ * @brief Time Complexity: O(1), because the function goes straight to the header of the column (plus the cost of _sparse_matrix_attach_columns the first time for a clone)
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @param column 
+ * The column wanted
+ * @return void* 
+ * The pointer to the first Cell of the column or NULL if the column is empty
+ */
+void *_sparse_matrix_column_head(Sparse_Matrix *matrix, int column){
+    if(column < 0 || column >= matrix->numberColumns){
+        return NULL;
     }
 
-    Cell *aux = sparse_matrix_index_exists(matrix, row, column);
+    _sparse_matrix_attach_columns(matrix);
 
-    if(data == 0){
-        if(aux != NULL){
-            _sparse_matrix_destroy_cell(matrix, row, column);
-            matrix->numberNonNullValues--;
-        }
+    return matrix->columns[column];
+}
+
+/**
+ * @brief This function returns the version of the matrix, a counter that changes every time a value is set. Other modules use it to know if data derived from the matrix is outdated.
+ * 
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return unsigned long 
+ * The current version of the matrix
+ */
+unsigned long sparse_matrix_version(Sparse_Matrix *matrix){
+    return matrix->version;
+}
+
+/**
+ * @brief This function returns a cursor over the non-null values of a row, in increasing order of column.
+ * 
+ * @brief Time Complexity: O(1), because the cursor only points to the header of the row
+ * 
+ * @param matrix 
+ * The matrix that will be walked
+ * @param row 
+ * The row wanted
+ * @return Sparse_Matrix_Cursor 
+ * The cursor, positioned before the first value of the row
+ */
+Sparse_Matrix_Cursor sparse_matrix_row_cursor(Sparse_Matrix *matrix, int row){
+    Sparse_Matrix_Cursor cursor = {_sparse_matrix_row_head(matrix, row), 0, row, -1, 0};
+
+    return cursor;
+}
+
+/**
+ * @brief This function returns a cursor over the non-null values of a column, in increasing order of row. A clone without column lists is walked through its column index, so reading it never copies its shared rows; such a cursor must not be used after the matrix changes.
+ * 
+ * @brief Time Complexity: O(1), because the cursor only points to the header of the column (plus the cost of building the column index the first time for a clone)
+ * 
+ * @param matrix 
+ * The matrix that will be walked
+ * @param column 
+ * The column wanted
+ * @return Sparse_Matrix_Cursor 
+ * The cursor, positioned before the first value of the column
+ */
+Sparse_Matrix_Cursor sparse_matrix_column_cursor(Sparse_Matrix *matrix, int column){
+    Sparse_Matrix_Cursor cursor = {NULL, 1, -1, column, 0};
+
+    if(column < 0 || column >= matrix->numberColumns){
+        return cursor;
+    }
+
+    if(matrix->columnsDetached){
+        cursor.cell = _sparse_matrix_column_index(matrix)->heads[column];
+        cursor.byColumn = 2;
     }
 
     else{
-        if(aux == NULL){
-            aux = _sparse_matrix_create_cell(matrix, data, row, column);
-        }
+        cursor.cell = matrix->columns[column];
+    }
 
-        aux->value = data;
-        matrix->numberNonNullValues++;
+    return cursor;
+}
+
+/**
+ * @brief This function moves a cursor to the next non-null value and fills its row, column and value. The cursor already points past the value it returns, so that value can be set to 0 (destroyed) without breaking the walk.
+ * 
+ * @brief Time Complexity: O(1), because only one link is followed
+ * 
+ * @param cursor 
+ * The cursor that will be moved
+ * @return int 
+ * 1 if a value was read or 0 if the row (or column) is over
+ */
+int sparse_matrix_cursor_next(Sparse_Matrix_Cursor *cursor){
+    //A cursor over a column index (byColumn == 2) points to a slot of the index instead of a cell
+    Cell **slot = cursor->byColumn == 2 ? (Cell **)cursor->cell : NULL;
+    Cell *current = slot ? *slot : cursor->cell;
+
+    if(current == NULL){
+        return 0;
+    }
+
+    cursor->row = current->positionRow;
+    cursor->column = current->positionColumn;
+    cursor->value = current->value;
+
+    if(slot){
+        cursor->cell = slot + 1;
+    }
+
+    else{
+        cursor->cell = cursor->byColumn ? current->nextColumn : current->nextRow;
     }
+
+    return 1;
 }
 
 /**
- * @brief This function returns the value of an index in sparse matrix. If the index doesn't represent a valid cell, 0.0 is returned.
+ * @brief This function returns the number of non-null values stored in the matrix.
  * 
- * @brief Time Complexity: O(n), because this function loops through the entire list of size n to check if the value exists
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return int 
+ * The number of non-null values
+ */
+int sparse_matrix_number_non_null(Sparse_Matrix *matrix){
+    return matrix->numberNonNullValues;
+}
+
+/**
+ * @brief This function checks if the index exists in the Sparsed Matrix, i.e., if it represents some non-null value.
+ * 
+ * @brief Time Complexity: O(n), because the function goes straight to the line that needs to be evaluated and traverses its size n.
  * 
  * @param matrix 
  * The matrix that will be evaluated
@@ -330,162 +771,1885 @@ void sparse_matrix_set_by_index(Sparse_Matrix *matrix, matrix_value_type data, i
  * The row wanted
  * @param column 
  * The column wanted
- * @return matrix_value_type 
- * The value of that index (null or non-null)
+ * @return void*
+ * The pointer to the Cell if it exists or NULL if not
  */
-matrix_value_type sparse_matrix_get_by_index(Sparse_Matrix *matrix, int row, int column){
-    Cell *aux = sparse_matrix_index_exists(matrix, row, column);
+void *sparse_matrix_index_exists(Sparse_Matrix *matrix, int row, int column){
+    if(!matrix->rows[row] || (!matrix->columnsDetached && !matrix->columns[column])){
+        return NULL;
+    }
+
+    Cell *aux = matrix->rows[row];
+
+    while(aux){
+        INSTRUMENT_COUNT(INSTRUMENT_NODES_TRAVERSED, 1);
+
+        if(aux->positionRow == row && aux->positionColumn == column){
+            return aux;
+        }
+
+        //The row is sorted, so the column can't be further ahead
+        if(aux->positionColumn > column){
+            return NULL;
+        }
+
+        aux = aux->nextRow;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief This function inserts a value in the middle or at the beginning of the row, keeping the row sorted by column.
+ * 
+ * @brief Time Complexity: O(1) if the value is inserted at the beginning of the list and O(n) if the value is inserted in the middle of the list, requiring it to be traversed
+ * 
+ * @param matrix 
+ * The matrix that will receive the value
+ * @param cell 
+ * The pointer of the cell that will be placed at the matrix
+ * @param row 
+ * The index of the row where the cell will be placed
+ */
+void _sparse_matrix_push_row(Sparse_Matrix *matrix, void *cell, int row){
+    Cell *current = matrix->rows[row];
+    Cell *previous = NULL;
+    Cell *cell_to_push = cell;
+
+    if(current == NULL){
+        matrix->rows[row] = cell_to_push;
+        cell_to_push->nextRow = NULL;
+        return; 
+    }
+
+    //The row is kept sorted by column, so the cursors and the merges can walk it in order
+    while(current){
+        if(current->positionColumn > cell_to_push->positionColumn){
+            if(previous == NULL){
+                cell_to_push->nextRow = current;
+                matrix->rows[row] = cell_to_push;
+                break;
+            }
+            else{
+                previous->nextRow = cell_to_push;
+                cell_to_push->nextRow = current;
+                break;
+            }
+        }
+
+        if(current->nextRow == NULL){
+            current->nextRow = cell_to_push;
+            break;
+        }
+
+        previous = current;
+        current = current->nextRow;
+    }
+}
+
+/**
+ * @brief This function inserts a value in the middle or at the beginning of the column, keeping the column sorted by row.
+ * 
+ * @brief Time Complexity: O(1) if the value is inserted at the beginning of the list and O(n) if the value is inserted in the middle of the list, requiring it to be traversed
+ * 
+ * @param matrix 
+ * The matrix that will receive the value
+ * @param cell 
+ * The pointer of the cell that will be placed at the matrix
+ * @param row 
+ * The index of the column where the cell will be placed
+ */
+void _sparse_matrix_push_column(Sparse_Matrix *matrix, void *cell, int column){
+    Cell *current = matrix->columns[column];
+    Cell *previous = NULL;
+    Cell *cell_to_push = cell;
+
+    if(current == NULL){
+        matrix->columns[column] = cell_to_push;
+        cell_to_push->nextColumn = NULL;
+        return; 
+    }
+
+    //The column is kept sorted by row
+    while(current){
+        if(current->positionRow > cell_to_push->positionRow){
+            if(previous == NULL){
+                cell_to_push->nextColumn = current;
+                matrix->columns[column] = cell_to_push;
+                break;
+            }
+            else{
+                previous->nextColumn = cell_to_push;
+                cell_to_push->nextColumn = current;
+                break;
+            }
+        }
+
+        if(current->nextColumn == NULL){
+            current->nextColumn = cell_to_push;
+            break;
+        }
+
+        previous = current;
+        current = current->nextColumn;
+    }
+}
+
+/**
+ * @brief This function frees the memory allocated for a cell when the user puts a 0 in place of a non-null value.
+ * 
+ * @brief Time Complexity: O(n), because the function goes straight to the row you want to destroy, traversing the size n of the list
+ * 
+ * @param matrix 
+ * The matrix that will be modified
+ * @param row 
+ * The row of the cell that will be freed
+ * @param column 
+ * The column of the cell that will be freed
+ */
+void _sparse_matrix_destroy_cell(Sparse_Matrix *matrix, int row, int column){
+    Cell *current = matrix->rows[row];
+    Cell *prev = NULL;
+
+    while(current){
+        if(current->positionColumn == column && current->positionRow == row){
+            break;
+        }
+
+        prev = current;
+        current = current->nextRow;
+    }
+
+    if(current == NULL){
+        return;
+    }
+
+    _sparse_matrix_drop_column_index(matrix);
+
+    if(prev == NULL){
+        matrix->rows[row] = current->nextRow;
+    }
+
+    else{
+        prev->nextRow = current->nextRow;
+    }
+
+    //The cell also needs to leave the column list, otherwise the column would point to freed memory
+    Cell *column_current = matrix->columnsDetached ? NULL : matrix->columns[column];
+    Cell *column_prev = NULL;
+
+    while(column_current && column_current != current){
+        column_prev = column_current;
+        column_current = column_current->nextColumn;
+    }
+
+    if(column_current){
+        if(column_prev == NULL){
+            matrix->columns[column] = current->nextColumn;
+        }
+
+        else{
+            column_prev->nextColumn = current->nextColumn;
+        }
+    }
+
+    _sparse_matrix_free_cell(matrix, current);
+}
+
+/**
+ * @brief This function creates a cell when the user puts a non-null value in the matrix.
+ * 
+ * @brief Time Complexity: O(2n), because this function uses the push functions two times (each one has time complexity O(n))
+ * 
+ * @param matrix 
+ * The matrix that will be defined
+ * @param data 
+ * The value that will be defined
+ * @param row 
+ * The row wanted
+ * @param column 
+ * The column wanted
+ * @return void* 
+ * The return is a void pointer that will be transformed in Cell* in other functions
+ */
+void *_sparse_matrix_create_cell(Sparse_Matrix *matrix, matrix_value_type data, int row, int column){
+    Cell *new_cell = cell_creating(column, row, data, NULL, NULL);
+
+    _sparse_matrix_drop_column_index(matrix);
+    _sparse_matrix_push_row(matrix, new_cell, row);
+
+    if(!matrix->columnsDetached){
+        _sparse_matrix_push_column(matrix, new_cell, column);
+    }
+
+    return new_cell;
+}
+
+/**
+ * @brief This function reallocates the memory for a matrix when the user puts a non-null value in a index higher than the current indexes.
+ * 
+ * @brief Time Complexity: O(2n), because this function relocates the row and column list, moving the components once (depends on size n)
+ * @param matrix 
+ * The matrix that will be reallocated
+ * @param row 
+ * The new number of rows
+ * @param column 
+ * The new number of columns
+ */
+void _sparse_matrix_realloc(Sparse_Matrix *matrix, int row, int column){
+    INSTRUMENT_COUNT(INSTRUMENT_REALLOC_CALLS, 1);
+    _sparse_matrix_drop_column_index(matrix);
+
+    if(row > matrix->numberRows - 1){
+        matrix->rows = (Cell **)realloc(matrix->rows, (row + 1) * sizeof(Cell *));
+
+        for(int i = matrix->numberRows; i < row + 1; i++){
+            matrix->rows[i] = NULL;
+        }
+
+        if(matrix->rowShares){
+            matrix->rowShares = (int **)realloc(matrix->rowShares, (row + 1) * sizeof(int *));
+
+            for(int i = matrix->numberRows; i < row + 1; i++){
+                matrix->rowShares[i] = NULL;
+            }
+        }
+
+        matrix->numberRows = row + 1;
+    }
+
+    if(column > matrix->numberColumns - 1){
+        matrix->columns = (Cell **)realloc(matrix->columns, (column + 1) * sizeof(Cell *));
+
+        for(int i = matrix->numberColumns; i < column + 1; i++){
+            matrix->columns[i] = NULL;
+        }
+
+        matrix->numberColumns = column + 1;
+    }
+}
+
+/**
+ * @brief This function raises a dimension of a matrix in concurrent mode to at least a value, without a lock.
+ * 
+ * @brief Time Complexity: O(1), apart from the retries when other threads raise it at the same time
+ */
+static void _sparse_matrix_atomic_max(int *dimension, int value){
+    int current = __atomic_load_n(dimension, __ATOMIC_RELAXED);
+
+    while(current < value && !__atomic_compare_exchange_n(dimension, &current, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+/**
+ * @brief This function grows the headers of a matrix in concurrent mode to hold an index. The writers touch the headers only while they hold the stripe of their row, so taking every row stripe stops them all; the capacity at least doubles, so this happens a logarithmic number of times.
+ * 
+ * @brief Time Complexity: O(r + c + s), where s is the number of stripes
+ */
+static void _sparse_matrix_concurrent_grow(Sparse_Matrix *matrix, int row, int column){
+    Sparse_Matrix_Locks *locks = matrix->locks;
+
+    for(int s = 0; s < MATRIX_LOCK_STRIPES; s++){
+        pthread_mutex_lock(&locks->rowStripes[s].mutex);
+    }
+
+    //Another thread may have grown them while this one waited
+    if(row >= locks->rowCapacity){
+        int capacity = row + 1 > 2 * locks->rowCapacity ? row + 1 : 2 * locks->rowCapacity;
+
+        matrix->rows = (Cell **)realloc(matrix->rows, capacity * sizeof(Cell *));
+
+        for(int i = locks->rowCapacity; i < capacity; i++){
+            matrix->rows[i] = NULL;
+        }
+
+        locks->rowCapacity = capacity;
+    }
+
+    if(column >= locks->columnCapacity){
+        int capacity = column + 1 > 2 * locks->columnCapacity ? column + 1 : 2 * locks->columnCapacity;
+
+        matrix->columns = (Cell **)realloc(matrix->columns, capacity * sizeof(Cell *));
+
+        for(int j = locks->columnCapacity; j < capacity; j++){
+            matrix->columns[j] = NULL;
+        }
+
+        locks->columnCapacity = capacity;
+    }
+
+    INSTRUMENT_COUNT(INSTRUMENT_REALLOC_CALLS, 1);
+
+    for(int s = MATRIX_LOCK_STRIPES - 1; s >= 0; s--){
+        pthread_mutex_unlock(&locks->rowStripes[s].mutex);
+    }
+}
+
+/**
+ * @brief This function is sparse_matrix_set_by_index in concurrent mode. The row is changed under the stripe of the row and, inside it, the column under the stripe of the column (always in this order, so two writers never wait for each other in a cycle). Writers of different rows and columns only share a stripe when their indexes are congruent modulo MATRIX_LOCK_STRIPES.
+ * 
+ * @brief Time Complexity: O(a + b), where a and b are the lengths of the row and of the column
+ */
+static void _sparse_matrix_concurrent_set(Sparse_Matrix *matrix, matrix_value_type data, int row, int column){
+    Sparse_Matrix_Locks *locks = matrix->locks;
+    pthread_mutex_t *rowLock = &locks->rowStripes[row % MATRIX_LOCK_STRIPES].mutex;
+    pthread_mutex_t *columnLock = &locks->columnStripes[column % MATRIX_LOCK_STRIPES].mutex;
+
+    pthread_mutex_lock(rowLock);
+
+    while(row >= locks->rowCapacity || column >= locks->columnCapacity){
+        pthread_mutex_unlock(rowLock);
+        _sparse_matrix_concurrent_grow(matrix, row, column);
+        pthread_mutex_lock(rowLock);
+    }
+
+    _sparse_matrix_atomic_max(&matrix->numberRows, row + 1);
+    _sparse_matrix_atomic_max(&matrix->numberColumns, column + 1);
+    __atomic_fetch_add(&matrix->version, 1, __ATOMIC_RELAXED);
+
+    Cell **link = &matrix->rows[row];
+
+    while(*link && (*link)->positionColumn < column){
+        link = &(*link)->nextRow;
+    }
+
+    Cell *current = *link && (*link)->positionColumn == column ? *link : NULL;
+
+    if(current && data != 0){
+        current->value = data;
+    }
+
+    else if(current){
+        *link = current->nextRow;
+
+        pthread_mutex_lock(columnLock);
+
+        Cell **columnLink = &matrix->columns[column];
+
+        while(*columnLink != current){
+            columnLink = &(*columnLink)->nextColumn;
+        }
+
+        *columnLink = current->nextColumn;
+
+        pthread_mutex_unlock(columnLock);
+
+        _sparse_matrix_free_cell(matrix, current);
+        __atomic_fetch_sub(&matrix->numberNonNullValues, 1, __ATOMIC_RELAXED);
+    }
+
+    else if(data != 0){
+        Cell *cell = cell_creating(column, row, data, *link, NULL);
+
+        *link = cell;
+
+        pthread_mutex_lock(columnLock);
+        _sparse_matrix_push_column(matrix, cell, column);
+        pthread_mutex_unlock(columnLock);
+
+        __atomic_fetch_add(&matrix->numberNonNullValues, 1, __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_unlock(rowLock);
+}
+
+/**
+ * @brief This function is sparse_matrix_get_by_index in concurrent mode: the row is walked under its stripe.
+ * 
+ * @brief Time Complexity: O(a), where a is the length of the row
+ */
+static matrix_value_type _sparse_matrix_concurrent_get(Sparse_Matrix *matrix, int row, int column){
+    //A negative index would pick a stripe out of the array
+    if(row < 0 || column < 0){
+        printf("\033[91mError: invalid index was read!\n\033[0m");
+        exit(1);
+    }
+
+    pthread_mutex_t *rowLock = &matrix->locks->rowStripes[row % MATRIX_LOCK_STRIPES].mutex;
+    matrix_value_type value = 0;
+
+    pthread_mutex_lock(rowLock);
+
+    if(row < matrix->locks->rowCapacity){
+        for(Cell *current = matrix->rows[row]; current && current->positionColumn <= column; current = current->nextRow){
+            if(current->positionColumn == column){
+                value = current->value;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(rowLock);
+
+    return value;
+}
+
+/**
+ * @brief This function puts a matrix in concurrent mode, where many threads may call sparse_matrix_set_by_index and sparse_matrix_get_by_index on it at the same time. The rows shared with clones are copied and the column lists are built first, so the writers never touch another matrix. The headers are sized for the dimensions expected, so that the writers don't need to grow them. No other function may use the matrix until sparse_matrix_concurrent_end.
+ * 
+ * @brief Time Complexity: O(n + r + c), because the shared rows and the columns may have to be rebuilt
+ * 
+ * @param matrix 
+ * The matrix that will be shared by the writers
+ * @param numberRows 
+ * The number of rows expected (the headers still grow past it)
+ * @param numberColumns 
+ * The number of columns expected (the headers still grow past it)
+ */
+void sparse_matrix_concurrent_begin(Sparse_Matrix *matrix, int numberRows, int numberColumns){
+    if(matrix->locks){
+        printf("\033[91mError: the matrix is already in concurrent mode!\n\033[0m");
+        exit(1);
+    }
+
+    _sparse_matrix_attach_columns(matrix);
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        _sparse_matrix_private_row(matrix, i);
+    }
+
+    //No row is shared anymore
+    free(matrix->rowShares);
+    matrix->rowShares = NULL;
+
+    Sparse_Matrix_Locks *locks = (Sparse_Matrix_Locks *)aligned_alloc(64, sizeof(Sparse_Matrix_Locks));
+
+    for(int s = 0; s < MATRIX_LOCK_STRIPES; s++){
+        pthread_mutex_init(&locks->rowStripes[s].mutex, NULL);
+        pthread_mutex_init(&locks->columnStripes[s].mutex, NULL);
+    }
+
+    locks->rowCapacity = matrix->numberRows;
+    locks->columnCapacity = matrix->numberColumns;
+    matrix->locks = locks;
+
+    if(numberRows > matrix->numberRows || numberColumns > matrix->numberColumns){
+        _sparse_matrix_concurrent_grow(matrix, numberRows - 1, numberColumns - 1);
+    }
+}
+
+/**
+ * @brief This function takes a matrix out of concurrent mode, after every writer is done: the locks are freed and the headers are shrunk to the dimensions of the matrix.
+ * 
+ * @brief Time Complexity: O(s), where s is the number of stripes
+ * 
+ * @param matrix 
+ * The matrix in concurrent mode
+ */
+void sparse_matrix_concurrent_end(Sparse_Matrix *matrix){
+    if(matrix->locks == NULL){
+        printf("\033[91mError: the matrix isn't in concurrent mode!\n\033[0m");
+        exit(1);
+    }
+
+    for(int s = 0; s < MATRIX_LOCK_STRIPES; s++){
+        pthread_mutex_destroy(&matrix->locks->rowStripes[s].mutex);
+        pthread_mutex_destroy(&matrix->locks->columnStripes[s].mutex);
+    }
+
+    if(matrix->locks->rowCapacity > matrix->numberRows){
+        matrix->rows = (Cell **)realloc(matrix->rows, (matrix->numberRows ? matrix->numberRows : 1) * sizeof(Cell *));
+    }
+
+    if(matrix->locks->columnCapacity > matrix->numberColumns){
+        matrix->columns = (Cell **)realloc(matrix->columns, (matrix->numberColumns ? matrix->numberColumns : 1) * sizeof(Cell *));
+    }
+
+    free(matrix->locks);
+    matrix->locks = NULL;
+}
+
+/**
+ * @brief This function puts a value in the matrix by the index. If the user tries to put a 0 in the matrix, the memory will be deleted if there is a non-null value. If a non-null value is placed into an empty index, memory will be allocated to it.
+ * 
+ * @brief Time Complexity: O(2n) if not necessary relocate the list and O(3n) if necessary
+ * 
+ * @param matrix 
+ * The matrix that will be defined
+ * @param data
+ * The value that will be defined 
+ * @param row 
+ * The row wanted
+ * @param column 
+ * The column wanted
+ */
+void sparse_matrix_set_by_index(Sparse_Matrix *matrix, matrix_value_type data, int row, int column){
+    INSTRUMENT_BEGIN();
+
+    if(row < 0 || column < 0){
+        printf("\033[91mError: invalid index was read!\n\033[0m");
+        exit(1);
+    }
+
+    if(matrix->locks){
+        _sparse_matrix_concurrent_set(matrix, data, row, column);
+        INSTRUMENT_END(INSTRUMENT_OP_SET_BY_INDEX);
+        return;
+    }
+    
+    if((row > matrix->numberRows - 1 || column > matrix->numberColumns - 1)){
+        _sparse_matrix_realloc(matrix, row, column);
+    }
+
+    _sparse_matrix_private_row(matrix, row);
+
+    Cell *aux = sparse_matrix_index_exists(matrix, row, column);
+
+    matrix->version++;
+
+    if(data == 0){
+        if(aux != NULL){
+            _sparse_matrix_destroy_cell(matrix, row, column);
+            matrix->numberNonNullValues--;
+        }
+    }
+
+    else{
+        if(aux == NULL){
+            aux = _sparse_matrix_create_cell(matrix, data, row, column);
+            matrix->numberNonNullValues++;
+        }
+
+        aux->value = data;
+    }
+
+    INSTRUMENT_END(INSTRUMENT_OP_SET_BY_INDEX);
+}
+
+/**
+ * @brief This function writes a batch of values into the matrix in a unique pass. The batch must be sorted in row-major order with no repeated positions; a null value removes the value stored at its position. The rows and the columns are walked only forward, so the whole batch costs about as much as walking the rows it touches once.
+ * 
+ * @brief Time Complexity: O(k + n' + r + c), where k is the size of the batch and n' is the number of values of the rows and columns touched by it
+ * 
+ * @param matrix 
+ * The matrix that will be changed
+ * @param rows 
+ * The row of each value of the batch
+ * @param columns 
+ * The column of each value of the batch
+ * @param values 
+ * The values of the batch
+ * @param count 
+ * The size of the batch
+ */
+void _sparse_matrix_merge_sorted(Sparse_Matrix *matrix, const int *rows, const int *columns, const matrix_value_type *values, int count){
+    int maxRow = -1, maxColumn = -1;
+
+    for(int k = 0; k < count; k++){
+        if(rows[k] < 0 || columns[k] < 0){
+            printf("\033[91mError: invalid index was read!\n\033[0m");
+            exit(1);
+        }
+
+        if(values[k] != 0 && rows[k] > maxRow){
+            maxRow = rows[k];
+        }
+
+        if(values[k] != 0 && columns[k] > maxColumn){
+            maxColumn = columns[k];
+        }
+    }
+
+    //The headers grow once for the whole batch
+    if(maxRow > matrix->numberRows - 1 || maxColumn > matrix->numberColumns - 1){
+        _sparse_matrix_realloc(matrix, maxRow, maxColumn);
+    }
+
+    _sparse_matrix_attach_columns(matrix);
+
+    //columnPrevious[j] is the last cell of column j above the current row (NULL if there is none)
+    Cell **columnPrevious = (Cell **)calloc(matrix->numberColumns, sizeof(Cell *));
+    Cell *current = NULL, *previous = NULL, *above, *below;
+    int row = -1;
+
+    for(int k = 0; k < count; k++){
+        int column = columns[k];
+        matrix_value_type data = values[k];
+
+        //Removing a value out of the matrix changes nothing
+        if(rows[k] >= matrix->numberRows || column >= matrix->numberColumns){
+            continue;
+        }
+
+        if(rows[k] != row){
+            row = rows[k];
+            _sparse_matrix_private_row(matrix, row);
+            current = matrix->rows[row];
+            previous = NULL;
+        }
+
+        while(current && current->positionColumn < column){
+            previous = current;
+            current = current->nextRow;
+        }
+
+        if(current && current->positionColumn == column && data != 0){
+            current->value = data;
+            continue;
+        }
+
+        if(data == 0 && (current == NULL || current->positionColumn != column)){
+            continue;
+        }
+
+        above = columnPrevious[column];
+        below = above ? above->nextColumn : matrix->columns[column];
+
+        while(below && below->positionRow < row){
+            above = below;
+            below = below->nextColumn;
+        }
+
+        columnPrevious[column] = above;
+
+        if(data == 0){
+            Cell *next = current->nextRow;
+
+            if(previous){
+                previous->nextRow = next;
+            }
+
+            else{
+                matrix->rows[row] = next;
+            }
+
+            if(above){
+                above->nextColumn = current->nextColumn;
+            }
+
+            else{
+                matrix->columns[column] = current->nextColumn;
+            }
+
+            _sparse_matrix_free_cell(matrix, current);
+            matrix->numberNonNullValues--;
+            current = next;
+        }
+
+        else{
+            Cell *cell = cell_creating(column, row, data, current, below);
+
+            if(previous){
+                previous->nextRow = cell;
+            }
+
+            else{
+                matrix->rows[row] = cell;
+            }
+
+            if(above){
+                above->nextColumn = cell;
+            }
+
+            else{
+                matrix->columns[column] = cell;
+            }
+
+            previous = cell;
+            matrix->numberNonNullValues++;
+        }
+    }
+
+    matrix->version++;
+    free(columnPrevious);
+}
+
+/**
+ * @brief This function returns the k-th largest value of an array (quickselect), reordering the array.
+ * 
+ * @brief Time Complexity: O(n) on average
+ */
+static matrix_value_type _sparse_matrix_select_largest(matrix_value_type *values, int count, int k){
+    int low = 0, high = count - 1, target = k - 1;
+
+    while(low < high){
+        matrix_value_type pivot = values[low + (high - low) / 2];
+        int i = low, j = high;
+
+        //Larger values to the left
+        while(i <= j){
+            while(values[i] > pivot){
+                i++;
+            }
+
+            while(values[j] < pivot){
+                j--;
+            }
+
+            if(i <= j){
+                matrix_value_type swap = values[i];
+                values[i++] = values[j];
+                values[j--] = swap;
+            }
+        }
+
+        if(target <= j){
+            high = j;
+        }
+
+        else if(target >= i){
+            low = i;
+        }
+
+        else{
+            break;
+        }
+    }
+
+    return values[target];
+}
+
+/**
+ * @brief This function removes values from a matrix in a unique pass over its rows, in increasing order. A removed cell is unlinked from its column through the last cell kept above it in that column, which is known because the columns are sorted by row, so the columns are never searched. With k >= 0, only the k values of largest absolute value of each row are kept (ties are kept from the left); otherwise the values smaller than the tolerance are removed. Stored zeros are always removed.
+ * 
+ * @brief Time Complexity: O(n + c), where n is the number of non-null values and c is the number of columns
+ */
+static int _sparse_matrix_prune(Sparse_Matrix *matrix, matrix_value_type tolerance, int k){
+    //columnPrevious[j] is the last cell kept in column j above the current row (NULL if there is none)
+    Cell **columnPrevious = (Cell **)calloc(matrix->numberColumns, sizeof(Cell *));
+    matrix_value_type *magnitudes = NULL;
+    int capacity = 0, removed = 0;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        matrix_value_type threshold = tolerance;
+        int length = 0, numberEqual = matrix->numberColumns, dropping = 0;
+
+        for(Cell *current = matrix->rows[i]; current; current = current->nextRow){
+            length++;
+        }
+
+        if(k >= 0 && length > k){
+            if(length > capacity){
+                capacity = length;
+                magnitudes = (matrix_value_type *)realloc(magnitudes, capacity * sizeof(matrix_value_type));
+            }
+
+            length = 0;
+
+            for(Cell *current = matrix->rows[i]; current; current = current->nextRow){
+                magnitudes[length++] = fabsf(current->value);
+            }
+
+            //Values above the threshold are kept, and as many equal to it as fit in k
+            threshold = k > 0 ? _sparse_matrix_select_largest(magnitudes, length, k) : INFINITY;
+            numberEqual = k;
+
+            for(int t = 0; t < length; t++){
+                numberEqual -= magnitudes[t] > threshold;
+            }
+
+            dropping = 1;
+        }
+
+        else{
+            for(Cell *current = matrix->rows[i]; current && !dropping; current = current->nextRow){
+                dropping = fabsf(current->value) < tolerance || current->value == 0;
+            }
+        }
+
+        if(dropping){
+            _sparse_matrix_private_row(matrix, i);
+        }
+
+        Cell **link = &matrix->rows[i];
+
+        while(*link){
+            Cell *current = *link;
+            int column = current->positionColumn;
+            matrix_value_type magnitude = fabsf(current->value);
+            int keep = magnitude >= threshold && current->value != 0;
+
+            if(keep && k >= 0 && magnitude == threshold){
+                keep = numberEqual-- > 0;
+            }
+
+            if(keep){
+                columnPrevious[column] = current;
+                link = &current->nextRow;
+                continue;
+            }
+
+            *link = current->nextRow;
+
+            if(!matrix->columnsDetached){
+                if(columnPrevious[column]){
+                    columnPrevious[column]->nextColumn = current->nextColumn;
+                }
+
+                else{
+                    matrix->columns[column] = current->nextColumn;
+                }
+            }
+
+            _sparse_matrix_free_cell(matrix, current);
+            removed++;
+        }
+    }
+
+    matrix->numberNonNullValues -= removed;
+    matrix->version++;
+    _sparse_matrix_drop_column_index(matrix);
+
+    free(columnPrevious);
+    free(magnitudes);
+
+    return removed;
+}
+
+/**
+ * @brief This function removes from a matrix the values smaller, in absolute value, than a tolerance (and any stored zero), in a unique pass over the rows and columns.
+ * 
+ * @brief Time Complexity: O(n + c), where n is the number of non-null values and c is the number of columns
+ * 
+ * @param matrix 
+ * The matrix that will be pruned
+ * @param tolerance 
+ * The smallest absolute value kept
+ * @return int 
+ * The number of values removed
+ */
+int sparse_matrix_prune(Sparse_Matrix *matrix, matrix_value_type tolerance){
+    INSTRUMENT_BEGIN();
+
+    int removed = _sparse_matrix_prune(matrix, tolerance, -1);
+
+    INSTRUMENT_END(INSTRUMENT_OP_PRUNE);
+    return removed;
+}
+
+/**
+ * @brief This function keeps in each row of a matrix only the k values of largest absolute value (the leftmost ones win a tie) and removes the others, in a unique pass over the rows and columns.
+ * 
+ * @brief Time Complexity: O(n + c) on average, where n is the number of non-null values and c is the number of columns
+ * 
+ * @param matrix 
+ * The matrix that will be pruned
+ * @param k 
+ * The number of values kept in each row
+ * @return int 
+ * The number of values removed
+ */
+int sparse_matrix_prune_top_k(Sparse_Matrix *matrix, int k){
+    INSTRUMENT_BEGIN();
+
+    if(k < 0){
+        printf("\033[91mError: invalid number of values!\n\033[0m");
+        exit(1);
+    }
+
+    int removed = _sparse_matrix_prune(matrix, 0, k);
+
+    INSTRUMENT_END(INSTRUMENT_OP_PRUNE);
+    return removed;
+}
+
+/**
+ * @brief This function creates a builder, which fills a new matrix with values given in row-major order (increasing rows and, inside a row, increasing columns). Since the order is known, each value is linked at the end of its row and of its column with no search.
+ * 
+ * @brief Time Complexity: O(r + c), because the headers and the tails of the rows and columns are allocated
+ * 
+ * @param numberRows 
+ * The number of rows of the new matrix
+ * @param numberColumns 
+ * The number of columns of the new matrix
+ * @return Sparse_Matrix_Builder* 
+ * The new builder
+ */
+Sparse_Matrix_Builder *sparse_matrix_builder_create(int numberRows, int numberColumns){
+    if(numberRows < 1 || numberColumns < 1){
+        printf("\033[91mError: invalid index was read!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix_Builder *builder = (Sparse_Matrix_Builder *)malloc(sizeof(Sparse_Matrix_Builder));
+
+    builder->matrix = sparse_matrix_create();
+    _sparse_matrix_realloc(builder->matrix, numberRows - 1, numberColumns - 1);
+
+    builder->rowTails = (Cell **)calloc(numberRows, sizeof(Cell *));
+    builder->columnTails = (Cell **)calloc(numberColumns, sizeof(Cell *));
+    builder->lastRow = 0;
+    builder->lastColumn = -1;
+    builder->numberRows = numberRows;
+    builder->numberColumns = numberColumns;
+
+    return builder;
+}
+
+/**
+ * @brief This function appends a value to the matrix of a builder. Null values are skipped, and positions past the size given at the creation make the matrix grow.
+ * 
+ * @brief Time Complexity: O(1), because the value is linked after the tails of its row and column (amortized, when the matrix grows)
+ * 
+ * @param builder 
+ * The builder of the matrix
+ * @param data 
+ * The value that will be appended
+ * @param row 
+ * The row of the value, not smaller than the row of the last value appended
+ * @param column 
+ * The column of the value, greater than the column of the last value appended if they are in the same row
+ */
+void sparse_matrix_builder_append(Sparse_Matrix_Builder *builder, matrix_value_type data, int row, int column){
+    Sparse_Matrix *matrix = builder->matrix;
+
+    if(row < builder->lastRow || (row == builder->lastRow && column <= builder->lastColumn) || column < 0){
+        printf("\033[91mError: the values must be appended in row-major order!\n\033[0m");
+        exit(1);
+    }
+
+    builder->lastRow = row;
+    builder->lastColumn = column;
+
+    if(row >= builder->numberRows){
+        builder->numberRows = row + 1;
+    }
+
+    if(column >= builder->numberColumns){
+        builder->numberColumns = column + 1;
+    }
+
+    if(data == 0){
+        return;
+    }
+
+    if(row > matrix->numberRows - 1 || column > matrix->numberColumns - 1){
+        int oldRows = matrix->numberRows;
+        int oldColumns = matrix->numberColumns;
+
+        int newRows = oldRows;
+        int newColumns = oldColumns;
+
+        //Grows at least twice, so a builder created too small doesn't reallocate on every value
+        if(row >= oldRows){
+            newRows = row + 1 > 2 * oldRows ? row + 1 : 2 * oldRows;
+        }
+
+        if(column >= oldColumns){
+            newColumns = column + 1 > 2 * oldColumns ? column + 1 : 2 * oldColumns;
+        }
+
+        _sparse_matrix_realloc(matrix, newRows - 1, newColumns - 1);
+
+        builder->rowTails = (Cell **)realloc(builder->rowTails, matrix->numberRows * sizeof(Cell *));
+        builder->columnTails = (Cell **)realloc(builder->columnTails, matrix->numberColumns * sizeof(Cell *));
+
+        for(int i = oldRows; i < matrix->numberRows; i++){
+            builder->rowTails[i] = NULL;
+        }
+
+        for(int j = oldColumns; j < matrix->numberColumns; j++){
+            builder->columnTails[j] = NULL;
+        }
+    }
+
+    Cell *cell = cell_creating(column, row, data, NULL, NULL);
+
+    if(builder->rowTails[row]){
+        builder->rowTails[row]->nextRow = cell;
+    }
+
+    else{
+        matrix->rows[row] = cell;
+    }
+
+    if(builder->columnTails[column]){
+        builder->columnTails[column]->nextColumn = cell;
+    }
+
+    else{
+        matrix->columns[column] = cell;
+    }
+
+    builder->rowTails[row] = cell;
+    builder->columnTails[column] = cell;
+    matrix->numberNonNullValues++;
+}
+
+/**
+ * @brief This function frees a builder and returns the matrix it filled, with the size given at the creation or up to the last row and column used if they are greater.
+ * 
+ * @brief Time Complexity: O(1), because only the tails are freed and the headers are shrunk
+ * 
+ * @param builder 
+ * The builder that will be finished
+ * @return Sparse_Matrix* 
+ * The matrix built
+ */
+Sparse_Matrix *sparse_matrix_builder_finish(Sparse_Matrix_Builder *builder){
+    Sparse_Matrix *matrix = builder->matrix;
+
+    //The headers may have grown past the last index used
+    if(matrix->numberRows > builder->numberRows){
+        matrix->rows = (Cell **)realloc(matrix->rows, builder->numberRows * sizeof(Cell *));
+        matrix->numberRows = builder->numberRows;
+    }
+
+    if(matrix->numberColumns > builder->numberColumns){
+        matrix->columns = (Cell **)realloc(matrix->columns, builder->numberColumns * sizeof(Cell *));
+        matrix->numberColumns = builder->numberColumns;
+    }
+
+    matrix->version++;
+
+    free(builder->rowTails);
+    free(builder->columnTails);
+    free(builder);
+
+    return matrix;
+}
+
+/**
+ * @brief This function returns the value of an index in sparse matrix. If the index doesn't represent a valid cell, 0.0 is returned.
+ * 
+ * @brief Time Complexity: O(n), because this function loops through the entire list of size n to check if the value exists
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @param row 
+ * The row wanted
+ * @param column 
+ * The column wanted
+ * @return matrix_value_type 
+ * The value of that index (null or non-null)
+ */
+matrix_value_type sparse_matrix_get_by_index(Sparse_Matrix *matrix, int row, int column){
+    INSTRUMENT_BEGIN();
+
+    if(matrix->locks){
+        matrix_value_type value = _sparse_matrix_concurrent_get(matrix, row, column);
+        INSTRUMENT_END(INSTRUMENT_OP_GET_BY_INDEX);
+        return value;
+    }
+
+    Cell *aux = sparse_matrix_index_exists(matrix, row, column);
+
+    if(aux == NULL){
+        INSTRUMENT_END(INSTRUMENT_OP_GET_BY_INDEX);
+        return 0.0;
+    }
+
+    else{
+        INSTRUMENT_END(INSTRUMENT_OP_GET_BY_INDEX);
+        return aux->value;
+    }
+}
+
+/**
+ * @brief This function returns the sum of the values in the matrix.
+ * 
+ * @brief Time Complexity: O(n), because only the non-null values are visited
+ * 
+ * @param matrix 
+ * The matrix that will be operated
+ * @return matrix_value_type 
+ * The sum of the values in the matrix
+ */
+matrix_value_type _sparse_matrix_sum_cells(Sparse_Matrix *matrix){
+    return sparse_matrix_sum_values(matrix);
+}
+
+/**
+ * @brief This function returns the sum of all values in the matrix.
+ * 
+ * @brief Time Complexity: O(n), because each non-null value is visited once with the row cursors
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return matrix_value_type 
+ * The sum of the values
+ */
+matrix_value_type sparse_matrix_sum_values(Sparse_Matrix *matrix){
+    Sparse_Matrix_Cursor cursor;
+    matrix_value_type sum = 0;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            sum += cursor.value;
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * @brief This function computes the sum of each row of the matrix.
+ * 
+ * @brief Time Complexity: O(n + r), because each non-null value is visited once and each row is written once
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @param result 
+ * The array of size numberRows that will receive the sums
+ */
+void sparse_matrix_row_sums(Sparse_Matrix *matrix, matrix_value_type *result){
+    Sparse_Matrix_Cursor cursor;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        result[i] = 0;
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            result[i] += cursor.value;
+        }
+    }
+}
+
+/**
+ * @brief This function computes the sum of each column of the matrix.
+ * 
+ * @brief Time Complexity: O(n + c), because each non-null value is visited once and each column is written once
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @param result 
+ * The array of size numberColumns that will receive the sums
+ */
+void sparse_matrix_column_sums(Sparse_Matrix *matrix, matrix_value_type *result){
+    Sparse_Matrix_Cursor cursor;
+
+    for(int j = 0; j < matrix->numberColumns; j++){
+        result[j] = 0;
+    }
+
+    //The rows are walked in increasing order, so each column is added in the same order as a column walk
+    for(int i = 0; i < matrix->numberRows; i++){
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            result[cursor.column] += cursor.value;
+        }
+    }
+}
+
+/**
+ * @brief This function counts the non-null values of each row of the matrix.
+ * 
+ * @brief Time Complexity: O(n + r), because each non-null value is visited once and each row is written once
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @param result 
+ * The array of size numberRows that will receive the counts
+ */
+void sparse_matrix_row_non_null(Sparse_Matrix *matrix, int *result){
+    Sparse_Matrix_Cursor cursor;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        result[i] = 0;
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            result[i]++;
+        }
+    }
+}
+
+/**
+ * @brief This function returns the smallest or the largest value of the matrix. The null positions count as values too, so 0 is considered when the matrix isn't full.
+ * 
+ * @brief Time Complexity: O(n), because each non-null value is visited once
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @param largest 
+ * 1 to find the largest value or 0 to find the smallest
+ * @return matrix_value_type 
+ * The value found
+ */
+static matrix_value_type _sparse_matrix_extreme(Sparse_Matrix *matrix, int largest){
+    Sparse_Matrix_Cursor cursor;
+    int found = 0;
+    matrix_value_type extreme = 0;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            if(!found || (largest ? cursor.value > extreme : cursor.value < extreme)){
+                extreme = cursor.value;
+                found = 1;
+            }
+        }
+    }
+
+    if((long)matrix->numberNonNullValues < (long)matrix->numberRows * matrix->numberColumns){
+        if(!found || (largest ? extreme < 0 : extreme > 0)){
+            extreme = 0;
+        }
+    }
+
+    return extreme;
+}
+
+/**
+ * @brief This function returns the smallest value of the matrix, null positions included.
+ * 
+ * @brief Time Complexity: O(n), because each non-null value is visited once
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return matrix_value_type 
+ * The smallest value
+ */
+matrix_value_type sparse_matrix_min(Sparse_Matrix *matrix){
+    return _sparse_matrix_extreme(matrix, 0);
+}
+
+/**
+ * @brief This function returns the largest value of the matrix, null positions included.
+ * 
+ * @brief Time Complexity: O(n), because each non-null value is visited once
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return matrix_value_type 
+ * The largest value
+ */
+matrix_value_type sparse_matrix_max(Sparse_Matrix *matrix){
+    return _sparse_matrix_extreme(matrix, 1);
+}
+
+/**
+ * @brief This function returns the Frobenius norm of the matrix, the square root of the sum of the squared values.
+ * 
+ * @brief Time Complexity: O(n), because each non-null value is visited once
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return matrix_value_type 
+ * The Frobenius norm
+ */
+matrix_value_type sparse_matrix_norm_frobenius(Sparse_Matrix *matrix){
+    Sparse_Matrix_Cursor cursor;
+    double sum = 0;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            sum += (double)cursor.value * cursor.value;
+        }
+    }
+
+    return (matrix_value_type)sqrt(sum);
+}
+
+/**
+ * @brief This function returns the L1 norm of the matrix, the largest sum of absolute values of a column.
+ * 
+ * @brief Time Complexity: O(n + c), because each non-null value is visited once with the row cursors
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return matrix_value_type 
+ * The L1 norm
+ */
+matrix_value_type sparse_matrix_norm_one(Sparse_Matrix *matrix){
+    Sparse_Matrix_Cursor cursor;
+    matrix_value_type *sums = (matrix_value_type *)calloc(matrix->numberColumns, sizeof(matrix_value_type));
+    matrix_value_type norm = 0;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            sums[cursor.column] += fabsf(cursor.value);
+        }
+    }
+
+    for(int j = 0; j < matrix->numberColumns; j++){
+        if(sums[j] > norm){
+            norm = sums[j];
+        }
+    }
+
+    free(sums);
+
+    return norm;
+}
+
+/**
+ * @brief This function returns the L-infinity norm of the matrix, the largest sum of absolute values of a row.
+ * 
+ * @brief Time Complexity: O(n + r), because each non-null value is visited once with the row cursors
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return matrix_value_type 
+ * The L-infinity norm
+ */
+matrix_value_type sparse_matrix_norm_infinity(Sparse_Matrix *matrix){
+    Sparse_Matrix_Cursor cursor;
+    matrix_value_type norm = 0;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        matrix_value_type sum = 0;
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor)){
+            sum += fabsf(cursor.value);
+        }
+
+        if(sum > norm){
+            norm = sum;
+        }
+    }
+
+    return norm;
+}
+
+/**
+ * @brief This function returns the trace of the matrix, the sum of the values of the main diagonal.
+ * 
+ * @brief Time Complexity: O(n), because each row is walked only until its diagonal position (the rows are sorted)
+ * 
+ * @param matrix 
+ * The matrix that will be evaluated
+ * @return matrix_value_type 
+ * The trace
+ */
+matrix_value_type sparse_matrix_trace(Sparse_Matrix *matrix){
+    Sparse_Matrix_Cursor cursor;
+    matrix_value_type trace = 0;
+
+    for(int i = 0; i < matrix->numberRows && i < matrix->numberColumns; i++){
+        cursor = sparse_matrix_row_cursor(matrix, i);
+
+        while(sparse_matrix_cursor_next(&cursor) && cursor.column <= i){
+            if(cursor.column == i){
+                trace += cursor.value;
+            }
+        }
+    }
+
+    return trace;
+}
+
+/**
+ * @brief This function multiplies a sparse matrix by a dense vector (result = matrix * vector), walking each row list once.
+ * 
+ * @brief Time Complexity: O(n), because each non-null value is visited once
+ * 
+ * @param matrix 
+ * The matrix that will be operated
+ * @param vector 
+ * The vector of size numberColumns
+ * @param result 
+ * The vector of size numberRows that will receive the product
+ */
+void sparse_matrix_multiply_vector(Sparse_Matrix *matrix, const matrix_value_type *vector, matrix_value_type *result){
+    INSTRUMENT_BEGIN();
+
+    Cell *current;
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        matrix_value_type sum = 0;
+        current = matrix->rows[i];
+
+        while(current){
+            sum += current->value * vector[current->positionColumn];
+            current = current->nextRow;
+        }
+
+        result[i] = sum;
+    }
+
+    INSTRUMENT_END(INSTRUMENT_OP_MULTIPLY_VECTOR);
+}
+
+/**
+ * @brief This function multiply the values of a sparse matrix by a scalar k and returns a new sparse matrix.
+ * 
+ * @brief Time Complexity: O(2n^3), because this function traverses the list of size n, n times, with complexity 2n when accommodating the value
+ * 
+ * @param matrix 
+ * The original matrix
+ * @param scalar 
+ * The factor by which the values ​​will be multiplied
+ * @return Sparse_Matrix* 
+ * The new matrix with multiplied values
+ */
+Sparse_Matrix *sparse_matrix_multiply_scalar(Sparse_Matrix *matrix, matrix_value_type scalar){
+    INSTRUMENT_BEGIN();
+
+    Cell *current;
+
+    Sparse_Matrix *new_matrix = sparse_matrix_create();
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        current = matrix->rows[i];
+
+        while(current){
+            sparse_matrix_set_by_index(new_matrix, current->value * scalar, current->positionRow, current->positionColumn);
+            current = current->nextRow;
+        }
+    }
+
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nMATRIX FOR SCALAR MULTIPLICATION BY %.2f:\n\033[0m", scalar);
+        sparse_matrix_show_dense(matrix);
+        printf("\033[92m\nRESULT OF SCALAR MULTIPLICATION BY %.2f:\n\033[0m", scalar);
+        sparse_matrix_show_dense(new_matrix);
+        printf("\033[92m----------------------------------------------\n\033[0m");
+    }
+
+    INSTRUMENT_END(INSTRUMENT_OP_MULTIPLY_SCALAR);
+    return new_matrix;
+}
+
+/**
+ * @brief This function adds the values of two matrices and returns a new sparse matrix.
+ * 
+ * @brief Time Complexity: O(2n^4), because this function loops through the list of size n, n times. And in each repetition, it goes through the list to get the value and it takes 2n to accommodate the value in the new matrix
+ * 
+ * @param matrix1 
+ * The first matrix
+ * @param matrix2
+ * The second matrix
+ * @return Sparse_Matrix* 
+ * The new sparse matrix that contains the result of the sum
+ */
+Sparse_Matrix *sparse_matrix_sum(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2){
+    INSTRUMENT_BEGIN();
+
+    if(matrix1->numberRows != matrix2->numberRows || matrix1->numberColumns != matrix2->numberColumns){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix *new_matrix = sparse_matrix_create();
+    Cell *current;
+
+    for(int i = 0; i < matrix1->numberRows; i++){
+        current = matrix1->rows[i];
+
+        while(current){
+            matrix_value_type data = sparse_matrix_get_by_index(matrix2, i, current->positionColumn) + current->value;
+            sparse_matrix_set_by_index(new_matrix, data, i, current->positionColumn);
+            current = current->nextRow;
+        }
+    }
+
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nFIRST MATRIX FOR SUM:\n\033[0m");
+        sparse_matrix_show_dense(matrix1);
+        printf("\033[92m\nSECOND MATRIX FOR SUM:\n\033[0m");
+        sparse_matrix_show_dense(matrix2);
+        printf("\033[92m\nRESULT OF MATRICES SUM:\n\033[0m");
+        sparse_matrix_show_dense(new_matrix);
+        printf("\033[92m----------------------------------------------\n\033[0m");
+    }
+
+    INSTRUMENT_END(INSTRUMENT_OP_SUM);
+    return new_matrix;
+}
+
+/**
+ * @brief This function computes the linear combination alpha * matrix1 + beta * matrix2 and returns a new sparse matrix. The sorted rows of both matrices are merged once and the result is linked directly, with no intermediate matrices; values that cancel to exactly zero aren't stored.
+ * 
+ * @brief Time Complexity: O(n1 + n2 + r + c), because each non-null value of both matrices is visited once
+ * 
+ * @param alpha 
+ * The factor of the first matrix
+ * @param matrix1 
+ * The first matrix
+ * @param beta 
+ * The factor of the second matrix
+ * @param matrix2 
+ * The second matrix
+ * @return Sparse_Matrix* 
+ * The new matrix with the combination
+ */
+Sparse_Matrix *sparse_matrix_axpby(matrix_value_type alpha, Sparse_Matrix *matrix1, matrix_value_type beta, Sparse_Matrix *matrix2){
+    INSTRUMENT_BEGIN();
+
+    if(matrix1->numberRows != matrix2->numberRows || matrix1->numberColumns != matrix2->numberColumns){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(matrix1->numberRows, matrix1->numberColumns);
+    Cell *first, *second;
+
+    for(int i = 0; i < matrix1->numberRows; i++){
+        first = matrix1->rows[i];
+        second = matrix2->rows[i];
+
+        while(first || second){
+            if(second == NULL || (first && first->positionColumn < second->positionColumn)){
+                sparse_matrix_builder_append(builder, alpha * first->value, i, first->positionColumn);
+                first = first->nextRow;
+            }
+
+            else if(first == NULL || second->positionColumn < first->positionColumn){
+                sparse_matrix_builder_append(builder, beta * second->value, i, second->positionColumn);
+                second = second->nextRow;
+            }
+
+            else{
+                sparse_matrix_builder_append(builder, alpha * first->value + beta * second->value, i, first->positionColumn);
+                first = first->nextRow;
+                second = second->nextRow;
+            }
+        }
+    }
+
+    INSTRUMENT_END(INSTRUMENT_OP_AXPBY);
+    return sparse_matrix_builder_finish(builder);
+}
+
+/**
+ * @brief This function multiplies every value of a matrix by a factor in place, unlinking and freeing the values that become zero. It's the aliased case of sparse_matrix_axpy, where the values of the matrix being added are the ones being changed.
+ * 
+ * @brief Time Complexity: O(n + r + c), because each non-null value is visited once
+ */
+static void _sparse_matrix_scale_in_place(Sparse_Matrix *matrix, matrix_value_type factor){
+    _sparse_matrix_attach_columns(matrix);
+
+    //columnPrevious[j] is the last cell kept in column j above the current row (NULL if there is none)
+    Cell **columnPrevious = (Cell **)calloc(matrix->numberColumns, sizeof(Cell *));
+
+    for(int i = 0; i < matrix->numberRows; i++){
+        _sparse_matrix_private_row(matrix, i);
+
+        Cell *previous = NULL;
+        Cell *current = matrix->rows[i];
+
+        while(current){
+            Cell *next = current->nextRow;
+            int column = current->positionColumn;
+
+            current->value *= factor;
+
+            if(current->value != 0){
+                previous = current;
+                columnPrevious[column] = current;
+                current = next;
+                continue;
+            }
+
+            if(previous){
+                previous->nextRow = next;
+            }
+
+            else{
+                matrix->rows[i] = next;
+            }
+
+            if(columnPrevious[column]){
+                columnPrevious[column]->nextColumn = current->nextColumn;
+            }
+
+            else{
+                matrix->columns[column] = current->nextColumn;
+            }
+
+            _sparse_matrix_free_cell(matrix, current);
+            matrix->numberNonNullValues--;
+            current = next;
+        }
+    }
+
+    matrix->version++;
+    free(columnPrevious);
+}
+
+/**
+ * @brief This function adds alpha * matrix2 to matrix1 in place. The rows are merged once; new values are linked into the row and column lists while they are walked, and values that cancel to exactly zero are unlinked and freed. When both are the same matrix, its values are scaled by 1 + alpha instead.
+ * 
+ * @brief Time Complexity: O(n1 + n2 + c), because each non-null value of both matrices is visited once (the columns of matrix1 are walked at most once in total)
+ * 
+ * @param matrix1 
+ * The matrix that will be changed
+ * @param alpha 
+ * The factor of the second matrix
+ * @param matrix2 
+ * The matrix that will be added
+ */
+void sparse_matrix_axpy(Sparse_Matrix *matrix1, matrix_value_type alpha, Sparse_Matrix *matrix2){
+    INSTRUMENT_BEGIN();
+
+    if(matrix1->numberRows != matrix2->numberRows || matrix1->numberColumns != matrix2->numberColumns){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    //Merging a matrix with itself would free cells still to be read through matrix2
+    if(matrix1 == matrix2){
+        _sparse_matrix_scale_in_place(matrix1, 1 + alpha);
+
+        INSTRUMENT_END(INSTRUMENT_OP_AXPY);
+        return;
+    }
+
+    _sparse_matrix_attach_columns(matrix1);
+
+    //columnPrevious[j] is the last cell of column j above the current row (NULL if there is none)
+    Cell **columnPrevious = (Cell **)calloc(matrix1->numberColumns, sizeof(Cell *));
+    Cell *current, *previous, *other, *above, *below;
+
+    for(int i = 0; i < matrix1->numberRows; i++){
+        if(matrix2->rows[i]){
+            _sparse_matrix_private_row(matrix1, i);
+        }
+
+        current = matrix1->rows[i];
+        previous = NULL;
+        other = matrix2->rows[i];
+
+        while(other){
+            int column = other->positionColumn;
+            matrix_value_type data = alpha * other->value;
+
+            while(current && current->positionColumn < column){
+                previous = current;
+                current = current->nextRow;
+            }
+
+            above = columnPrevious[column];
+            below = above ? above->nextColumn : matrix1->columns[column];
+
+            while(below && below->positionRow < i){
+                above = below;
+                below = below->nextColumn;
+            }
+
+            columnPrevious[column] = above;
+
+            if(current && current->positionColumn == column){
+                current->value += data;
+
+                if(current->value == 0){
+                    Cell *next = current->nextRow;
+
+                    if(previous){
+                        previous->nextRow = next;
+                    }
+
+                    else{
+                        matrix1->rows[i] = next;
+                    }
+
+                    if(above){
+                        above->nextColumn = current->nextColumn;
+                    }
+
+                    else{
+                        matrix1->columns[column] = current->nextColumn;
+                    }
+
+                    _sparse_matrix_free_cell(matrix1, current);
+                    matrix1->numberNonNullValues--;
+                    current = next;
+                }
+            }
 
-    if(aux == NULL){
-        return 0.0;
-    }
+            else if(data != 0){
+                Cell *cell = cell_creating(column, i, data, current, below);
 
-    else{
-        return aux->value;
+                if(previous){
+                    previous->nextRow = cell;
+                }
+
+                else{
+                    matrix1->rows[i] = cell;
+                }
+
+                if(above){
+                    above->nextColumn = cell;
+                }
+
+                else{
+                    matrix1->columns[column] = cell;
+                }
+
+                previous = cell;
+                matrix1->numberNonNullValues++;
+            }
+
+            other = other->nextRow;
+        }
     }
+
+    matrix1->version++;
+    free(columnPrevious);
+
+    INSTRUMENT_END(INSTRUMENT_OP_AXPY);
 }
 
 /**
- * @brief This function returns the sum of the values in the matrix.
- * 
- * @brief Time Complexity: O(n^2), because this function traverses the list of size n, n times
+ * @brief This function compares two integers, to sort the columns of a row.
  * 
- * @param matrix 
- * The matrix that will be operated
- * @return matrix_value_type 
- * The sum of the values in the matrix
+ * @brief Time Complexity: O(1), because only two values are compared
  */
-matrix_value_type _sparse_matrix_sum_cells(Sparse_Matrix *matrix){
-    matrix_value_type sum = 0;
-
-    for(int i = 0; i < matrix->numberRows; i++){
-        for(int j = 0; j < matrix->numberColumns; j++){
-            sum += sparse_matrix_get_by_index(matrix, i, j);
-        }
-    }
-
-    return sum;
+static int _sparse_matrix_compare_columns(const void *a, const void *b){
+    return *(const int *)a - *(const int *)b;
 }
 
 /**
- * @brief This function multiply the values of a sparse matrix by a scalar k and returns a new sparse matrix.
+ * @brief This function multiplies two matrices and drops the values of the product smaller (in absolute value) than a tolerance while the rows are accumulated, so they are never stored. Nothing is printed.
  * 
- * @brief Time Complexity: O(2n^3), because this function traverses the list of size n, n times, with complexity 2n when accommodating the value
+ * @brief Time Complexity: O(f + r*log(c) + c), where f is the number of multiplications of non-null values, r is the number of rows of matrix1 and c is the number of columns of matrix2
  * 
- * @param matrix 
- * The original matrix
- * @param scalar 
- * The factor by which the values ​​will be multiplied
+ * @param matrix1 
+ * The first matrix to multiply
+ * @param matrix2 
+ * The second matrix to multiply
+ * @param tolerance 
+ * The smallest absolute value kept (0 keeps every non-null value)
  * @return Sparse_Matrix* 
- * The new matrix with multiplied values
+ * The new matrix resulting from the multiplication
  */
-Sparse_Matrix *sparse_matrix_multiply_scalar(Sparse_Matrix *matrix, matrix_value_type scalar){
-    Cell *current;
-
-    Sparse_Matrix *new_matrix = sparse_matrix_create();
-
-    for(int i = 0; i < matrix->numberRows; i++){
-        current = matrix->rows[i];
-
-        while(current){
-            sparse_matrix_set_by_index(new_matrix, current->value * scalar, current->positionRow, current->positionColumn);
-            current = current->nextRow;
-        }
-    }
+Sparse_Matrix *sparse_matrix_multiplication_pruned(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, matrix_value_type tolerance){
+    INSTRUMENT_BEGIN();
 
-    printf("\033[92m----------------------------------------------\nMATRIX FOR SCALAR MULTIPLICATION BY %.2f:\n\033[0m", scalar);
-    sparse_matrix_show_dense(matrix);
-    printf("\033[92m\nRESULT OF SCALAR MULTIPLICATION BY %.2f:\n\033[0m", scalar);
-    sparse_matrix_show_dense(new_matrix);
-    printf("\033[92m----------------------------------------------\n\033[0m");
+    Sparse_Matrix *new_matrix = _semiring_multiplication(matrix1, matrix2, SEMIRING_PLUS_TIMES, tolerance);
 
+    INSTRUMENT_END(INSTRUMENT_OP_MULTIPLICATION_PRUNED);
     return new_matrix;
 }
 
 /**
- * @brief This function adds the values of two matrices and returns a new sparse matrix.
+ * @brief This function multiplies two matrices.
  * 
- * @brief Time Complexity: O(2n^4), because this function loops through the list of size n, n times. And in each repetition, it goes through the list to get the value and it takes 2n to accommodate the value in the new matrix
+ * @brief Time Complexity: O(f + r*log(c) + c), where f is the number of multiplications of non-null values (Gustavson's algorithm, see _semiring_multiplication)
  * 
  * @param matrix1 
- * The first matrix
- * @param matrix2
- * The second matrix
+ * The first matrix to multiply
+ * @param matrix2 
+ * The second matrix to multiply
  * @return Sparse_Matrix* 
- * The new sparse matrix that contains the result of the sum
+ * The new matrix resulting from the multiplication
  */
-Sparse_Matrix *sparse_matrix_sum(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2){
-    if(matrix1->numberRows != matrix2->numberRows || matrix1->numberColumns != matrix2->numberColumns){
-        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
-        exit(1);
-    }
-
-    Sparse_Matrix *new_matrix = sparse_matrix_create();
-    Cell *current;
-
-    for(int i = 0; i < matrix1->numberRows; i++){
-        current = matrix1->rows[i];
-
-        while(current){
-            matrix_value_type data = sparse_matrix_get_by_index(matrix2, i, current->positionColumn) + current->value;
-            sparse_matrix_set_by_index(new_matrix, data, i, current->positionColumn);
-            current = current->nextRow;
-        }
+Sparse_Matrix *sparse_matrix_multiplication(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2){
+    INSTRUMENT_BEGIN();
+
+    Sparse_Matrix *new_matrix = _semiring_multiplication(matrix1, matrix2, SEMIRING_PLUS_TIMES, 0);
+
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nFIRST MATRIX FOR MULTIPLICATION:\n\033[0m");
+        sparse_matrix_show_dense(matrix1);
+        printf("\033[92m\nSECOND MATRIX FOR MULTIPLICATION:\n\033[0m");
+        sparse_matrix_show_dense(matrix2);
+        printf("\033[92m\nRESULT OF MATRICES MULTIPLICATION:\n\033[0m");
+        sparse_matrix_show_dense(new_matrix);
+        printf("\033[92m----------------------------------------------\n\033[0m");
     }
 
-    printf("\033[92m----------------------------------------------\nFIRST MATRIX FOR SUM:\n\033[0m");
-    sparse_matrix_show_dense(matrix1);
-    printf("\033[92m\nSECOND MATRIX FOR SUM:\n\033[0m");
-    sparse_matrix_show_dense(matrix2);
-    printf("\033[92m\nRESULT OF MATRICES SUM:\n\033[0m");
-    sparse_matrix_show_dense(new_matrix);
-    printf("\033[92m----------------------------------------------\n\033[0m");
-
+    INSTRUMENT_END(INSTRUMENT_OP_MULTIPLICATION);
     return new_matrix;
 }
 
 /**
- * @brief This function multiplies two matrices.
+ * @brief This function multiplies two matrices keeping only the positions selected by a mask: C = (matrix1 * matrix2) .* M. The mask is structural, so any value stored in it selects its position. With a plain mask, each position of the mask is computed by merging the sorted row of matrix1 with the sorted column of matrix2, so the work and memory follow the mask and not the full product. With a complemented mask, the positions selected are the ones that are NOT in the mask; the rows of the product are accumulated from the rows of matrix2 (Gustavson's algorithm) and the positions in the mask are skipped. Nothing is printed.
  * 
- * @brief Time Complexity: O(4n^4), because this function loops through a list of size n, n times. And each repetition takes a process O(2n) and two processes O(n)
+ * @brief Time Complexity: O(m * (a + b)) with a plain mask, where m is the number of values of the mask and a and b are the mean lengths of the rows of matrix1 and of the columns of matrix2; O(f + r*log(c)) with a complemented mask, where f is the number of multiplications of non-null values
  * 
  * @param matrix1 
  * The first matrix to multiply
  * @param matrix2 
  * The second matrix to multiply
+ * @param mask 
+ * The matrix whose positions select the values computed (same number of rows as matrix1 and of columns as matrix2)
+ * @param complement 
+ * 1 to compute the positions out of the mask or 0 to compute the positions in the mask
  * @return Sparse_Matrix* 
- * The new matrix resulting from the multiplication
+ * The new matrix with the masked product
  */
-Sparse_Matrix *sparse_matrix_multiplication(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2){
-    if(matrix1->numberColumns != matrix2->numberRows){
+Sparse_Matrix *sparse_matrix_multiplication_masked(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, Sparse_Matrix *mask, int complement){
+    INSTRUMENT_BEGIN();
+
+    if(matrix1->numberColumns != matrix2->numberRows || mask->numberRows != matrix1->numberRows || mask->numberColumns != matrix2->numberColumns){
         printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
         exit(1);
     }
 
-    Sparse_Matrix *new_matrix = sparse_matrix_create();
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(matrix1->numberRows, matrix2->numberColumns);
+    Cell *selected, *first, *second;
+
+    if(!complement){
+        for(int i = 0; i < matrix1->numberRows; i++){
+            for(selected = mask->rows[i]; selected; selected = selected->nextRow){
+                matrix_value_type sum = 0;
+
+                //The column is read with a cursor, so a clone isn't copied to walk it
+                Sparse_Matrix_Cursor column = sparse_matrix_column_cursor(matrix2, selected->positionColumn);
+                int more = sparse_matrix_cursor_next(&column);
+
+                first = matrix1->rows[i];
+
+                while(first && more){
+                    if(first->positionColumn < column.row){
+                        first = first->nextRow;
+                    }
+
+                    else if(column.row < first->positionColumn){
+                        more = sparse_matrix_cursor_next(&column);
+                    }
+
+                    else{
+                        sum += first->value * column.value;
+                        first = first->nextRow;
+                        more = sparse_matrix_cursor_next(&column);
+                    }
+                }
+
+                sparse_matrix_builder_append(builder, sum, i, selected->positionColumn);
+            }
+        }
+
+        INSTRUMENT_END(INSTRUMENT_OP_MULTIPLICATION_MASKED);
+        return sparse_matrix_builder_finish(builder);
+    }
+
+    //marker[j] == 2*i means that (i, j) is in the mask and marker[j] == 2*i + 1 that it was already reached in row i
+    int *marker = (int *)malloc(matrix2->numberColumns * sizeof(int));
+    int *touched = (int *)malloc(matrix2->numberColumns * sizeof(int));
+    matrix_value_type *accumulator = (matrix_value_type *)malloc(matrix2->numberColumns * sizeof(matrix_value_type));
+
+    for(int j = 0; j < matrix2->numberColumns; j++){
+        marker[j] = -1;
+    }
 
     for(int i = 0; i < matrix1->numberRows; i++){
-        float sum = 0;
+        int numberTouched = 0;
+
+        for(selected = mask->rows[i]; selected; selected = selected->nextRow){
+            marker[selected->positionColumn] = 2 * i;
+        }
+
+        for(first = matrix1->rows[i]; first; first = first->nextRow){
+            for(second = matrix2->rows[first->positionColumn]; second; second = second->nextRow){
+                int column = second->positionColumn;
+
+                if(marker[column] == 2 * i){
+                    continue;
+                }
+
+                if(marker[column] != 2 * i + 1){
+                    marker[column] = 2 * i + 1;
+                    accumulator[column] = 0;
+                    touched[numberTouched++] = column;
+                }
 
-        for(int j = 0; j < matrix2->numberColumns; j++){
-            for(int k = 0; k < matrix1->numberColumns; k++){
-                sum += (sparse_matrix_get_by_index(matrix1, i, k) * sparse_matrix_get_by_index(matrix2, k, j));
+                accumulator[column] += first->value * second->value;
             }
+        }
 
-            sparse_matrix_set_by_index(new_matrix, sum, i, j);
-            sum = 0;
+        qsort(touched, numberTouched, sizeof(int), _sparse_matrix_compare_columns);
+
+        for(int k = 0; k < numberTouched; k++){
+            sparse_matrix_builder_append(builder, accumulator[touched[k]], i, touched[k]);
         }
     }
 
-    printf("\033[92m----------------------------------------------\nFIRST MATRIX FOR MULTIPLICATION:\n\033[0m");
-    sparse_matrix_show_dense(matrix1);
-    printf("\033[92m\nSECOND MATRIX FOR MULTIPLICATION:\n\033[0m");
-    sparse_matrix_show_dense(matrix2);
-    printf("\033[92m\nRESULT OF MATRICES MULTIPLICATION:\n\033[0m");
-    sparse_matrix_show_dense(new_matrix);
-    printf("\033[92m----------------------------------------------\n\033[0m");
+    free(marker);
+    free(touched);
+    free(accumulator);
 
-    return new_matrix;
+    INSTRUMENT_END(INSTRUMENT_OP_MULTIPLICATION_MASKED);
+    return sparse_matrix_builder_finish(builder);
 }
 
 /**
@@ -501,6 +2665,8 @@ Sparse_Matrix *sparse_matrix_multiplication(Sparse_Matrix *matrix1, Sparse_Matri
  * The return is the new matrix created
  */
 Sparse_Matrix *sparse_matrix_multiply_point(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2){
+    INSTRUMENT_BEGIN();
+
     if(matrix1->numberRows != matrix2->numberRows || matrix1->numberColumns != matrix2->numberColumns){
         printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
         exit(1);
@@ -519,14 +2685,17 @@ Sparse_Matrix *sparse_matrix_multiply_point(Sparse_Matrix *matrix1, Sparse_Matri
         }
     }
 
-    printf("\033[92m----------------------------------------------\nFIRST MATRIX FOR POINT MULTIPLICATION:\n\033[0m");
-    sparse_matrix_show_dense(matrix1);
-    printf("\033[92m\nSECOND MATRIX FOR POINT MULTIPLICATION:\n\033[0m");
-    sparse_matrix_show_dense(matrix2);
-    printf("\033[92m\nRESULT OF MATRICES POINT MULTIPLICATION:\n\033[0m");
-    sparse_matrix_show_dense(new_matrix);
-    printf("\033[92m----------------------------------------------\n\033[0m");
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nFIRST MATRIX FOR POINT MULTIPLICATION:\n\033[0m");
+        sparse_matrix_show_dense(matrix1);
+        printf("\033[92m\nSECOND MATRIX FOR POINT MULTIPLICATION:\n\033[0m");
+        sparse_matrix_show_dense(matrix2);
+        printf("\033[92m\nRESULT OF MATRICES POINT MULTIPLICATION:\n\033[0m");
+        sparse_matrix_show_dense(new_matrix);
+        printf("\033[92m----------------------------------------------\n\033[0m");
+    }
 
+    INSTRUMENT_END(INSTRUMENT_OP_MULTIPLY_POINT);
     return new_matrix;
 }
 
@@ -541,6 +2710,8 @@ Sparse_Matrix *sparse_matrix_multiply_point(Sparse_Matrix *matrix1, Sparse_Matri
  * The return is the new matrix created
  */
 Sparse_Matrix *sparse_matrix_transpose(Sparse_Matrix *matrix){
+    INSTRUMENT_BEGIN();
+
     Sparse_Matrix *new_matrix = sparse_matrix_create();
     Cell *current;
 
@@ -553,12 +2724,15 @@ Sparse_Matrix *sparse_matrix_transpose(Sparse_Matrix *matrix){
         }
     }
 
-    printf("\033[92m----------------------------------------------\nMATRIX FOR TRANSPOSE:\n\033[0m");
-    sparse_matrix_show_dense(matrix);
-    printf("\033[92m\nRESULT OF MATRIX TRANSPOSE:\n\033[0m");
-    sparse_matrix_show_dense(new_matrix);
-    printf("\033[92m----------------------------------------------\n\033[0m");
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nMATRIX FOR TRANSPOSE:\n\033[0m");
+        sparse_matrix_show_dense(matrix);
+        printf("\033[92m\nRESULT OF MATRIX TRANSPOSE:\n\033[0m");
+        sparse_matrix_show_dense(new_matrix);
+        printf("\033[92m----------------------------------------------\n\033[0m");
+    }
 
+    INSTRUMENT_END(INSTRUMENT_OP_TRANSPOSE);
     return new_matrix;
 }
 
@@ -577,6 +2751,8 @@ Sparse_Matrix *sparse_matrix_transpose(Sparse_Matrix *matrix){
  * The new matrix created
  */
 Sparse_Matrix *sparse_matrix_swap_columns(Sparse_Matrix *matrix, int columnOne, int columnTwo){
+    INSTRUMENT_BEGIN();
+
     if(columnOne < 0 || columnTwo < 0 || columnOne == columnTwo || columnOne > matrix->numberColumns || columnTwo > matrix->numberColumns){
         printf("\033[91mError: couldn't change these indexes!\n\033[0m");
         exit(1);
@@ -606,12 +2782,15 @@ Sparse_Matrix *sparse_matrix_swap_columns(Sparse_Matrix *matrix, int columnOne,
         }
     }
 
-    printf("\033[92m----------------------------------------------\nMATRIX FOR COLUMNS SWAP - COLUMNS [%d] and [%d]:\n\033[0m", columnOne, columnTwo);
-    sparse_matrix_show_dense(matrix);
-    printf("\033[92m\nRESULT OF COLUMNS SWAP:\n\033[0m");
-    sparse_matrix_show_dense(new_matrix);
-    printf("\033[92m----------------------------------------------\n\033[0m");
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nMATRIX FOR COLUMNS SWAP - COLUMNS [%d] and [%d]:\n\033[0m", columnOne, columnTwo);
+        sparse_matrix_show_dense(matrix);
+        printf("\033[92m\nRESULT OF COLUMNS SWAP:\n\033[0m");
+        sparse_matrix_show_dense(new_matrix);
+        printf("\033[92m----------------------------------------------\n\033[0m");
+    }
 
+    INSTRUMENT_END(INSTRUMENT_OP_SWAP_COLUMNS);
     return new_matrix;
 }
 
@@ -630,6 +2809,8 @@ Sparse_Matrix *sparse_matrix_swap_columns(Sparse_Matrix *matrix, int columnOne,
  * The new matrix created
  */
 Sparse_Matrix *sparse_matrix_swap_rows(Sparse_Matrix *matrix, int rowOne, int rowTwo){
+    INSTRUMENT_BEGIN();
+
     if(rowOne < 0 || rowTwo < 0 || rowOne == rowTwo || rowOne > matrix->numberRows || rowTwo > matrix->numberRows){
         printf("\033[91mError: couldn't change these indexes!\n\033[0m");
         exit(1);
@@ -659,12 +2840,15 @@ Sparse_Matrix *sparse_matrix_swap_rows(Sparse_Matrix *matrix, int rowOne, int ro
         }
     }
 
-    printf("\033[92m----------------------------------------------\nMATRIX FOR ROWS SWAP - ROWS [%d] and [%d]:\n\033[0m", rowOne, rowTwo);
-    sparse_matrix_show_dense(matrix);
-    printf("\033[92m\nRESULT OF ROWS SWAP:\n\033[0m");
-    sparse_matrix_show_dense(new_matrix);
-    printf("\033[92m----------------------------------------------\n\033[0m");
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nMATRIX FOR ROWS SWAP - ROWS [%d] and [%d]:\n\033[0m", rowOne, rowTwo);
+        sparse_matrix_show_dense(matrix);
+        printf("\033[92m\nRESULT OF ROWS SWAP:\n\033[0m");
+        sparse_matrix_show_dense(new_matrix);
+        printf("\033[92m----------------------------------------------\n\033[0m");
+    }
 
+    INSTRUMENT_END(INSTRUMENT_OP_SWAP_ROWS);
     return new_matrix;
 }
 
@@ -687,6 +2871,8 @@ Sparse_Matrix *sparse_matrix_swap_rows(Sparse_Matrix *matrix, int rowOne, int ro
  * The new matrix sliced
  */
 Sparse_Matrix *sparse_matrix_slice(Sparse_Matrix *matrix, int rowOne, int columnOne, int rowTwo, int columnTwo){
+    INSTRUMENT_BEGIN();
+
     if(rowOne < 0 || rowOne >= matrix->numberRows || columnOne < 0 || columnOne >= matrix->numberColumns || rowTwo < 0 || rowTwo >= matrix->numberRows || columnTwo < 0 || columnTwo >= matrix->numberColumns){
         printf("\033[91mError: couldn't slice the matrix by these indexes!\n\033[0m");
         exit(1);
@@ -699,6 +2885,7 @@ Sparse_Matrix *sparse_matrix_slice(Sparse_Matrix *matrix, int rowOne, int column
 
     if(rowOne == 0 && columnOne == 0 && rowTwo == matrix->numberRows - 1 && columnTwo == matrix->numberColumns - 1){
         printf("\033[91mError: the slicing isn't necessary\n\033[0m");
+        INSTRUMENT_END(INSTRUMENT_OP_SLICE);
         return matrix;
     }
 
@@ -722,19 +2909,22 @@ Sparse_Matrix *sparse_matrix_slice(Sparse_Matrix *matrix, int rowOne, int column
         }
     }
 
-    printf("\033[92m----------------------------------------------\nMATRIX FOR SLICE - ROW 1: [%d] [%d] AND ROW 2: [%d] [%d]\n\033[0m", rowOne, columnOne, rowTwo, columnTwo);
-    sparse_matrix_show_dense(matrix);
-    printf("\033[92m\nRESULT OF MATRIX SLICE:\n\033[0m");
-    sparse_matrix_show_dense(new_matrix);
-    printf("\033[92m----------------------------------------------\n\033[0m");
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nMATRIX FOR SLICE - ROW 1: [%d] [%d] AND ROW 2: [%d] [%d]\n\033[0m", rowOne, columnOne, rowTwo, columnTwo);
+        sparse_matrix_show_dense(matrix);
+        printf("\033[92m\nRESULT OF MATRIX SLICE:\n\033[0m");
+        sparse_matrix_show_dense(new_matrix);
+        printf("\033[92m----------------------------------------------\n\033[0m");
+    }
 
+    INSTRUMENT_END(INSTRUMENT_OP_SLICE);
     return new_matrix;
 }
 
 /**
- * @brief This function makes the convolution of a matrix from a kernel.
+ * @brief This function makes the convolution of a matrix from a kernel. Each non-null value of the matrix is scattered through the non-null values of the kernel (see sparse_matrix_convolution_bank).
  * 
- * @brief Time Complexity: O(12n^10), because there are 4 loops with size n and that house processes with different time complexities
+ * @brief Time Complexity: O(n*k + r*c), where n and k are the numbers of non-null values of the matrix and of the kernel and r*c is the size of the matrix
  * 
  * @param matrix 
  * The matrix that will be convoluted
@@ -744,52 +2934,246 @@ Sparse_Matrix *sparse_matrix_slice(Sparse_Matrix *matrix, int rowOne, int column
  * The new matrix created
  */
 Sparse_Matrix *sparse_matrix_convolution(Sparse_Matrix *matrix, Sparse_Matrix *kernel){
+    INSTRUMENT_BEGIN();
+
     if(kernel->numberColumns % 2 == 0 && kernel->numberRows % 2 == 0){
         printf("\033[91mError: it's necessary that the kernel has an odd size!\n\033[0m");
         exit(1);
     }
 
-    Sparse_Matrix *result = sparse_matrix_create();
+    //One kernel with stride 1, no dilation and zero padding keeps the size of the matrix
+    Sparse_Matrix *result;
 
-    int half_column = kernel->numberColumns / 2;
-    int half_row = kernel->numberRows / 2;
+    sparse_matrix_convolution_bank(matrix, &kernel, 1, convolution_options_default(), &result);
 
-    for(int i = 0; i < matrix->numberRows; i++){
-        float sum = 0;
+    if(verbose){
+        printf("\033[92m----------------------------------------------\nMATRIX FOR CONVOLUTION:\n\033[0m");
+        sparse_matrix_show_dense(matrix);
+        printf("\033[92m\nKERNEL FOR MATRIX CONVOLUTION:\n\033[0m");
+        sparse_matrix_show_dense(kernel);
+        printf("\033[92m\nRESULT OF MATRIX CONVOLUTION:\n\033[0m");
+        sparse_matrix_show_dense(result);
+        printf("\033[92m----------------------------------------------\n\033[0m");
+    }
 
-        for(int j = 0; j < matrix->numberColumns; j++){
-            Sparse_Matrix *new_matrix = sparse_matrix_create();
+    INSTRUMENT_END(INSTRUMENT_OP_CONVOLUTION);
+    return result;
+}
 
-            for(int h = i - half_row; h <= i + half_row; h++){
-                for(int k = j - half_column; k <= j + half_column; k++){
-                    if (k < 0 || k >= matrix->numberColumns || h < 0 || h >= matrix->numberRows){
-                        sparse_matrix_set_by_index(new_matrix, 0, h + half_row - i, k + half_column - j);
-                    }
+/**
+ * @brief This function checks the list of blocks given to an assembly function.
+ * 
+ * @brief Time Complexity: O(1)
+ */
+static void _sparse_matrix_check_blocks(Sparse_Matrix **matrices, int numberMatrices){
+    if(matrices == NULL || numberMatrices < 1){
+        printf("\033[91mError: there are no matrices to assemble!\n\033[0m");
+        exit(1);
+    }
+}
 
-                    else{
-                        sparse_matrix_set_by_index(new_matrix, sparse_matrix_get_by_index(matrix, h, k), h + half_row - i, k + half_column - j);
-                    }
-                }
+/**
+ * @brief This function puts matrices with the same number of rows side by side. The result is sized from the operands and each row is filled in order with shifted copies of the cells of that row in every block, so each cell is linked at the end of its row and column with no search.
+ * 
+ * @brief Time Complexity: O(r*m + c + n), where r is the number of rows, m is the number of matrices, c is the total number of columns and n is the total number of non-null values
+ * 
+ * @param matrices 
+ * The matrices, from left to right
+ * @param numberMatrices 
+ * The number of matrices
+ * @return Sparse_Matrix* 
+ * The new matrix
+ */
+Sparse_Matrix *sparse_matrix_hstack(Sparse_Matrix **matrices, int numberMatrices){
+    INSTRUMENT_BEGIN();
+
+    _sparse_matrix_check_blocks(matrices, numberMatrices);
+
+    int numberRows = matrices[0]->numberRows;
+    long long numberColumns = 0;
+
+    for(int m = 0; m < numberMatrices; m++){
+        if(matrices[m]->numberRows != numberRows){
+            printf("\033[91mError: the matrices must have the same number of rows!\n\033[0m");
+            exit(1);
+        }
+
+        numberColumns += matrices[m]->numberColumns;
+    }
+
+    if(numberColumns > INT_MAX){
+        printf("\033[91mError: the result is too large!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(numberRows, numberColumns);
+
+    for(int i = 0; i < numberRows; i++){
+        int offset = 0;
+
+        for(int m = 0; m < numberMatrices; m++){
+            for(Cell *current = matrices[m]->rows[i]; current; current = current->nextRow){
+                sparse_matrix_builder_append(builder, current->value, i, current->positionColumn + offset);
+            }
+
+            offset += matrices[m]->numberColumns;
+        }
+    }
+
+    Sparse_Matrix *result = sparse_matrix_builder_finish(builder);
+
+    INSTRUMENT_END(INSTRUMENT_OP_HSTACK);
+    return result;
+}
+
+/**
+ * @brief This function puts matrices with the same number of columns one below the other. The rows of each block are copied in order, shifted by the rows of the blocks above, so each cell is linked at the end of its row and column with no search.
+ * 
+ * @brief Time Complexity: O(r + c + n), where r is the total number of rows, c is the number of columns and n is the total number of non-null values
+ * 
+ * @param matrices 
+ * The matrices, from top to bottom
+ * @param numberMatrices 
+ * The number of matrices
+ * @return Sparse_Matrix* 
+ * The new matrix
+ */
+Sparse_Matrix *sparse_matrix_vstack(Sparse_Matrix **matrices, int numberMatrices){
+    INSTRUMENT_BEGIN();
+
+    _sparse_matrix_check_blocks(matrices, numberMatrices);
+
+    int numberColumns = matrices[0]->numberColumns;
+    long long numberRows = 0;
+
+    for(int m = 0; m < numberMatrices; m++){
+        if(matrices[m]->numberColumns != numberColumns){
+            printf("\033[91mError: the matrices must have the same number of columns!\n\033[0m");
+            exit(1);
+        }
+
+        numberRows += matrices[m]->numberRows;
+    }
+
+    if(numberRows > INT_MAX){
+        printf("\033[91mError: the result is too large!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(numberRows, numberColumns);
+    int offset = 0;
+
+    for(int m = 0; m < numberMatrices; m++){
+        for(int i = 0; i < matrices[m]->numberRows; i++){
+            for(Cell *current = matrices[m]->rows[i]; current; current = current->nextRow){
+                sparse_matrix_builder_append(builder, current->value, i + offset, current->positionColumn);
             }
+        }
+
+        offset += matrices[m]->numberRows;
+    }
+
+    Sparse_Matrix *result = sparse_matrix_builder_finish(builder);
+
+    INSTRUMENT_END(INSTRUMENT_OP_VSTACK);
+    return result;
+}
+
+/**
+ * @brief This function builds the block-diagonal matrix of a list of matrices: each block is copied below and to the right of the previous one, and everything else is null.
+ * 
+ * @brief Time Complexity: O(r + c + n), where r and c are the total numbers of rows and columns and n is the total number of non-null values
+ * 
+ * @param matrices 
+ * The blocks, from the top left to the bottom right
+ * @param numberMatrices 
+ * The number of blocks
+ * @return Sparse_Matrix* 
+ * The new matrix
+ */
+Sparse_Matrix *sparse_matrix_block_diagonal(Sparse_Matrix **matrices, int numberMatrices){
+    INSTRUMENT_BEGIN();
+
+    _sparse_matrix_check_blocks(matrices, numberMatrices);
+
+    long long numberRows = 0, numberColumns = 0;
+
+    for(int m = 0; m < numberMatrices; m++){
+        numberRows += matrices[m]->numberRows;
+        numberColumns += matrices[m]->numberColumns;
+    }
+
+    if(numberRows > INT_MAX || numberColumns > INT_MAX || numberRows < 1 || numberColumns < 1){
+        printf("\033[91mError: the result is too large!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(numberRows, numberColumns);
+    int rowOffset = 0, columnOffset = 0;
+
+    for(int m = 0; m < numberMatrices; m++){
+        for(int i = 0; i < matrices[m]->numberRows; i++){
+            for(Cell *current = matrices[m]->rows[i]; current; current = current->nextRow){
+                sparse_matrix_builder_append(builder, current->value, i + rowOffset, current->positionColumn + columnOffset);
+            }
+        }
+
+        rowOffset += matrices[m]->numberRows;
+        columnOffset += matrices[m]->numberColumns;
+    }
+
+    Sparse_Matrix *result = sparse_matrix_builder_finish(builder);
+
+    INSTRUMENT_END(INSTRUMENT_OP_BLOCK_DIAGONAL);
+    return result;
+}
+
+/**
+ * @brief This function makes the Kronecker product of two matrices: the block (i, j) of the result is matrix2 times the value (i, j) of matrix1. Row i1 * r2 + i2 of the result is filled by walking row i1 of matrix1 and, for each of its values, row i2 of matrix2, which already gives the columns in increasing order.
+ * 
+ * @brief Time Complexity: O(r1*r2 + c1*c2 + n1*n2), where r, c and n are the numbers of rows, columns and non-null values of each matrix
+ * 
+ * @param matrix1 
+ * The left matrix
+ * @param matrix2 
+ * The right matrix
+ * @return Sparse_Matrix* 
+ * The new matrix, with r1*r2 rows and c1*c2 columns
+ */
+Sparse_Matrix *sparse_matrix_kronecker(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2){
+    INSTRUMENT_BEGIN();
+
+    long long numberRows = (long long)matrix1->numberRows * matrix2->numberRows;
+    long long numberColumns = (long long)matrix1->numberColumns * matrix2->numberColumns;
+
+    if(numberRows > INT_MAX || numberColumns > INT_MAX){
+        printf("\033[91mError: the result is too large!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(numberRows, numberColumns);
+
+    for(int i1 = 0; i1 < matrix1->numberRows; i1++){
+        if(matrix1->rows[i1] == NULL){
+            continue;
+        }
+
+        for(int i2 = 0; i2 < matrix2->numberRows; i2++){
+            int row = i1 * matrix2->numberRows + i2;
 
-            Sparse_Matrix *mult = sparse_matrix_multiply_point(kernel, new_matrix);
-            
-            sum = _sparse_matrix_sum_cells(mult);
-            sparse_matrix_set_by_index(result, sum, i, j);
+            for(Cell *current1 = matrix1->rows[i1]; current1; current1 = current1->nextRow){
+                int offset = current1->positionColumn * matrix2->numberColumns;
 
-            sparse_matrix_destroy(mult);
-            sparse_matrix_destroy(new_matrix);
+                for(Cell *current2 = matrix2->rows[i2]; current2; current2 = current2->nextRow){
+                    sparse_matrix_builder_append(builder, current1->value * current2->value, row, offset + current2->positionColumn);
+                }
+            }
         }
     }
 
-    printf("\033[92m----------------------------------------------\nMATRIX FOR CONVOLUTION:\n\033[0m");
-    sparse_matrix_show_dense(matrix);
-    printf("\033[92m\nKERNEL FOR MATRIX CONVOLUTION:\n\033[0m");
-    sparse_matrix_show_dense(kernel);
-    printf("\033[92m\nRESULT OF MATRIX CONVOLUTION:\n\033[0m");
-    sparse_matrix_show_dense(result);
-    printf("\033[92m----------------------------------------------\n\033[0m");  
+    Sparse_Matrix *result = sparse_matrix_builder_finish(builder);
 
+    INSTRUMENT_END(INSTRUMENT_OP_KRONECKER);
     return result;
 }
 
@@ -819,13 +3203,14 @@ void sparse_matrix_show(Sparse_Matrix *matrix){
 /**
  * @brief This function shows the entire matrix, including the null values (dense matrix).
  * 
- * @brief Time Complexity: O(2n^3), because this function loops through a list of size n, n times. And each repetition takes 2 n processes to work
+ * @brief Time Complexity: O(r*c), because each position is printed once and the non-null values are read with a row cursor
  * 
  * @param matrix 
  * The matrix that will be displayed
  */
 void sparse_matrix_show_dense(Sparse_Matrix *matrix){
-    Cell *aux;
+    Sparse_Matrix_Cursor cursor;
+    int hasNext;
 
     printf("\033[92mSHOW DENSE MATRIX:\nROWS: %d COLUMNS: %d\n\n\033[0m\t", matrix->numberRows, matrix->numberColumns);
 
@@ -836,15 +3221,19 @@ void sparse_matrix_show_dense(Sparse_Matrix *matrix){
 
     for(int i = 0; i < matrix->numberRows; i++){
         printf("\033[95m[%d]\t\033[0m", i);
-        for(int j = 0; j < matrix->numberColumns; j++){
-            aux = sparse_matrix_index_exists(matrix, i, j);
 
-            if(aux == NULL){
+        //The row is sorted, so the cursor only moves when its column is printed
+        cursor = sparse_matrix_row_cursor(matrix, i);
+        hasNext = sparse_matrix_cursor_next(&cursor);
+
+        for(int j = 0; j < matrix->numberColumns; j++){
+            if(!hasNext || cursor.column != j){
                 printf("0.00\t");
             }
 
             else{
-                printf("\033[94m%.2f\033[0m\t", sparse_matrix_get_by_index(matrix, i, j));
+                printf("\033[94m%.2f\033[0m\t", cursor.value);
+                hasNext = sparse_matrix_cursor_next(&cursor);
             }
         }
 
@@ -861,6 +3250,8 @@ void sparse_matrix_show_dense(Sparse_Matrix *matrix){
  * The matrix that will be saved in the file
  */
 void sparse_matrix_binary_save(Sparse_Matrix *matrix){
+    INSTRUMENT_BEGIN();
+
     FILE *fp = fopen("./matrix.bin", "wb");
 
     if(!fp){
@@ -868,7 +3259,7 @@ void sparse_matrix_binary_save(Sparse_Matrix *matrix){
         exit(1);
     }
 
-    fwrite(&matrix->numberNonNullValues, 1, sizeof(int), fp);
+    size_t bytes = fwrite(&matrix->numberNonNullValues, 1, sizeof(int), fp);
 
     Cell *current;
 
@@ -876,18 +3267,22 @@ void sparse_matrix_binary_save(Sparse_Matrix *matrix){
         current = matrix->rows[i];
 
         while(current != NULL){
-            fwrite(&current->positionRow, 1, sizeof(int), fp);
-            fwrite(&current->positionColumn, 1, sizeof(int), fp);
-            fwrite(&current->value, 1, sizeof(float), fp);
+            bytes += fwrite(&current->positionRow, 1, sizeof(int), fp);
+            bytes += fwrite(&current->positionColumn, 1, sizeof(int), fp);
+            bytes += fwrite(&current->value, 1, sizeof(float), fp);
             current = current->nextRow;
         }
     }
 
     fclose(fp);
+
+    INSTRUMENT_COUNT(INSTRUMENT_BYTES_WRITTEN, bytes);
+
+    INSTRUMENT_END(INSTRUMENT_OP_BINARY_SAVE);
 }
 
 /**
- * @brief This function creates a sparse matrix with the informations obtained from a binary file.
+ * @brief This function creates a sparse matrix with the informations obtained from a binary file. Files in the compressed format are recognized by their first int and read by sparse_matrix_compressed_read.
  * 
  * @brief Time Complexity: O(2n^2) or O(3n^2), because this function calls a function of complexity O(2n) or O(3n), n times 
  * 
@@ -897,6 +3292,8 @@ void sparse_matrix_binary_save(Sparse_Matrix *matrix){
  * The new matrix created
  */
 Sparse_Matrix *sparse_matrix_binary_read(char *path_to_file){
+    INSTRUMENT_BEGIN();
+
     FILE *fp = fopen(path_to_file, "rb");
 
     if(!fp){
@@ -906,19 +3303,31 @@ Sparse_Matrix *sparse_matrix_binary_read(char *path_to_file){
 
     int numberNonNullValues, column, row;
     float value;
-    Sparse_Matrix *matrix = sparse_matrix_create();
 
-    fread(&numberNonNullValues, 1, sizeof(int), fp);
+    size_t bytes = fread(&numberNonNullValues, 1, sizeof(int), fp);
+
+    //Files saved by sparse_matrix_compressed_save start with a negative marker
+    if(bytes == sizeof(int) && numberNonNullValues == COMPRESSED_MAGIC){
+        fclose(fp);
+
+        INSTRUMENT_END(INSTRUMENT_OP_BINARY_READ);
+        return sparse_matrix_compressed_read(path_to_file);
+    }
+
+    Sparse_Matrix *matrix = sparse_matrix_create();
 
     for(int i = 0; i < numberNonNullValues; i++){
-        fread(&row, 1, sizeof(int), fp);
-        fread(&column, 1, sizeof(int), fp);
-        fread(&value, 1, sizeof(float), fp);
+        bytes += fread(&row, 1, sizeof(int), fp);
+        bytes += fread(&column, 1, sizeof(int), fp);
+        bytes += fread(&value, 1, sizeof(float), fp);
 
         sparse_matrix_set_by_index(matrix, value, row, column);
     }
 
     fclose(fp);
 
+    INSTRUMENT_COUNT(INSTRUMENT_BYTES_READ, bytes);
+
+    INSTRUMENT_END(INSTRUMENT_OP_BINARY_READ);
     return matrix;
-}
\ No newline at end of file
+}
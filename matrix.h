@@ -1,13 +1,47 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+//Bytes the allocator adds to each cell allocated alone (used by sparse_matrix_compact to report the memory reclaimed)
+#define MATRIX_CELL_HEAP_OVERHEAD 16
+//Number of locks over the rows and over the columns in concurrent mode (row i uses the lock i % MATRIX_LOCK_STRIPES)
+#define MATRIX_LOCK_STRIPES 256
+
 typedef struct Sparse_Matrix Sparse_Matrix;
+typedef struct Sparse_Matrix_Builder Sparse_Matrix_Builder;
 typedef float matrix_value_type;
 
+typedef struct Sparse_Matrix_Cursor{
+    void *cell;
+    int byColumn;
+    int row, column;
+    matrix_value_type value;
+} Sparse_Matrix_Cursor;
+
 //Allocation functions
 
 Sparse_Matrix *sparse_matrix_create();
 void sparse_matrix_destroy();
+Sparse_Matrix *_sparse_matrix_adopt(int numberRows, int numberColumns, int numberNonNull, void **rows, void **columns);
+Sparse_Matrix *sparse_matrix_clone(Sparse_Matrix *matrix);
+void _sparse_matrix_private_row(Sparse_Matrix *matrix, int row);
+void _sparse_matrix_attach_columns(Sparse_Matrix *matrix);
+int sparse_matrix_shared_rows(Sparse_Matrix *matrix);
+long long sparse_matrix_compact(Sparse_Matrix *matrix);
+
+//Dimension functions
+
+int sparse_matrix_number_rows(Sparse_Matrix *matrix);
+int sparse_matrix_number_columns(Sparse_Matrix *matrix);
+void *_sparse_matrix_row_head(Sparse_Matrix *matrix, int row);
+void *_sparse_matrix_column_head(Sparse_Matrix *matrix, int column);
+unsigned long sparse_matrix_version(Sparse_Matrix *matrix);
+
+//Iteration functions
+
+Sparse_Matrix_Cursor sparse_matrix_row_cursor(Sparse_Matrix *matrix, int row);
+Sparse_Matrix_Cursor sparse_matrix_column_cursor(Sparse_Matrix *matrix, int column);
+int sparse_matrix_cursor_next(Sparse_Matrix_Cursor *cursor);
+int sparse_matrix_number_non_null(Sparse_Matrix *matrix);
 
 //Verification functions
 
@@ -20,17 +54,52 @@ void _sparse_matrix_push_column(Sparse_Matrix *matrix, void *cell, int column);
 void _sparse_matrix_realloc(Sparse_Matrix *matrix, int row, int column);
 void _sparse_matrix_destroy_cell(Sparse_Matrix *matrix, int row, int column);
 void sparse_matrix_set_by_index(Sparse_Matrix *matrix, matrix_value_type data, int row, int column);
+void _sparse_matrix_merge_sorted(Sparse_Matrix *matrix, const int *rows, const int *columns, const matrix_value_type *values, int count);
+
+//Pruning functions
+
+int sparse_matrix_prune(Sparse_Matrix *matrix, matrix_value_type tolerance);
+int sparse_matrix_prune_top_k(Sparse_Matrix *matrix, int k);
+
+//Concurrency functions
+
+void sparse_matrix_concurrent_begin(Sparse_Matrix *matrix, int numberRows, int numberColumns);
+void sparse_matrix_concurrent_end(Sparse_Matrix *matrix);
+
+//Builder functions
+
+Sparse_Matrix_Builder *sparse_matrix_builder_create(int numberRows, int numberColumns);
+void sparse_matrix_builder_append(Sparse_Matrix_Builder *builder, matrix_value_type data, int row, int column);
+Sparse_Matrix *sparse_matrix_builder_finish(Sparse_Matrix_Builder *builder);
 
 //Getters functions
 
 matrix_value_type sparse_matrix_get_by_index(Sparse_Matrix *matrix, int row, int column);
 matrix_value_type _sparse_matrix_sum_cells(Sparse_Matrix *matrix);
 
+//Reduction functions
+
+matrix_value_type sparse_matrix_sum_values(Sparse_Matrix *matrix);
+void sparse_matrix_row_sums(Sparse_Matrix *matrix, matrix_value_type *result);
+void sparse_matrix_column_sums(Sparse_Matrix *matrix, matrix_value_type *result);
+void sparse_matrix_row_non_null(Sparse_Matrix *matrix, int *result);
+matrix_value_type sparse_matrix_min(Sparse_Matrix *matrix);
+matrix_value_type sparse_matrix_max(Sparse_Matrix *matrix);
+matrix_value_type sparse_matrix_norm_frobenius(Sparse_Matrix *matrix);
+matrix_value_type sparse_matrix_norm_one(Sparse_Matrix *matrix);
+matrix_value_type sparse_matrix_norm_infinity(Sparse_Matrix *matrix);
+matrix_value_type sparse_matrix_trace(Sparse_Matrix *matrix);
+
 //Operation functions with matrices
 
+void sparse_matrix_multiply_vector(Sparse_Matrix *matrix, const matrix_value_type *vector, matrix_value_type *result);
 Sparse_Matrix *sparse_matrix_multiply_scalar(Sparse_Matrix *matrix, matrix_value_type scalar);
 Sparse_Matrix *sparse_matrix_sum(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2);
+Sparse_Matrix *sparse_matrix_axpby(matrix_value_type alpha, Sparse_Matrix *matrix1, matrix_value_type beta, Sparse_Matrix *matrix2);
+void sparse_matrix_axpy(Sparse_Matrix *matrix1, matrix_value_type alpha, Sparse_Matrix *matrix2);
 Sparse_Matrix *sparse_matrix_multiplication(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2);
+Sparse_Matrix *sparse_matrix_multiplication_pruned(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, matrix_value_type tolerance);
+Sparse_Matrix *sparse_matrix_multiplication_masked(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, Sparse_Matrix *mask, int complement);
 Sparse_Matrix *sparse_matrix_multiply_point(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2);
 Sparse_Matrix *sparse_matrix_transpose(Sparse_Matrix *matrix);
 Sparse_Matrix *sparse_matrix_swap_columns(Sparse_Matrix *matrix, int columnOne, int columnTwo);
@@ -38,8 +107,16 @@ Sparse_Matrix *sparse_matrix_swap_rows(Sparse_Matrix *matrix, int rowOne, int ro
 Sparse_Matrix *sparse_matrix_slice(Sparse_Matrix *matrix, int rowOne, int columnOne, int rowTwo, int columnTwo);
 Sparse_Matrix *sparse_matrix_convolution(Sparse_Matrix *matrix, Sparse_Matrix *kernel);
 
+//Assembly functions
+
+Sparse_Matrix *sparse_matrix_hstack(Sparse_Matrix **matrices, int numberMatrices);
+Sparse_Matrix *sparse_matrix_vstack(Sparse_Matrix **matrices, int numberMatrices);
+Sparse_Matrix *sparse_matrix_block_diagonal(Sparse_Matrix **matrices, int numberMatrices);
+Sparse_Matrix *sparse_matrix_kronecker(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2);
+
 //Print functions
 
+void sparse_matrix_set_verbose(int enabled);
 void sparse_matrix_show(Sparse_Matrix *matrix);
 void sparse_matrix_show_dense(Sparse_Matrix *matrix);
 
@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "cell.h"
+#include "semiring.h"
+#include "instrument.h"
+
+//The operations of each semiring; the absent values of a sparse matrix are the identity of the addition
+#define SEMIRING_PLUS(a, b) ((a) + (b))
+#define SEMIRING_TIMES(a, b) ((a) * (b))
+#define SEMIRING_MIN(a, b) ((b) < (a) ? (b) : (a))
+#define SEMIRING_MAX(a, b) ((b) > (a) ? (b) : (a))
+#define SEMIRING_OR(a, b) ((matrix_value_type)((a) != 0 || (b) != 0))
+#define SEMIRING_AND(a, b) ((matrix_value_type)((a) != 0 && (b) != 0))
+
+/**
+ * @brief This function compares two integers, to sort the columns of a row.
+ *
+ * @brief Time Complexity: O(1), because only two values are compared
+ */
+static int _semiring_compare_columns(const void *a, const void *b){
+    return *(const int *)a - *(const int *)b;
+}
+
+/**
+ * @brief This function allocates the scratch of the row kernels for a product with a number of columns.
+ *
+ * @brief Time Complexity: O(c), because each marker is reset once
+ *
+ * @param workspace
+ * The workspace that will be filled
+ * @param numberColumns
+ * The number of columns of the product
+ * @param tolerance
+ * The values of the product whose magnitude is below it are dropped (0 keeps them all)
+ */
+void _semiring_workspace_create(Semiring_Workspace *workspace, int numberColumns, matrix_value_type tolerance){
+    workspace->numberColumns = numberColumns;
+    workspace->tolerance = tolerance;
+    workspace->accumulator = (matrix_value_type *)malloc(numberColumns * sizeof(matrix_value_type));
+    workspace->marker = (int *)malloc(numberColumns * sizeof(int));
+    workspace->touched = (int *)malloc(numberColumns * sizeof(int));
+
+    for(int j = 0; j < numberColumns; j++){
+        workspace->marker[j] = -1;
+    }
+}
+
+/**
+ * @brief This function frees the scratch of the row kernels.
+ *
+ * @brief Time Complexity: O(1)
+ *
+ * @param workspace
+ * The workspace that will be freed
+ */
+void _semiring_workspace_destroy(Semiring_Workspace *workspace){
+    free(workspace->accumulator);
+    free(workspace->marker);
+    free(workspace->touched);
+}
+
+/**
+ * @brief This function hands the row accumulated by a kernel to the sink, in increasing order of columns and without the values below the tolerance: the touched columns are sorted, or the marker is scanned when most columns were touched.
+ *
+ * @brief Time Complexity: O(t*log(t)) or O(c), where t is the number of columns touched and c is the number of columns
+ */
+static void _semiring_flush_row(Semiring_Workspace *workspace, int row, int numberTouched, Semiring_Row_Sink emit, void *sink){
+    if((long long)numberTouched * 8 > workspace->numberColumns){
+        for(int j = 0; j < workspace->numberColumns; j++){
+            if(workspace->marker[j] == row && fabsf(workspace->accumulator[j]) >= workspace->tolerance){
+                emit(sink, row, j, workspace->accumulator[j]);
+            }
+        }
+
+        return;
+    }
+
+    qsort(workspace->touched, numberTouched, sizeof(int), _semiring_compare_columns);
+
+    for(int t = 0; t < numberTouched; t++){
+        int j = workspace->touched[t];
+
+        if(fabsf(workspace->accumulator[j]) >= workspace->tolerance){
+            emit(sink, row, j, workspace->accumulator[j]);
+        }
+    }
+}
+
+/**
+ * @brief This macro defines the kernel of a semiring: Gustavson's algorithm, where the row i of the product accumulates, for each value a(i, k), the row k of matrix2 combined with a(i, k). The operations are expanded in the loop, so each semiring is compiled into its own kernel with no call per operation.
+ *
+ * @brief Time Complexity: O(f + r*log(c)), where f is the number of pairs of non-null values combined
+ */
+#define SEMIRING_KERNEL(name, ADD, MULTIPLY) \
+static void _semiring_multiply_##name(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, int firstRow, int lastRow, Semiring_Workspace *workspace, Semiring_Row_Sink emit, void *sink){ \
+    for(int i = firstRow; i < lastRow; i++){ \
+        int numberTouched = 0; \
+\
+        for(Cell *first = _sparse_matrix_row_head(matrix1, i); first; first = first->nextRow){ \
+            matrix_value_type a = first->value; \
+\
+            for(Cell *second = _sparse_matrix_row_head(matrix2, first->positionColumn); second; second = second->nextRow){ \
+                int j = second->positionColumn; \
+                matrix_value_type product = MULTIPLY(a, second->value); \
+\
+                if(workspace->marker[j] != i){ \
+                    workspace->marker[j] = i; \
+                    workspace->accumulator[j] = product; \
+                    workspace->touched[numberTouched++] = j; \
+                } \
+\
+                else{ \
+                    workspace->accumulator[j] = ADD(workspace->accumulator[j], product); \
+                } \
+            } \
+        } \
+\
+        _semiring_flush_row(workspace, i, numberTouched, emit, sink); \
+    } \
+}
+
+SEMIRING_KERNEL(plus_times, SEMIRING_PLUS, SEMIRING_TIMES)
+SEMIRING_KERNEL(min_plus, SEMIRING_MIN, SEMIRING_PLUS)
+SEMIRING_KERNEL(or_and, SEMIRING_OR, SEMIRING_AND)
+SEMIRING_KERNEL(max_min, SEMIRING_MAX, SEMIRING_MIN)
+
+/**
+ * @brief This function computes a range of rows of the product over a semiring with the kernel of the semiring, handing each finished row to a sink (the builder of a matrix, or the buffer of a tile). The workspace must have been created for the columns of matrix2, and its markers must not have seen the rows of the range.
+ *
+ * @brief Time Complexity: O(f + r*log(c)), where f is the number of pairs of non-null values combined and r is the number of rows of the range
+ *
+ * @param matrix1
+ * The first matrix to multiply
+ * @param matrix2
+ * The second matrix to multiply
+ * @param semiring
+ * The addition and multiplication used
+ * @param firstRow
+ * The first row computed
+ * @param lastRow
+ * The row after the last one computed
+ * @param workspace
+ * The scratch of the kernel
+ * @param emit
+ * The function that receives each value of the product
+ * @param sink
+ * The first argument of emit
+ */
+void _semiring_multiply_rows(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, Sparse_Semiring semiring, int firstRow, int lastRow, Semiring_Workspace *workspace, Semiring_Row_Sink emit, void *sink){
+    switch(semiring){
+        case SEMIRING_PLUS_TIMES:
+            _semiring_multiply_plus_times(matrix1, matrix2, firstRow, lastRow, workspace, emit, sink);
+            break;
+
+        case SEMIRING_MIN_PLUS:
+            _semiring_multiply_min_plus(matrix1, matrix2, firstRow, lastRow, workspace, emit, sink);
+            break;
+
+        case SEMIRING_OR_AND:
+            _semiring_multiply_or_and(matrix1, matrix2, firstRow, lastRow, workspace, emit, sink);
+            break;
+
+        case SEMIRING_MAX_MIN:
+            _semiring_multiply_max_min(matrix1, matrix2, firstRow, lastRow, workspace, emit, sink);
+            break;
+
+        default:
+            printf("\033[91mError: unknown semiring!\n\033[0m");
+            exit(1);
+    }
+}
+
+/**
+ * @brief This function is the sink that appends the values of the product to a builder.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static void _semiring_builder_sink(void *builder, int row, int column, matrix_value_type value){
+    sparse_matrix_builder_append((Sparse_Matrix_Builder *)builder, value, row, column);
+}
+
+/**
+ * @brief This function multiplies two matrices over a semiring into a new matrix, dropping the values below a tolerance. It's the product behind sparse_matrix_multiplication_semiring, sparse_matrix_multiplication and sparse_matrix_multiplication_pruned; nothing is printed or recorded.
+ *
+ * @brief Time Complexity: O(f + r*log(c) + c), where f is the number of pairs of non-null values combined, r is the number of rows of matrix1 and c is the number of columns of matrix2
+ *
+ * @param matrix1
+ * The first matrix to multiply
+ * @param matrix2
+ * The second matrix to multiply
+ * @param semiring
+ * The addition and multiplication used
+ * @param tolerance
+ * The values whose magnitude is below it are dropped (0 keeps every non-null value)
+ * @return Sparse_Matrix*
+ * The new matrix with the product
+ */
+Sparse_Matrix *_semiring_multiplication(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, Sparse_Semiring semiring, matrix_value_type tolerance){
+    if(sparse_matrix_number_columns(matrix1) != sparse_matrix_number_rows(matrix2)){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    int numberRows = sparse_matrix_number_rows(matrix1);
+    int numberColumns = sparse_matrix_number_columns(matrix2);
+
+    //The builder needs at least one row and one column
+    if(numberRows == 0 || numberColumns == 0){
+        return sparse_matrix_create();
+    }
+
+    Semiring_Workspace workspace;
+    Sparse_Matrix_Builder *builder = sparse_matrix_builder_create(numberRows, numberColumns);
+
+    _semiring_workspace_create(&workspace, numberColumns, tolerance);
+    _semiring_multiply_rows(matrix1, matrix2, semiring, 0, numberRows, &workspace, _semiring_builder_sink, builder);
+    _semiring_workspace_destroy(&workspace);
+
+    return sparse_matrix_builder_finish(builder);
+}
+
+/**
+ * @brief This function multiplies two matrices over a semiring: (+, *) for the usual product, (min, +) for shortest paths, (or, and) for reachability and (max, min) for widest paths. The absent values are the identity of the addition of the semiring (0, infinity, false and minus infinity), so only the pairs of non-null values are combined. The matrix can't store a 0, so a result equal to 0 is left out (in min-plus, a path of length 0 between two different vertices is lost, and the diagonal of a distance matrix is implicit). Nothing is printed.
+ *
+ * @brief Time Complexity: O(f + r*log(c) + c), where f is the number of pairs of non-null values combined, r is the number of rows of matrix1 and c is the number of columns of matrix2
+ *
+ * @param matrix1
+ * The first matrix to multiply
+ * @param matrix2
+ * The second matrix to multiply
+ * @param semiring
+ * The addition and multiplication used
+ * @return Sparse_Matrix*
+ * The new matrix with the product
+ */
+Sparse_Matrix *sparse_matrix_multiplication_semiring(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, Sparse_Semiring semiring){
+    INSTRUMENT_BEGIN();
+
+    Sparse_Matrix *result = _semiring_multiplication(matrix1, matrix2, semiring, 0);
+
+    INSTRUMENT_END(INSTRUMENT_OP_MULTIPLICATION_SEMIRING);
+    return result;
+}
@@ -0,0 +1,36 @@
+#ifndef SEMIRING_H
+#define SEMIRING_H
+
+#include "matrix.h"
+
+typedef enum{
+    SEMIRING_PLUS_TIMES,
+    SEMIRING_MIN_PLUS,
+    SEMIRING_OR_AND,
+    SEMIRING_MAX_MIN
+} Sparse_Semiring;
+
+//Scratch of the row kernels: one accumulator, marker and list of touched positions per column of the product
+typedef struct Semiring_Workspace{
+    matrix_value_type *accumulator;
+    int *marker;
+    int *touched;
+    int numberColumns;
+    matrix_value_type tolerance;
+} Semiring_Workspace;
+
+//Receives each value of a finished row of the product, in increasing order of columns
+typedef void (*Semiring_Row_Sink)(void *sink, int row, int column, matrix_value_type value);
+
+//Kernel functions
+
+void _semiring_workspace_create(Semiring_Workspace *workspace, int numberColumns, matrix_value_type tolerance);
+void _semiring_workspace_destroy(Semiring_Workspace *workspace);
+void _semiring_multiply_rows(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, Sparse_Semiring semiring, int firstRow, int lastRow, Semiring_Workspace *workspace, Semiring_Row_Sink emit, void *sink);
+Sparse_Matrix *_semiring_multiplication(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, Sparse_Semiring semiring, matrix_value_type tolerance);
+
+//Operation functions with matrices
+
+Sparse_Matrix *sparse_matrix_multiplication_semiring(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, Sparse_Semiring semiring);
+
+#endif
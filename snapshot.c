@@ -0,0 +1,526 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "snapshot.h"
+
+typedef struct Snapshot_Row{
+    int references;
+    int length;
+    int *columns;
+    matrix_value_type *values;
+} Snapshot_Row;
+
+typedef struct Sparse_Matrix_Snapshot{
+    unsigned long version;
+    int numberRows, numberColumns, numberNonNull;
+    Snapshot_Row **rows;
+    unsigned long retireEpoch;
+    struct Sparse_Matrix_Snapshot *nextRetired;
+} Sparse_Matrix_Snapshot;
+
+typedef struct Sparse_Matrix_Reader{
+    Sparse_Matrix_Publisher *publisher;
+    int used;
+    unsigned long epoch;
+} Sparse_Matrix_Reader;
+
+typedef struct Sparse_Matrix_Publisher{
+    Sparse_Matrix *matrix;
+    unsigned long matrixVersion;
+    Sparse_Matrix_Snapshot *current;
+    Sparse_Matrix_Snapshot *retired;
+    int numberRetired;
+    unsigned long epoch;
+    unsigned long version;
+    char *dirty;
+    int dirtySize;
+    Sparse_Matrix_Reader readers[SNAPSHOT_MAX_READERS];
+} Sparse_Matrix_Publisher;
+
+/**
+ * @brief This function copies a row of the matrix into an immutable row of a snapshot, in a unique block.
+ *
+ * @brief Time Complexity: O(k), where k is the number of values of the row
+ *
+ * @param matrix
+ * The matrix
+ * @param row
+ * The row that will be copied
+ * @return Snapshot_Row*
+ * The new row with one reference (NULL if the row is empty)
+ */
+static Snapshot_Row *_snapshot_row_create(Sparse_Matrix *matrix, int row){
+    Sparse_Matrix_Cursor cursor = sparse_matrix_row_cursor(matrix, row);
+    int length = 0;
+
+    while(sparse_matrix_cursor_next(&cursor)){
+        length++;
+    }
+
+    if(length == 0){
+        return NULL;
+    }
+
+    Snapshot_Row *copy = (Snapshot_Row *)malloc(sizeof(Snapshot_Row) + length * (sizeof(int) + sizeof(matrix_value_type)));
+
+    copy->references = 1;
+    copy->length = 0;
+    copy->columns = (int *)(copy + 1);
+    copy->values = (matrix_value_type *)(copy->columns + length);
+
+    cursor = sparse_matrix_row_cursor(matrix, row);
+
+    while(sparse_matrix_cursor_next(&cursor)){
+        copy->columns[copy->length] = cursor.column;
+        copy->values[copy->length] = cursor.value;
+        copy->length++;
+    }
+
+    return copy;
+}
+
+/**
+ * @brief This function drops the reference of a snapshot to each of its rows, freeing the rows no other snapshot shares, and frees the snapshot.
+ *
+ * @brief Time Complexity: O(r), because each row is released once
+ *
+ * @param snapshot
+ * The snapshot that will be deallocated
+ */
+static void _snapshot_destroy(Sparse_Matrix_Snapshot *snapshot){
+    for(int i = 0; i < snapshot->numberRows; i++){
+        if(snapshot->rows[i] && --snapshot->rows[i]->references == 0){
+            free(snapshot->rows[i]);
+        }
+    }
+
+    free(snapshot->rows);
+    free(snapshot);
+}
+
+/**
+ * @brief This function marks a row as changed since the last publication, growing the marks when the row is new.
+ *
+ * @brief Time Complexity: O(1) amortized, because the marks grow at least twice
+ */
+static void _sparse_matrix_publisher_mark(Sparse_Matrix_Publisher *publisher, int row){
+    if(row >= publisher->dirtySize){
+        int size = 2 * publisher->dirtySize > row + 1 ? 2 * publisher->dirtySize : row + 1;
+
+        publisher->dirty = (char *)realloc(publisher->dirty, size);
+
+        for(int i = publisher->dirtySize; i < size; i++){
+            publisher->dirty[i] = 0;
+        }
+
+        publisher->dirtySize = size;
+    }
+
+    publisher->dirty[row] = 1;
+}
+
+/**
+ * @brief This function creates a publisher for a matrix and publishes its first snapshot. The thread that owns the publisher is the only writer: it changes the matrix and publishes new versions, while the readers see immutable snapshots with no locks.
+ *
+ * @brief Time Complexity: O(n + r), because every row is copied into the first snapshot
+ *
+ * @param matrix
+ * The matrix that will be published (it isn't copied, so it must live longer than the publisher)
+ * @return Sparse_Matrix_Publisher*
+ * The new publisher
+ */
+Sparse_Matrix_Publisher *sparse_matrix_publisher_create(Sparse_Matrix *matrix){
+    Sparse_Matrix_Publisher *publisher = (Sparse_Matrix_Publisher *)calloc(1, sizeof(Sparse_Matrix_Publisher));
+
+    publisher->matrix = matrix;
+    publisher->epoch = 1;
+
+    for(int i = 0; i < SNAPSHOT_MAX_READERS; i++){
+        publisher->readers[i].publisher = publisher;
+    }
+
+    sparse_matrix_publisher_publish(publisher);
+
+    return publisher;
+}
+
+/**
+ * @brief This function frees the memory allocated for a publisher and all its snapshots. No reader may be using it. The matrix isn't destroyed.
+ *
+ * @brief Time Complexity: O(s*r), where s is the number of snapshots still allocated
+ *
+ * @param publisher
+ * The publisher that will be deallocated
+ */
+void sparse_matrix_publisher_destroy(Sparse_Matrix_Publisher *publisher){
+    Sparse_Matrix_Snapshot *snapshot = publisher->retired;
+
+    while(snapshot){
+        Sparse_Matrix_Snapshot *next = snapshot->nextRetired;
+
+        _snapshot_destroy(snapshot);
+        snapshot = next;
+    }
+
+    _snapshot_destroy(publisher->current);
+    free(publisher->dirty);
+    free(publisher);
+}
+
+/**
+ * @brief This function puts a value in the matrix and marks its row, so the next publication copies only the rows that changed. The readers don't see the change until it's published.
+ *
+ * @brief Time Complexity: the cost of sparse_matrix_set_by_index
+ *
+ * @param publisher
+ * The publisher of the matrix
+ * @param data
+ * The value that will be defined
+ * @param row
+ * The row wanted
+ * @param column
+ * The column wanted
+ */
+void sparse_matrix_publisher_set(Sparse_Matrix_Publisher *publisher, matrix_value_type data, int row, int column){
+    int tracked = publisher->matrixVersion == sparse_matrix_version(publisher->matrix);
+
+    sparse_matrix_set_by_index(publisher->matrix, data, row, column);
+    _sparse_matrix_publisher_mark(publisher, row);
+
+    //The change is known, so the matrix is still in step with the marks
+    if(tracked){
+        publisher->matrixVersion = sparse_matrix_version(publisher->matrix);
+    }
+}
+
+/**
+ * @brief This function publishes the current state of the matrix as a new snapshot. The rows that didn't change are shared with the previous snapshot; only the rows changed through the publisher are copied (all of them if the matrix was changed in another way). The new snapshot replaces the old one atomically, and the old one is retired until no reader can still see it.
+ *
+ * @brief Time Complexity: O(r + k), where k is the number of values of the rows copied
+ *
+ * @param publisher
+ * The publisher of the matrix
+ * @return unsigned long
+ * The version of the new snapshot
+ */
+unsigned long sparse_matrix_publisher_publish(Sparse_Matrix_Publisher *publisher){
+    Sparse_Matrix *matrix = publisher->matrix;
+    Sparse_Matrix_Snapshot *previous = publisher->current;
+    Sparse_Matrix_Snapshot *snapshot = (Sparse_Matrix_Snapshot *)calloc(1, sizeof(Sparse_Matrix_Snapshot));
+    int tracked = previous && publisher->matrixVersion == sparse_matrix_version(matrix);
+
+    snapshot->version = ++publisher->version;
+    snapshot->numberRows = sparse_matrix_number_rows(matrix);
+    snapshot->numberColumns = sparse_matrix_number_columns(matrix);
+    snapshot->numberNonNull = sparse_matrix_number_non_null(matrix);
+    snapshot->rows = (Snapshot_Row **)malloc((snapshot->numberRows + 1) * sizeof(Snapshot_Row *));
+
+    for(int i = 0; i < snapshot->numberRows; i++){
+        if(tracked && i < previous->numberRows && (i >= publisher->dirtySize || !publisher->dirty[i])){
+            snapshot->rows[i] = previous->rows[i];
+
+            if(snapshot->rows[i]){
+                snapshot->rows[i]->references++;
+            }
+        }
+
+        else{
+            snapshot->rows[i] = _snapshot_row_create(matrix, i);
+        }
+    }
+
+    for(int i = 0; i < publisher->dirtySize; i++){
+        publisher->dirty[i] = 0;
+    }
+
+    publisher->matrixVersion = sparse_matrix_version(matrix);
+
+    //Readers that pin from now on see the new snapshot; the old one waits for the readers of this epoch
+    __atomic_store_n(&publisher->current, snapshot, __ATOMIC_SEQ_CST);
+
+    if(previous){
+        previous->retireEpoch = __atomic_load_n(&publisher->epoch, __ATOMIC_SEQ_CST);
+        previous->nextRetired = publisher->retired;
+        publisher->retired = previous;
+        publisher->numberRetired++;
+    }
+
+    __atomic_add_fetch(&publisher->epoch, 1, __ATOMIC_SEQ_CST);
+
+    sparse_matrix_publisher_reclaim(publisher);
+
+    return snapshot->version;
+}
+
+/**
+ * @brief This function frees the retired snapshots that no reader can still see: a snapshot retired in epoch e is freed once every pinned reader pinned after e. It's called by each publication.
+ *
+ * @brief Time Complexity: O(t + s*r), where t is SNAPSHOT_MAX_READERS and s is the number of snapshots freed
+ *
+ * @param publisher
+ * The publisher of the matrix
+ * @return int
+ * The number of snapshots freed
+ */
+int sparse_matrix_publisher_reclaim(Sparse_Matrix_Publisher *publisher){
+    unsigned long oldest = __atomic_load_n(&publisher->epoch, __ATOMIC_SEQ_CST);
+    int freed = 0;
+
+    for(int i = 0; i < SNAPSHOT_MAX_READERS; i++){
+        unsigned long epoch = __atomic_load_n(&publisher->readers[i].epoch, __ATOMIC_SEQ_CST);
+
+        if(epoch && epoch < oldest){
+            oldest = epoch;
+        }
+    }
+
+    Sparse_Matrix_Snapshot **link = &publisher->retired;
+
+    while(*link){
+        Sparse_Matrix_Snapshot *snapshot = *link;
+
+        if(snapshot->retireEpoch < oldest){
+            *link = snapshot->nextRetired;
+            _snapshot_destroy(snapshot);
+            publisher->numberRetired--;
+            freed++;
+        }
+
+        else{
+            link = &snapshot->nextRetired;
+        }
+    }
+
+    return freed;
+}
+
+/**
+ * @brief This function returns the number of retired snapshots still waiting for their readers.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the structure
+ *
+ * @param publisher
+ * The publisher of the matrix
+ * @return int
+ * The number of retired snapshots
+ */
+int sparse_matrix_publisher_retired(Sparse_Matrix_Publisher *publisher){
+    return publisher->numberRetired;
+}
+
+/**
+ * @brief This function registers a reader in a publisher. Each reader thread needs its own reader.
+ *
+ * @brief Time Complexity: O(t), where t is SNAPSHOT_MAX_READERS
+ *
+ * @param publisher
+ * The publisher of the matrix
+ * @return Sparse_Matrix_Reader*
+ * The new reader
+ */
+Sparse_Matrix_Reader *sparse_matrix_reader_register(Sparse_Matrix_Publisher *publisher){
+    for(int i = 0; i < SNAPSHOT_MAX_READERS; i++){
+        int expected = 0;
+
+        if(__atomic_compare_exchange_n(&publisher->readers[i].used, &expected, 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)){
+            return &publisher->readers[i];
+        }
+    }
+
+    printf("\033[91mError: Too many readers!\n\033[0m");
+    exit(1);
+}
+
+/**
+ * @brief This function gives the slot of a reader back to its publisher. The reader must not be pinned.
+ *
+ * @brief Time Complexity: O(1), because only the slot is released
+ *
+ * @param reader
+ * The reader that will be released
+ */
+void sparse_matrix_reader_unregister(Sparse_Matrix_Reader *reader){
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&reader->used, 0, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief This function pins the current snapshot for a reader, with no lock: the reader announces the epoch it entered and then reads the snapshot published. The snapshot stays valid and unchanged until the reader unpins it, even if the writer publishes new versions meanwhile.
+ *
+ * @brief Time Complexity: O(1), because only two atomic operations are done
+ *
+ * @param reader
+ * The reader of the thread
+ * @return const Sparse_Matrix_Snapshot*
+ * The pinned snapshot
+ */
+const Sparse_Matrix_Snapshot *sparse_matrix_reader_pin(Sparse_Matrix_Reader *reader){
+    Sparse_Matrix_Publisher *publisher = reader->publisher;
+
+    __atomic_store_n(&reader->epoch, __atomic_load_n(&publisher->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&publisher->current, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief This function unpins the snapshot of a reader, letting the writer reclaim it once it's retired.
+ *
+ * @brief Time Complexity: O(1), because only one atomic operation is done
+ *
+ * @param reader
+ * The reader of the thread
+ */
+void sparse_matrix_reader_unpin(Sparse_Matrix_Reader *reader){
+    __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief This function returns the version of a snapshot. Each publication creates the next version.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the snapshot
+ *
+ * @param snapshot
+ * The snapshot
+ * @return unsigned long
+ * The version
+ */
+unsigned long sparse_matrix_snapshot_version(const Sparse_Matrix_Snapshot *snapshot){
+    return snapshot->version;
+}
+
+/**
+ * @brief This function returns the number of rows of a snapshot.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the snapshot
+ *
+ * @param snapshot
+ * The snapshot
+ * @return int
+ * The number of rows
+ */
+int sparse_matrix_snapshot_number_rows(const Sparse_Matrix_Snapshot *snapshot){
+    return snapshot->numberRows;
+}
+
+/**
+ * @brief This function returns the number of columns of a snapshot.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the snapshot
+ *
+ * @param snapshot
+ * The snapshot
+ * @return int
+ * The number of columns
+ */
+int sparse_matrix_snapshot_number_columns(const Sparse_Matrix_Snapshot *snapshot){
+    return snapshot->numberColumns;
+}
+
+/**
+ * @brief This function returns the number of non-null values of a snapshot.
+ *
+ * @brief Time Complexity: O(1), because the value is stored in the snapshot
+ *
+ * @param snapshot
+ * The snapshot
+ * @return int
+ * The number of non-null values
+ */
+int sparse_matrix_snapshot_number_non_null(const Sparse_Matrix_Snapshot *snapshot){
+    return snapshot->numberNonNull;
+}
+
+/**
+ * @brief This function gives the values of a row of a snapshot, sorted by column.
+ *
+ * @brief Time Complexity: O(1), because the row is stored contiguously
+ *
+ * @param snapshot
+ * The snapshot
+ * @param row
+ * The row wanted
+ * @param columns
+ * Receives the columns of the values (NULL if the row is empty)
+ * @param values
+ * Receives the values (NULL if the row is empty)
+ * @return int
+ * The number of values of the row
+ */
+int sparse_matrix_snapshot_row(const Sparse_Matrix_Snapshot *snapshot, int row, const int **columns, const matrix_value_type **values){
+    if(row < 0 || row >= snapshot->numberRows){
+        printf("\033[91mError: Invalid index!\n\033[0m");
+        exit(1);
+    }
+
+    Snapshot_Row *copy = snapshot->rows[row];
+
+    *columns = copy ? copy->columns : NULL;
+    *values = copy ? copy->values : NULL;
+
+    return copy ? copy->length : 0;
+}
+
+/**
+ * @brief This function returns the value of an index in a snapshot. If the index doesn't represent a stored value, 0.0 is returned.
+ *
+ * @brief Time Complexity: O(log(k)), because the sorted row is searched by bisection
+ *
+ * @param snapshot
+ * The snapshot
+ * @param row
+ * The row wanted
+ * @param column
+ * The column wanted
+ * @return matrix_value_type
+ * The value of that index (null or non-null)
+ */
+matrix_value_type sparse_matrix_snapshot_get_by_index(const Sparse_Matrix_Snapshot *snapshot, int row, int column){
+    if(row < 0 || row >= snapshot->numberRows || snapshot->rows[row] == NULL){
+        return 0.0;
+    }
+
+    Snapshot_Row *copy = snapshot->rows[row];
+    int low = 0, high = copy->length - 1;
+
+    while(low <= high){
+        int middle = (low + high) / 2;
+
+        if(copy->columns[middle] == column){
+            return copy->values[middle];
+        }
+
+        else if(copy->columns[middle] < column){
+            low = middle + 1;
+        }
+
+        else{
+            high = middle - 1;
+        }
+    }
+
+    return 0.0;
+}
+
+/**
+ * @brief This function multiplies a snapshot by a vector: result = S * vector.
+ *
+ * @brief Time Complexity: O(n + r), because each row is read contiguously once
+ *
+ * @param snapshot
+ * The snapshot
+ * @param vector
+ * The vector, with one value per column
+ * @param result
+ * Receives the product, with one value per row
+ */
+void sparse_matrix_snapshot_multiply_vector(const Sparse_Matrix_Snapshot *snapshot, const matrix_value_type *vector, matrix_value_type *result){
+    for(int i = 0; i < snapshot->numberRows; i++){
+        Snapshot_Row *copy = snapshot->rows[i];
+        matrix_value_type sum = 0;
+
+        for(int k = 0; copy && k < copy->length; k++){
+            sum += copy->values[k] * vector[copy->columns[k]];
+        }
+
+        result[i] = sum;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "matrix.h"
+
+typedef struct Sparse_Matrix_Publisher Sparse_Matrix_Publisher;
+typedef struct Sparse_Matrix_Snapshot Sparse_Matrix_Snapshot;
+typedef struct Sparse_Matrix_Reader Sparse_Matrix_Reader;
+
+//Maximum number of reader threads registered at the same time in a publisher
+#define SNAPSHOT_MAX_READERS 64
+
+//Writer functions (only one thread may call them)
+
+Sparse_Matrix_Publisher *sparse_matrix_publisher_create(Sparse_Matrix *matrix);
+void sparse_matrix_publisher_destroy(Sparse_Matrix_Publisher *publisher);
+void sparse_matrix_publisher_set(Sparse_Matrix_Publisher *publisher, matrix_value_type data, int row, int column);
+unsigned long sparse_matrix_publisher_publish(Sparse_Matrix_Publisher *publisher);
+int sparse_matrix_publisher_reclaim(Sparse_Matrix_Publisher *publisher);
+int sparse_matrix_publisher_retired(Sparse_Matrix_Publisher *publisher);
+
+//Reader functions (each thread uses its own reader)
+
+Sparse_Matrix_Reader *sparse_matrix_reader_register(Sparse_Matrix_Publisher *publisher);
+void sparse_matrix_reader_unregister(Sparse_Matrix_Reader *reader);
+const Sparse_Matrix_Snapshot *sparse_matrix_reader_pin(Sparse_Matrix_Reader *reader);
+void sparse_matrix_reader_unpin(Sparse_Matrix_Reader *reader);
+
+//Snapshot functions (valid while the snapshot is pinned)
+
+unsigned long sparse_matrix_snapshot_version(const Sparse_Matrix_Snapshot *snapshot);
+int sparse_matrix_snapshot_number_rows(const Sparse_Matrix_Snapshot *snapshot);
+int sparse_matrix_snapshot_number_columns(const Sparse_Matrix_Snapshot *snapshot);
+int sparse_matrix_snapshot_number_non_null(const Sparse_Matrix_Snapshot *snapshot);
+int sparse_matrix_snapshot_row(const Sparse_Matrix_Snapshot *snapshot, int row, const int **columns, const matrix_value_type **values);
+matrix_value_type sparse_matrix_snapshot_get_by_index(const Sparse_Matrix_Snapshot *snapshot, int row, int column);
+void sparse_matrix_snapshot_multiply_vector(const Sparse_Matrix_Snapshot *snapshot, const matrix_value_type *vector, matrix_value_type *result);
+
+#endif
@@ -0,0 +1,476 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "csr.h"
+#include "solver.h"
+
+typedef struct Sparse_Solver_Workspace{
+    Sparse_Matrix *matrix;
+    unsigned long version;
+    int size, maxIterations;
+    Csr_Matrix *csr;
+    int zeroDiagonal;
+    matrix_value_type *diagonalInverse;
+    matrix_value_type *r, *rHat, *p, *v, *s, *t, *y, *z;
+    double *residualHistory;
+} Sparse_Solver_Workspace;
+
+/**
+ * @brief This function converts the matrix to the compressed form and inverts its diagonal, again only if the matrix changed since the last time.
+ *
+ * @brief Time Complexity: O(1) if the matrix didn't change and O(n) if it did
+ *
+ * @param workspace
+ * The workspace of the matrix
+ */
+static void _sparse_solver_refresh(Sparse_Solver_Workspace *workspace){
+    if(workspace->csr && workspace->version == sparse_matrix_version(workspace->matrix)){
+        return;
+    }
+
+    if(workspace->csr){
+        csr_matrix_destroy(workspace->csr);
+    }
+
+    workspace->csr = csr_matrix_from_sparse(workspace->matrix);
+    workspace->version = sparse_matrix_version(workspace->matrix);
+    workspace->zeroDiagonal = 0;
+
+    const int *rowPointers = csr_matrix_row_pointers(workspace->csr);
+    const int *columnIndexes = csr_matrix_column_indexes(workspace->csr);
+    const matrix_value_type *values = csr_matrix_values(workspace->csr);
+
+    //A null diagonal value leaves its row out of the preconditioner (factor 1)
+    for(int i = 0; i < workspace->size; i++){
+        workspace->diagonalInverse[i] = 1;
+        workspace->zeroDiagonal++;
+
+        for(int k = rowPointers[i]; k < rowPointers[i + 1]; k++){
+            if(columnIndexes[k] == i && values[k] != 0){
+                workspace->diagonalInverse[i] = 1 / values[k];
+                workspace->zeroDiagonal--;
+            }
+        }
+    }
+}
+
+/**
+ * @brief This function allocates the workspace of the solvers for a square matrix: the compressed form of the matrix, its inverted diagonal, the vectors used by the iterations and the residual history. The solvers don't allocate anything after this; the workspace follows the changes of the matrix by rebuilding the compressed form the next time it's used.
+ *
+ * @brief Time Complexity: O(n + r), because the matrix is compressed and the vectors are allocated once
+ *
+ * @param matrix
+ * The matrix of the systems (it isn't copied, so it must live longer than the workspace)
+ * @param maxIterations
+ * The maximum number of iterations of each solve
+ * @return Sparse_Solver_Workspace*
+ * The new workspace
+ */
+Sparse_Solver_Workspace *sparse_solver_workspace_create(Sparse_Matrix *matrix, int maxIterations){
+    if(sparse_matrix_number_rows(matrix) != sparse_matrix_number_columns(matrix)){
+        printf("\033[91mError: The matrix must be square!\n\033[0m");
+        exit(1);
+    }
+
+    if(maxIterations < 0){
+        printf("\033[91mError: Invalid number of iterations!\n\033[0m");
+        exit(1);
+    }
+
+    Sparse_Solver_Workspace *workspace = (Sparse_Solver_Workspace *)calloc(1, sizeof(Sparse_Solver_Workspace));
+    int size = sparse_matrix_number_rows(matrix);
+
+    workspace->matrix = matrix;
+    workspace->size = size;
+    workspace->maxIterations = maxIterations;
+    workspace->diagonalInverse = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->r = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->rHat = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->p = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->v = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->s = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->t = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->y = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->z = (matrix_value_type *)malloc((size + 1) * sizeof(matrix_value_type));
+    workspace->residualHistory = (double *)malloc((maxIterations + 1) * sizeof(double));
+
+    _sparse_solver_refresh(workspace);
+
+    return workspace;
+}
+
+/**
+ * @brief This function frees the memory allocated for a workspace. The matrix isn't destroyed.
+ *
+ * @brief Time Complexity: O(1), because each block is freed in a unique way
+ *
+ * @param workspace
+ * The workspace that will be deallocated
+ */
+void sparse_solver_workspace_destroy(Sparse_Solver_Workspace *workspace){
+    csr_matrix_destroy(workspace->csr);
+    free(workspace->diagonalInverse);
+    free(workspace->r);
+    free(workspace->rHat);
+    free(workspace->p);
+    free(workspace->v);
+    free(workspace->s);
+    free(workspace->t);
+    free(workspace->y);
+    free(workspace->z);
+    free(workspace->residualHistory);
+    free(workspace);
+}
+
+/**
+ * @brief This function computes the dot product of two vectors, accumulating in double precision.
+ *
+ * @brief Time Complexity: O(r), because each position is visited once
+ */
+static double _sparse_solver_dot(int size, const matrix_value_type *first, const matrix_value_type *second){
+    double sum = 0;
+
+    for(int i = 0; i < size; i++){
+        sum += (double)first[i] * second[i];
+    }
+
+    return sum;
+}
+
+/**
+ * @brief This function computes r = b - A*x.
+ *
+ * @brief Time Complexity: O(n + r), because the product is computed once
+ */
+static void _sparse_solver_residual(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, const matrix_value_type *x, matrix_value_type *r){
+    csr_matrix_multiply_vector(workspace->csr, x, r);
+
+    for(int i = 0; i < workspace->size; i++){
+        r[i] = b[i] - r[i];
+    }
+}
+
+/**
+ * @brief This function applies the preconditioner: output = D^-1 * input when it's turned on, or a copy of input when it isn't.
+ *
+ * @brief Time Complexity: O(r), because each position is visited once
+ */
+static void _sparse_solver_precondition(Sparse_Solver_Workspace *workspace, int preconditioned, const matrix_value_type *input, matrix_value_type *output){
+    for(int i = 0; i < workspace->size; i++){
+        output[i] = preconditioned ? workspace->diagonalInverse[i] * input[i] : input[i];
+    }
+}
+
+/**
+ * @brief This function records the relative residual of an iteration and tells if the solve converged.
+ *
+ * @brief Time Complexity: O(1), because only one value is stored
+ */
+static int _sparse_solver_record(Sparse_Solver_Workspace *workspace, Sparse_Solver_Result *result, double residualNorm, double bNorm, double tolerance){
+    result->residual = bNorm > 0 ? residualNorm / bNorm : residualNorm;
+    workspace->residualHistory[result->iterations] = result->residual;
+    result->converged = result->residual <= tolerance;
+
+    return result->converged;
+}
+
+/**
+ * @brief This function starts a solve: it checks the sizes, follows the changes of the matrix and prepares the result.
+ *
+ * @brief Time Complexity: O(r), because the norm of b is computed
+ */
+static Sparse_Solver_Result _sparse_solver_begin(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, double *bNorm){
+    if(sparse_matrix_number_rows(workspace->matrix) != workspace->size || sparse_matrix_number_columns(workspace->matrix) != workspace->size){
+        printf("\033[91mError: The matrix changed its size after the workspace was created!\n\033[0m");
+        exit(1);
+    }
+
+    _sparse_solver_refresh(workspace);
+
+    Sparse_Solver_Result result = {0, 0, 0, workspace->residualHistory};
+
+    *bNorm = sqrt(_sparse_solver_dot(workspace->size, b, b));
+
+    return result;
+}
+
+/**
+ * @brief This function solves A*x = b with the conjugate gradient method (A must be symmetric positive definite), optionally with the diagonal (Jacobi) preconditioner.
+ *
+ * @brief Time Complexity: O(k * (n + r)), where k is the number of iterations
+ *
+ * @param workspace
+ * The workspace of the matrix A
+ * @param b
+ * The right-hand side
+ * @param x
+ * The initial guess, replaced by the solution
+ * @param tolerance
+ * The relative residual ||b - A*x|| / ||b|| at which the solve stops
+ * @param preconditioned
+ * 1 to use the diagonal preconditioner or 0 to not use it
+ * @return Sparse_Solver_Result
+ * The number of iterations, if it converged, the final relative residual and the residual of each iteration (iterations + 1 values, owned by the workspace)
+ */
+Sparse_Solver_Result sparse_solver_conjugate_gradient(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, matrix_value_type *x, double tolerance, int preconditioned){
+    double bNorm;
+    Sparse_Solver_Result result = _sparse_solver_begin(workspace, b, &bNorm);
+    int size = workspace->size;
+    matrix_value_type *r = workspace->r, *z = workspace->z, *p = workspace->p, *q = workspace->v;
+
+    _sparse_solver_residual(workspace, b, x, r);
+
+    if(_sparse_solver_record(workspace, &result, sqrt(_sparse_solver_dot(size, r, r)), bNorm, tolerance)){
+        return result;
+    }
+
+    _sparse_solver_precondition(workspace, preconditioned, r, z);
+
+    for(int i = 0; i < size; i++){
+        p[i] = z[i];
+    }
+
+    double rz = _sparse_solver_dot(size, r, z);
+
+    while(result.iterations < workspace->maxIterations){
+        csr_matrix_multiply_vector(workspace->csr, p, q);
+
+        double pq = _sparse_solver_dot(size, p, q);
+
+        //The direction has no curvature: the matrix isn't positive definite or the solve already stagnated
+        if(pq == 0){
+            break;
+        }
+
+        double alpha = rz / pq;
+
+        for(int i = 0; i < size; i++){
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+
+        result.iterations++;
+
+        if(_sparse_solver_record(workspace, &result, sqrt(_sparse_solver_dot(size, r, r)), bNorm, tolerance)){
+            break;
+        }
+
+        _sparse_solver_precondition(workspace, preconditioned, r, z);
+
+        double rzNew = _sparse_solver_dot(size, r, z);
+        double beta = rzNew / rz;
+
+        for(int i = 0; i < size; i++){
+            p[i] = z[i] + beta * p[i];
+        }
+
+        rz = rzNew;
+    }
+
+    return result;
+}
+
+/**
+ * @brief This function solves A*x = b with the biconjugate gradient stabilized method (BiCGSTAB), which accepts non-symmetric matrices, optionally with the diagonal (Jacobi) preconditioner applied on the right.
+ *
+ * @brief Time Complexity: O(k * (n + r)), where k is the number of iterations (each one computes two products)
+ *
+ * @param workspace
+ * The workspace of the matrix A
+ * @param b
+ * The right-hand side
+ * @param x
+ * The initial guess, replaced by the solution
+ * @param tolerance
+ * The relative residual ||b - A*x|| / ||b|| at which the solve stops
+ * @param preconditioned
+ * 1 to use the diagonal preconditioner or 0 to not use it
+ * @return Sparse_Solver_Result
+ * The number of iterations, if it converged, the final relative residual and the residual of each iteration (iterations + 1 values, owned by the workspace)
+ */
+Sparse_Solver_Result sparse_solver_bicgstab(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, matrix_value_type *x, double tolerance, int preconditioned){
+    double bNorm;
+    Sparse_Solver_Result result = _sparse_solver_begin(workspace, b, &bNorm);
+    int size = workspace->size;
+    matrix_value_type *r = workspace->r, *rHat = workspace->rHat, *p = workspace->p, *v = workspace->v;
+    matrix_value_type *s = workspace->s, *t = workspace->t, *y = workspace->y, *z = workspace->z;
+
+    _sparse_solver_residual(workspace, b, x, r);
+
+    if(_sparse_solver_record(workspace, &result, sqrt(_sparse_solver_dot(size, r, r)), bNorm, tolerance)){
+        return result;
+    }
+
+    for(int i = 0; i < size; i++){
+        rHat[i] = r[i];
+        p[i] = 0;
+        v[i] = 0;
+    }
+
+    double rho = 1, alpha = 1, omega = 1;
+
+    while(result.iterations < workspace->maxIterations){
+        double rhoNew = _sparse_solver_dot(size, rHat, r);
+
+        //Breakdown: the shadow residual became orthogonal to the residual
+        if(rhoNew == 0 || omega == 0){
+            break;
+        }
+
+        double beta = (rhoNew / rho) * (alpha / omega);
+
+        for(int i = 0; i < size; i++){
+            p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        }
+
+        _sparse_solver_precondition(workspace, preconditioned, p, y);
+        csr_matrix_multiply_vector(workspace->csr, y, v);
+
+        double rHatV = _sparse_solver_dot(size, rHat, v);
+
+        if(rHatV == 0){
+            break;
+        }
+
+        alpha = rhoNew / rHatV;
+
+        for(int i = 0; i < size; i++){
+            s[i] = r[i] - alpha * v[i];
+        }
+
+        result.iterations++;
+
+        //The half step already converged
+        if(_sparse_solver_record(workspace, &result, sqrt(_sparse_solver_dot(size, s, s)), bNorm, tolerance)){
+            for(int i = 0; i < size; i++){
+                x[i] += alpha * y[i];
+            }
+
+            break;
+        }
+
+        _sparse_solver_precondition(workspace, preconditioned, s, z);
+        csr_matrix_multiply_vector(workspace->csr, z, t);
+
+        double tt = _sparse_solver_dot(size, t, t);
+
+        omega = tt > 0 ? _sparse_solver_dot(size, t, s) / tt : 0;
+
+        for(int i = 0; i < size; i++){
+            x[i] += alpha * y[i] + omega * z[i];
+            r[i] = s[i] - omega * t[i];
+        }
+
+        rho = rhoNew;
+
+        if(_sparse_solver_record(workspace, &result, sqrt(_sparse_solver_dot(size, r, r)), bNorm, tolerance)){
+            break;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief This function checks that the diagonal has no null values, which the stationary methods divide by.
+ *
+ * @brief Time Complexity: O(1), because the null values were counted when the diagonal was inverted
+ */
+static void _sparse_solver_check_diagonal(Sparse_Solver_Workspace *workspace){
+    if(workspace->zeroDiagonal){
+        printf("\033[91mError: The diagonal of the matrix has null values!\n\033[0m");
+        exit(1);
+    }
+}
+
+/**
+ * @brief This function solves A*x = b with the Jacobi method: x = x + D^-1 * (b - A*x). It converges for strictly diagonally dominant matrices.
+ *
+ * @brief Time Complexity: O(k * (n + r)), where k is the number of iterations
+ *
+ * @param workspace
+ * The workspace of the matrix A
+ * @param b
+ * The right-hand side
+ * @param x
+ * The initial guess, replaced by the solution
+ * @param tolerance
+ * The relative residual ||b - A*x|| / ||b|| at which the solve stops
+ * @return Sparse_Solver_Result
+ * The number of iterations, if it converged, the final relative residual and the residual of each iteration (iterations + 1 values, owned by the workspace)
+ */
+Sparse_Solver_Result sparse_solver_jacobi(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, matrix_value_type *x, double tolerance){
+    double bNorm;
+    Sparse_Solver_Result result = _sparse_solver_begin(workspace, b, &bNorm);
+    matrix_value_type *r = workspace->r;
+
+    _sparse_solver_check_diagonal(workspace);
+
+    while(1){
+        _sparse_solver_residual(workspace, b, x, r);
+
+        if(_sparse_solver_record(workspace, &result, sqrt(_sparse_solver_dot(workspace->size, r, r)), bNorm, tolerance) || result.iterations == workspace->maxIterations){
+            break;
+        }
+
+        for(int i = 0; i < workspace->size; i++){
+            x[i] += workspace->diagonalInverse[i] * r[i];
+        }
+
+        result.iterations++;
+    }
+
+    return result;
+}
+
+/**
+ * @brief This function solves A*x = b with the Gauss-Seidel method: each sweep updates x in place, row by row, using the values already updated in the same sweep. It converges for strictly diagonally dominant or symmetric positive definite matrices.
+ *
+ * @brief Time Complexity: O(k * (n + r)), where k is the number of iterations (each one computes a sweep and a residual)
+ *
+ * @param workspace
+ * The workspace of the matrix A
+ * @param b
+ * The right-hand side
+ * @param x
+ * The initial guess, replaced by the solution
+ * @param tolerance
+ * The relative residual ||b - A*x|| / ||b|| at which the solve stops
+ * @return Sparse_Solver_Result
+ * The number of iterations, if it converged, the final relative residual and the residual of each iteration (iterations + 1 values, owned by the workspace)
+ */
+Sparse_Solver_Result sparse_solver_gauss_seidel(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, matrix_value_type *x, double tolerance){
+    double bNorm;
+    Sparse_Solver_Result result = _sparse_solver_begin(workspace, b, &bNorm);
+    matrix_value_type *r = workspace->r;
+
+    _sparse_solver_check_diagonal(workspace);
+
+    const int *rowPointers = csr_matrix_row_pointers(workspace->csr);
+    const int *columnIndexes = csr_matrix_column_indexes(workspace->csr);
+    const matrix_value_type *values = csr_matrix_values(workspace->csr);
+
+    while(1){
+        _sparse_solver_residual(workspace, b, x, r);
+
+        if(_sparse_solver_record(workspace, &result, sqrt(_sparse_solver_dot(workspace->size, r, r)), bNorm, tolerance) || result.iterations == workspace->maxIterations){
+            break;
+        }
+
+        for(int i = 0; i < workspace->size; i++){
+            matrix_value_type sum = b[i];
+
+            for(int k = rowPointers[i]; k < rowPointers[i + 1]; k++){
+                if(columnIndexes[k] != i){
+                    sum -= values[k] * x[columnIndexes[k]];
+                }
+            }
+
+            x[i] = sum * workspace->diagonalInverse[i];
+        }
+
+        result.iterations++;
+    }
+
+    return result;
+}
@@ -0,0 +1,27 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "matrix.h"
+
+typedef struct Sparse_Solver_Workspace Sparse_Solver_Workspace;
+
+typedef struct Sparse_Solver_Result{
+    int iterations;
+    int converged;
+    double residual;
+    const double *residualHistory;
+} Sparse_Solver_Result;
+
+//Allocation functions
+
+Sparse_Solver_Workspace *sparse_solver_workspace_create(Sparse_Matrix *matrix, int maxIterations);
+void sparse_solver_workspace_destroy(Sparse_Solver_Workspace *workspace);
+
+//Solver functions
+
+Sparse_Solver_Result sparse_solver_conjugate_gradient(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, matrix_value_type *x, double tolerance, int preconditioned);
+Sparse_Solver_Result sparse_solver_bicgstab(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, matrix_value_type *x, double tolerance, int preconditioned);
+Sparse_Solver_Result sparse_solver_jacobi(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, matrix_value_type *x, double tolerance);
+Sparse_Solver_Result sparse_solver_gauss_seidel(Sparse_Solver_Workspace *workspace, const matrix_value_type *b, matrix_value_type *x, double tolerance);
+
+#endif
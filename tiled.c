@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "cell.h"
+#include "tiled.h"
+#include "semiring.h"
+#include "instrument.h"
+
+//A value as written by sparse_matrix_binary_save: row, column and value, 12 bytes with no padding
+typedef struct Tiled_Entry{
+    int row, column;
+    matrix_value_type value;
+} Tiled_Entry;
+
+//The buffer of a tile, filled by the rows of the product in order
+typedef struct Tiled_Buffer{
+    Tiled_Entry *entries;
+    size_t size;
+} Tiled_Buffer;
+
+/**
+ * @brief This function is the sink of the semiring kernel that appends the values of the product to the buffer of the tile.
+ *
+ * @brief Time Complexity: O(1)
+ */
+static void _tiled_buffer_sink(void *buffer, int row, int column, matrix_value_type value){
+    Tiled_Buffer *tile = (Tiled_Buffer *)buffer;
+
+    if(value != 0){
+        tile->entries[tile->size].row = row;
+        tile->entries[tile->size].column = column;
+        tile->entries[tile->size].value = value;
+        tile->size++;
+    }
+}
+
+/**
+ * @brief This function bounds the number of values of a row of the product: the number of multiplications that reach it, and never more than the number of columns.
+ *
+ * @brief Time Complexity: O(a), where a is the length of the row of matrix1
+ */
+static long long _tiled_row_bound(Sparse_Matrix *matrix1, int *lengths, int row, int numberColumns){
+    long long bound = 0;
+
+    for(Cell *first = _sparse_matrix_row_head(matrix1, row); first && bound < numberColumns; first = first->nextRow){
+        bound += lengths[first->positionColumn];
+    }
+
+    return bound < numberColumns ? bound : numberColumns;
+}
+
+/**
+ * @brief This function multiplies two matrices straight to a file in the plain binary format, for products larger than the memory. The rows of the product are split into tiles whose values surely fit in the memory budget (bounded by the multiplications of each row), each tile is computed by the plus-times kernel of semiring.c (Gustavson's algorithm) into a buffer and the buffer is written before the next tile starts, so the memory used doesn't depend on the size of the product. The file is read back by sparse_matrix_binary_read and sparse_matrix_binary_read_parallel; like sparse_matrix_binary_save, it doesn't keep the rows and columns past the last non-null value. Nothing is printed.
+ *
+ * @brief Time Complexity: O(f + r*log(c) + c), where f is the number of multiplications of non-null values, r is the number of rows of matrix1 and c is the number of columns of matrix2
+ *
+ * @param matrix1
+ * The first matrix to multiply
+ * @param matrix2
+ * The second matrix to multiply
+ * @param path
+ * The path of the file that will be created
+ * @param memoryBudget
+ * The bytes that the scratch (a row accumulator) and the buffer of a tile may use together
+ * @return long
+ * The number of non-null values written
+ */
+long sparse_matrix_multiplication_to_file(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, const char *path, size_t memoryBudget){
+    INSTRUMENT_BEGIN();
+
+    if(sparse_matrix_number_columns(matrix1) != sparse_matrix_number_rows(matrix2)){
+        printf("\033[91mError: the number of columns and rows is not equal in both matrices!\n\033[0m");
+        exit(1);
+    }
+
+    int numberRows = sparse_matrix_number_rows(matrix1);
+    int numberColumns = sparse_matrix_number_columns(matrix2);
+    int inner = sparse_matrix_number_rows(matrix2);
+    size_t scratchBytes = (size_t)numberColumns * (sizeof(matrix_value_type) + 2 * sizeof(int)) + (size_t)inner * sizeof(int);
+
+    //At least a whole row of the product must fit in a tile
+    if(memoryBudget < scratchBytes + (size_t)numberColumns * sizeof(Tiled_Entry) + TILED_MIN_TILE_BYTES){
+        printf("\033[91mError: the memory budget is too small!\n\033[0m");
+        exit(1);
+    }
+
+    FILE *fp = fopen(path, "wb");
+
+    if(!fp){
+        printf("\033[91mError: Couldn't create the file!\n\033[0m");
+        exit(1);
+    }
+
+    size_t capacity = (memoryBudget - scratchBytes) / sizeof(Tiled_Entry);
+    Tiled_Buffer tile = {(Tiled_Entry *)malloc(capacity * sizeof(Tiled_Entry)), 0};
+    Semiring_Workspace workspace;
+    int *lengths = (int *)calloc(inner, sizeof(int));
+    long total = 0;
+    int numberNonNull = 0;
+
+    //The number of values is only known at the end
+    size_t bytes = fwrite(&numberNonNull, 1, sizeof(int), fp);
+
+    _semiring_workspace_create(&workspace, numberColumns, 0);
+
+    for(int k = 0; k < inner; k++){
+        for(Cell *second = _sparse_matrix_row_head(matrix2, k); second; second = second->nextRow){
+            lengths[k]++;
+        }
+    }
+
+    int first = 0;
+
+    while(first < numberRows){
+        //The tile takes rows while their bounds fit in the buffer
+        size_t reserved = 0;
+        int last = first;
+
+        while(last < numberRows){
+            long long bound = _tiled_row_bound(matrix1, lengths, last, numberColumns);
+
+            if(reserved + bound > capacity){
+                break;
+            }
+
+            reserved += bound;
+            last++;
+        }
+
+        tile.size = 0;
+        _semiring_multiply_rows(matrix1, matrix2, SEMIRING_PLUS_TIMES, first, last, &workspace, _tiled_buffer_sink, &tile);
+
+        if(fwrite(tile.entries, sizeof(Tiled_Entry), tile.size, fp) != tile.size){
+            printf("\033[91mError: Couldn't write the file!\n\033[0m");
+            exit(1);
+        }
+
+        bytes += tile.size * sizeof(Tiled_Entry);
+        total += tile.size;
+        first = last;
+    }
+
+    if(total > INT_MAX){
+        printf("\033[91mError: the product has too many values for the binary format!\n\033[0m");
+        exit(1);
+    }
+
+    numberNonNull = total;
+    fseek(fp, 0, SEEK_SET);
+    fwrite(&numberNonNull, 1, sizeof(int), fp);
+
+    if(fclose(fp) != 0){
+        printf("\033[91mError: Couldn't write the file!\n\033[0m");
+        exit(1);
+    }
+
+    free(tile.entries);
+    free(lengths);
+    _semiring_workspace_destroy(&workspace);
+
+    INSTRUMENT_COUNT(INSTRUMENT_BYTES_WRITTEN, bytes);
+
+    INSTRUMENT_END(INSTRUMENT_OP_MULTIPLICATION_TO_FILE);
+    return total;
+}
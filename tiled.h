@@ -0,0 +1,13 @@
+#ifndef TILED_H
+#define TILED_H
+
+#include "matrix.h"
+
+//Bytes a tile must hold at least on top of one whole row of the product (the budget is checked against it)
+#define TILED_MIN_TILE_BYTES 4096
+
+//Operation functions with matrices
+
+long sparse_matrix_multiplication_to_file(Sparse_Matrix *matrix1, Sparse_Matrix *matrix2, const char *path, size_t memoryBudget);
+
+#endif